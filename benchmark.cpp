@@ -0,0 +1,405 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+// Benchmarks de los kernels de tensores y de la red neuronal.
+//
+//   neural_net_bench [--format csv|json] [--out archivo] [--filter texto]
+//                    [--min-time segundos] [--quick]
+//
+// Cada caso se repite hasta acumular --min-time (mínimo 3 repeticiones) y se
+// reporta la mediana por iteración. GFLOP/s y GB/s salen de la mediana y de
+// los FLOP/bytes nominales del caso: 2·M·N·K en el GEMM, una operación por
+// elemento en los kernels elemento a elemento, y los bytes mínimos que el
+// kernel lee y escribe (0 = no aplica).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "tensor (8).h"
+#include "nn_dense (5).h"
+#include "nn_activation (3).h"
+#include "nn_loss (5).h"
+#include "tensor_reduce.h"
+#include "nn_optimizer (5).h"
+#include "neural_network (4).h"
+#include "nn_static.h"
+
+namespace {
+
+    using namespace utec::neural_network;
+    using clock_type = std::chrono::steady_clock;
+
+    struct Options {
+        std::string format = "csv";
+        std::string out;
+        std::string filter;
+        double      min_time = 0.25;
+        bool        quick = false;
+    };
+
+    struct Result {
+        std::string name, shape;
+        std::size_t iterations = 0;
+        double      median_ms = 0, min_ms = 0, gflops = 0, gbps = 0;
+    };
+
+    // Evita que el compilador descarte resultados no usados
+    volatile float sink;
+    void keep(const float* p) { sink = *p; }
+
+    class Runner {
+    public:
+        explicit Runner(Options opt) : opt_(std::move(opt)) {}
+
+        // fn() ejecuta una iteración; flops/bytes son por iteración
+        void run(const std::string& name, const std::string& shape, double flops, double bytes,
+                 const std::function<void()>& fn) {
+            if (!opt_.filter.empty() && (name + " " + shape).find(opt_.filter) == std::string::npos) return;
+            fn();   // calentamiento (dimensiona buffers y llena cachés)
+            std::vector<double> samples;
+            double total = 0;
+            while (samples.size() < 3 || total < opt_.min_time) {
+                auto t0 = clock_type::now();
+                fn();
+                double s = std::chrono::duration<double>(clock_type::now() - t0).count();
+                samples.push_back(s);
+                total += s;
+            }
+            std::sort(samples.begin(), samples.end());
+            Result r;
+            r.name = name;
+            r.shape = shape;
+            r.iterations = samples.size();
+            const double med = samples[samples.size() / 2];
+            r.median_ms = med * 1e3;
+            r.min_ms = samples.front() * 1e3;
+            r.gflops = flops > 0 ? flops / med * 1e-9 : 0;
+            r.gbps = bytes > 0 ? bytes / med * 1e-9 : 0;
+            std::cerr << name << " " << shape << ": " << r.median_ms << " ms\n";
+            results_.push_back(r);
+        }
+
+        bool quick() const noexcept { return opt_.quick; }
+
+        void write(std::ostream& os) const {
+            if (opt_.format == "json") {
+                os << "{\n  \"isa\": \"" << isa() << "\",\n  \"threads\": " << utec::algebra::num_threads()
+                   << ",\n  \"results\": [\n";
+                for (std::size_t i = 0; i < results_.size(); ++i) {
+                    const auto& r = results_[i];
+                    os << "    {\"benchmark\": \"" << r.name << "\", \"shape\": \"" << r.shape
+                       << "\", \"iterations\": " << r.iterations << ", \"median_ms\": " << r.median_ms
+                       << ", \"min_ms\": " << r.min_ms << ", \"gflops\": " << r.gflops
+                       << ", \"gbps\": " << r.gbps << "}" << (i + 1 < results_.size() ? ",\n" : "\n");
+                }
+                os << "  ]\n}\n";
+            } else {
+                os << "benchmark,shape,iterations,median_ms,min_ms,gflops,gbps\n";
+                for (const auto& r : results_)
+                    os << r.name << ',' << r.shape << ',' << r.iterations << ',' << r.median_ms << ','
+                       << r.min_ms << ',' << r.gflops << ',' << r.gbps << '\n';
+            }
+        }
+
+        static const char* isa() {
+#if defined(__AVX512F__)
+            return "avx512";
+#elif defined(__AVX2__)
+            return "avx2";
+#elif defined(__SSE2__)
+            return "sse2";
+#else
+            return "scalar";
+#endif
+        }
+
+    private:
+        Options             opt_;
+        std::vector<Result> results_;
+    };
+
+    template <std::size_t R>
+    Tensor<float,R> random_tensor(const std::array<std::size_t,R>& shape, float lo = -1.f, float hi = 1.f,
+                                  unsigned seed = 7) {
+        Tensor<float,R> t(shape);
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(lo, hi);
+        for (auto& v : t) v = dist(rng);
+        return t;
+    }
+
+    std::string dims(std::initializer_list<std::size_t> d) {
+        std::ostringstream s;
+        bool first = true;
+        for (auto v : d) { s << (first ? "" : "x") << v; first = false; }
+        return s.str();
+    }
+
+    constexpr double F = sizeof(float);
+
+    void bench_gemm(Runner& run) {
+        std::vector<std::array<std::size_t,3>> shapes = {
+            {64, 64, 64}, {256, 256, 256}, {512, 512, 512}, {64, 784, 256}, {256, 1024, 1024}};
+        if (!run.quick()) shapes.push_back({1024, 1024, 1024});
+        for (auto [m, k, n] : shapes) {
+            auto a = random_tensor<2>({m, k});
+            auto b = random_tensor<2>({k, n});
+            Tensor<float,2> c;
+            run.run("matrix_product_2d", dims({m, k, n}), 2.0 * m * n * k, F * (m*k + k*n + m*n), [&] {
+                matrix_product_into(a, b, c);
+                keep(c.data());
+            });
+        }
+        std::vector<std::array<std::size_t,4>> batched = {{16, 64, 64, 64}, {8, 128, 128, 128}, {4, 256, 256, 256}};
+        for (auto [bt, m, k, n] : batched) {
+            auto a = random_tensor<3>({bt, m, k});
+            auto b = random_tensor<3>({bt, k, n});
+            run.run("matrix_product_3d", dims({bt, m, k, n}), 2.0 * bt * m * n * k,
+                    F * bt * (m*k + k*n + m*n), [&] {
+                auto c = matrix_product(a, b);
+                keep(c.data());
+            });
+        }
+    }
+
+    void bench_elementwise(Runner& run) {
+        const std::size_t rows = 1024, cols = run.quick() ? 512 : 1024, n = rows * cols;
+        auto a = random_tensor<2>({rows, cols});
+        auto b = random_tensor<2>({rows, cols}, -1.f, 1.f, 11);
+        auto row = random_tensor<2>({1, cols}, -1.f, 1.f, 13);
+        const auto add = [](float x, float y) { return x + y; };
+        run.run("elementwise_op", dims({rows, cols}), double(n), F * 3 * n, [&] {
+            auto c = a.elementwise_op(b, add);
+            keep(c.data());
+        });
+        run.run("elementwise_op_broadcast", dims({rows, cols}) + "+" + dims({1, cols}), double(n),
+                F * (2 * n + cols), [&] {
+            auto c = a.elementwise_op(row, add);
+            keep(c.data());
+        });
+        run.run("expr_add_mul", dims({rows, cols}), 2.0 * n, F * 3 * n, [&] {
+            Tensor<float,2> c = a + b * 2.0f;
+            keep(c.data());
+        });
+        run.run("transpose_2d", dims({rows, cols}), 0, F * 2 * n, [&] {
+            auto t = a.transpose_2d();
+            keep(t.data());
+        });
+    }
+
+    template <typename Layer>
+    void bench_activation(Runner& run, const std::string& name, Layer layer, const Tensor<float,2>& x,
+                          const Tensor<float,2>& g) {
+        const double n = double(x.size());
+        Tensor<float,2> y, dx;
+        run.run(name + "_forward", dims({x.shape()[0], x.shape()[1]}), n, F * 2 * n, [&] {
+            layer.forward_into(x, y);
+            keep(y.data());
+        });
+        run.run(name + "_backward", dims({x.shape()[0], x.shape()[1]}), n, F * 3 * n, [&] {
+            layer.backward_into(g, dx);
+            keep(dx.data());
+        });
+    }
+
+    void bench_activations(Runner& run) {
+        const std::size_t rows = 256, cols = run.quick() ? 1024 : 4096;
+        auto x = random_tensor<2>({rows, cols}, -4.f, 4.f);
+        auto g = random_tensor<2>({rows, cols}, -1.f, 1.f, 17);
+        bench_activation(run, "relu", ReLU<float>(), x, g);
+        bench_activation(run, "sigmoid", Sigmoid<float>(), x, g);
+        bench_activation(run, "tanh", Tanh<float>(), x, g);
+        bench_activation(run, "leaky_relu", LeakyReLU<float>(0.01f), x, g);
+        bench_activation(run, "gelu", GELU<float>(), x, g);
+    }
+
+    void bench_losses(Runner& run) {
+        const std::size_t rows = 1024, cols = run.quick() ? 256 : 1024;
+        const double n = double(rows * cols);
+        auto logits = random_tensor<2>({rows, cols}, -4.f, 4.f);
+        auto probs = random_tensor<2>({rows, cols}, 0.01f, 0.99f);
+        auto target = random_tensor<2>({rows, cols}, 0.f, 1.f, 19);
+        Tensor<float,2> grad;
+        const std::string shape = dims({rows, cols});
+        run.run("mse_loss", shape, 3 * n, F * 3 * n, [&] {
+            volatile float l = MSELoss<float>(logits, target).loss_and_gradient_into(grad);
+            (void)l;
+        });
+        run.run("bce_loss", shape, 3 * n, F * 3 * n, [&] {
+            volatile float l = BCELoss<float>(probs, target).loss_and_gradient_into(grad);
+            (void)l;
+        });
+        run.run("bce_with_logits_loss", shape, 3 * n, F * 3 * n, [&] {
+            volatile float l = BCEWithLogitsLoss<float>(logits, target).loss_and_gradient_into(grad);
+            (void)l;
+        });
+        run.run("softmax_ce_loss", shape, 4 * n, F * 3 * n, [&] {
+            volatile float l = SoftmaxCrossEntropyLoss<float>(logits, target).loss_and_gradient_into(grad);
+            (void)l;
+        });
+        Tensor<float,2> red;
+        std::vector<std::size_t> idx;
+        run.run("sum_axis0", shape, n, F * n, [&] { utec::algebra::sum_axis_into<float>(logits.view(), 0, red); });
+        run.run("sum_axis1", shape, n, F * n, [&] { utec::algebra::sum_axis_into<float>(logits.view(), 1, red); });
+        run.run("sum_axis0_transposed", shape, n, F * n, [&] {
+            utec::algebra::sum_axis_into<float>(logits.view().transpose_2d(), 0, red);
+        });
+        run.run("argmax_axis0", shape, n, F * n, [&] { utec::algebra::argmax_axis_into<float>(logits.view(), 0, idx); });
+        run.run("argmax_axis1", shape, n, F * n, [&] { utec::algebra::argmax_axis_into<float>(logits.view(), 1, idx); });
+    }
+
+    void bench_optimizers(Runner& run) {
+        const std::size_t n = run.quick() ? (1u << 18) : (1u << 22);
+        auto params = random_tensor<2>({1, n});
+        auto grads = random_tensor<2>({1, n}, -1e-3f, 1e-3f, 23);
+        const std::string shape = std::to_string(n);
+        SGD<float> sgd(0.01f);
+        run.run("sgd_step", shape, 2.0 * n, F * 3 * n, [&] {
+            sgd.step(params.data(), grads.data(), n);
+        });
+        Adam<float> adam(0.001f);
+        // lee p, g, m, v y escribe p, m, v
+        run.run("adam_step", shape, 12.0 * n, F * 7 * n, [&] {
+            adam.step(params.data(), grads.data(), n);
+        });
+    }
+
+    void bench_train(Runner& run) {
+        const std::size_t rows = run.quick() ? 1024 : 4096, in = 784, hidden = 256, out = 10, batch = 64;
+        auto X = random_tensor<2>({rows, in}, 0.f, 1.f);
+        Tensor<float,2> Y(rows, out);
+        Y.fill(0.f);
+        for (std::size_t i = 0; i < rows; ++i) Y(i, i % out) = 1.f;
+        auto init_w = [](Tensor<float,2>& w) {
+            std::mt19937 rng(29);
+            std::normal_distribution<float> d(0.f, 0.05f);
+            for (auto& v : w) v = d(rng);
+        };
+        auto init_b = [](Tensor<float,2>& b) { b.fill(0.f); };
+        const double params = double(in * hidden + hidden * hidden + hidden * out);
+        // forward 2·filas·params, backward ~4·filas·params (dW y dX)
+        const double flops = 6.0 * rows * params;
+        const std::string shape = dims({rows, in, hidden, hidden, out}) + "/b" + std::to_string(batch);
+        for (bool fused : {false, true}) {
+            NeuralNetwork<float> net;
+            net.add_layer(std::make_unique<Dense<float>>(in, hidden, init_w, init_b));
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float>>(hidden, hidden, init_w, init_b));
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float>>(hidden, out, init_w, init_b));
+            net.add_layer(std::make_unique<Sigmoid<float>>());
+            if (fused) net.fuse_layers();
+            const std::string name = fused ? "train_epoch_fused" : "train_epoch";
+            run.run(name + "_sgd", shape, flops, 0, [&] {
+                net.train<BCELoss, SGD>(X, Y, 1, batch, 0.05f);
+            });
+            run.run(name + "_adam", shape, flops, 0, [&] {
+                net.train<BCELoss, Adam>(X, Y, 1, batch, 0.001f);
+            });
+            // Checkpointing cada 2 capas: un forward extra por paso
+            net.set_checkpointing(2);
+            run.run(name + "_checkpoint_sgd", shape, flops, 0, [&] {
+                net.train<BCELoss, SGD>(X, Y, 1, batch, 0.05f);
+            });
+            net.set_checkpointing(0);
+            // Plan compilado: pasos planos y buffers compartidos
+            net.compile(in, batch);
+            run.run(name + "_compiled_sgd", shape, flops, 0, [&] {
+                net.train<BCELoss, SGD>(X, Y, 1, batch, 0.05f);
+            });
+        }
+    }
+
+    // Micro-modelo 1→10→1 muestra a muestra: red dinámica frente a StaticNetwork
+    void bench_tiny(Runner& run) {
+        const std::size_t calls = 10000;
+        auto init_w = [](Tensor<float,2>& w) {
+            std::mt19937 rng(123);
+            std::uniform_real_distribution<float> d(-0.1f, 0.1f);
+            for (auto& v : w) v = d(rng);
+        };
+        auto init_b = [](Tensor<float,2>& b) { b.fill(0.f); };
+        const double flops = calls * (2.0 * 10 + 2.0 * 10);
+        const std::string shape = "1x10x1/" + std::to_string(calls) + "calls";
+        volatile float sink = 0;
+
+        NeuralNetwork<float> net;
+        net.add_layer(std::make_unique<Dense<float>>(1, 10, init_w, init_b));
+        net.add_layer(std::make_unique<ReLU<float>>());
+        net.add_layer(std::make_unique<Dense<float>>(10, 1, init_w, init_b));
+        net.fuse_layers();
+        Tensor<float,2> x(1, 1), out, scratch;
+        run.run("tiny_predict_dynamic", shape, flops, 0, [&] {
+            for (std::size_t i = 0; i < calls; ++i) {
+                x(0, 0) = float(i) * 1e-4f;
+                net.infer_into(x, out, scratch);
+                sink = sink + out(0, 0);
+            }
+        });
+
+        StaticNetwork<float, StaticDense<float, 1, 10, ReLUOp<float>>, StaticDense<float, 10, 1>> sn(init_w, init_b);
+        run.run("tiny_predict_static", shape, flops, 0, [&] {
+            for (std::size_t i = 0; i < calls; ++i) {
+                sink = sink + sn.predict(std::array<float, 1>{float(i) * 1e-4f})[0];
+            }
+        });
+    }
+
+    Options parse(int argc, char** argv) {
+        Options opt;
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--format") opt.format = value();
+            else if (a == "--out") opt.out = value();
+            else if (a == "--filter") opt.filter = value();
+            else if (a == "--min-time") opt.min_time = std::atof(value().c_str());
+            else if (a == "--quick") opt.quick = true;
+            else throw std::invalid_argument("Unknown option " + a);
+        }
+        if (opt.format != "csv" && opt.format != "json")
+            throw std::invalid_argument("Format must be csv or json");
+        return opt;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nusage: neural_net_bench [--format csv|json] [--out file] "
+                                 "[--filter text] [--min-time seconds] [--quick]\n";
+        return 2;
+    }
+    Runner run(opt);
+    bench_gemm(run);
+    bench_elementwise(run);
+    bench_activations(run);
+    bench_losses(run);
+    bench_optimizers(run);
+    bench_train(run);
+    bench_tiny(run);
+    if (opt.out.empty()) {
+        run.write(std::cout);
+    } else {
+        std::ofstream out(opt.out);
+        if (!out) {
+            std::cerr << "Cannot write " << opt.out << "\n";
+            return 1;
+        }
+        run.write(out);
+    }
+    return 0;
+}
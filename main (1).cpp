@@ -43,6 +43,8 @@ int main() {
     net.add_layer(std::make_unique<utec::neural_network::Dense<float>>(1, 10, init_weights, init_bias));
     net.add_layer(std::make_unique<utec::neural_network::ReLU<float>>());
     net.add_layer(std::make_unique<utec::neural_network::Dense<float>>(10, 1, init_weights, init_bias));
+    // Dense + ReLU -> una sola capa con bias y activación en el epílogo del GEMM
+    net.fuse_layers();
 
     // Parámetros de entrenamiento
     const size_t epochs = 100;
@@ -50,17 +52,14 @@ int main() {
     const float learning_rate = 0.01f;
 
     // Mostrar pérdida antes de entrenar
-    auto pred_before = net.predict(X);
-    utec::neural_network::MSELoss<float> loss_before(pred_before, Y);
-    std::cout << "Loss antes de entrenar: " << loss_before.loss() << "\n";
+    std::cout << "Loss antes de entrenar: " << net.evaluate<utec::neural_network::MSELoss>(X, Y) << "\n";
 
     // Entrenamiento con impresión de pérdida cada 10 épocas
     for (size_t e = 1; e <= epochs; ++e) {
         net.train<utec::neural_network::MSELoss>(X, Y, 1, batch_size, learning_rate);
         if (e % 10 == 0) {
-            auto pred = net.predict(X);
-            utec::neural_network::MSELoss<float> loss(pred, Y);
-            std::cout << "Época " << e << ", Loss: " << loss.loss() << "\n";
+            std::cout << "Época " << e << ", Loss: "
+                      << net.evaluate<utec::neural_network::MSELoss>(X, Y) << "\n";
         }
     }
 
@@ -8,17 +8,532 @@
 #include "nn_interfaces (4).h"
 #include "nn_optimizer (5).h"
 #include "nn_loss (5).h"
+#include "nn_dense (5).h"
+#include "nn_activation (3).h"
+#include "nn_plan.h"
 #include <vector>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 namespace utec::neural_network {
 
+    // Buffers reutilizados entre pasos de entrenamiento: se dimensionan en el
+    // primer paso y luego solo se reescriben in situ.
+    template<typename T>
+    struct Workspace {
+        std::vector<utec::algebra::Tensor<T,2>> activations;  // [0] = lote, [i+1] = salida de la capa i
+        utec::algebra::Tensor<T,2>              targets;
+        utec::algebra::Tensor<T,2>              grads[2];     // ping-pong de gradientes
+        std::vector<std::size_t>                order;
+        utec::algebra::CsrMatrix<T>             sparse_batch; // lote de una entrada CSR
+        std::vector<utec::algebra::Tensor<T,2>> checkpoints;  // fronteras de segmento
+        std::vector<std::size_t>                segments;
+        std::vector<utec::algebra::Tensor<T,2>> recompute;    // salidas del segmento en curso
+        std::vector<utec::algebra::Tensor<T,2>> planned;      // buffers compartidos del plan de compile()
+    };
+
     template<typename T>
     class NeuralNetwork {
         std::vector<std::unique_ptr<ILayer<T>>> layers_;
+        std::mt19937 rng_{42};
+        Workspace<T> ws_;
+        std::size_t last_step_allocations_ = 0;
+        T last_loss_ = T(0);
+        ParameterArena<T> arena_;
+        std::vector<ILayer<T>*> unmanaged_;   // capas sin parámetros registrados
+        bool arena_dirty_ = true;
+        std::size_t ckpt_every_ = 0, ckpt_budget_ = 0;
+        std::size_t peak_activation_bytes_ = 0;
+        ExecutionPlan plan_;          // vacío hasta compile()
+        mutable Profiler profiler_;   // vacío salvo con UTEC_PROFILE
+
+        // Reubica los parámetros de todas las capas en la arena contigua
+        void rebuild_arena() {
+            arena_.build(layers_);
+            unmanaged_.clear();
+            std::vector<Parameter<T>*> params;
+            for (auto& layer : layers_) {
+                params.clear();
+                layer->parameters(params);
+                if (params.empty()) unmanaged_.push_back(layer.get());
+            }
+            arena_dirty_ = false;
+        }
+
+        // Copia las filas idx[first, first+count) de src en dst (buffer reutilizado)
+        static void gather_rows(const utec::algebra::Tensor<T,2>& src,
+                                const std::vector<std::size_t>& idx,
+                                std::size_t first, std::size_t count,
+                                utec::algebra::Tensor<T,2>& dst) {
+            const std::size_t cols = src.shape()[1];
+            dst.reshape(count, cols);
+            for (std::size_t r = 0; r < count; ++r)
+                std::memcpy(dst.data() + r*cols, src.data() + idx[first + r]*cols, cols * sizeof(T));
+        }
+        static void gather_rows(const utec::algebra::CsrMatrix<T>& src,
+                                const std::vector<std::size_t>& idx,
+                                std::size_t first, std::size_t count,
+                                utec::algebra::CsrMatrix<T>& dst) {
+            dst.gather_rows(src, idx.data() + first, count);
+        }
+        utec::algebra::Tensor<T,2>& batch_buffer(const utec::algebra::Tensor<T,2>&) { return ws_.activations.front(); }
+        utec::algebra::CsrMatrix<T>& batch_buffer(const utec::algebra::CsrMatrix<T>&) { return ws_.sparse_batch; }
+
+        template<typename Input>
+        static constexpr bool is_sparse = std::is_same_v<Input, utec::algebra::CsrMatrix<T>>;
+
+        // Libera las salidas y cachés del modo normal al pasar a checkpointing
+        void drop_activation_buffers() {
+            if (!checkpointing()) return;
+            for (std::size_t i = 1; i < ws_.activations.size(); ++i)
+                ws_.activations[i] = utec::algebra::Tensor<T,2>();
+            for (auto& layer : layers_) layer->release_cache();
+        }
+
+        // add_layer / fuse_layers cambian la red: el plan deja de valer
+        void drop_plan() {
+            plan_ = ExecutionPlan{};
+            ws_.planned.clear();
+        }
+
+        void check_sparse_input() const {
+            if (layers_.empty())
+                throw std::logic_error("Sparse input needs a first layer that accepts it");
+        }
+
+        // Bucle de épocas y mini-batches común a entradas densas y CSR
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType, typename Input>
+        void train_rows(const Input& X, const utec::algebra::Tensor<T,2>& Y,
+                        size_t epochs, size_t batch_size, T learning_rate) {
+            const std::size_t n = X.shape()[0];
+            if (Y.shape()[0] != n)
+                throw std::invalid_argument("X and Y must have the same number of rows");
+            if (n == 0) return;
+            const std::size_t bs = (batch_size == 0 || batch_size > n) ? n : batch_size;
+
+            OptimizerType<T> optimizer(learning_rate);
+            if (arena_dirty_) rebuild_arena();
+            auto& order = ws_.order;
+            order.resize(n);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            auto& acts = ws_.activations;
+            acts.resize(layers_.size() + 1);
+            auto& batch = batch_buffer(X);
+            for (size_t e = 0; e < epochs; ++e) {
+                profiler_.begin_epoch();
+                std::shuffle(order.begin(), order.end(), rng_);
+                T epoch_loss = T(0);
+                for (std::size_t first = 0; first < n; first += bs) {
+                    const std::size_t allocs = utec::algebra::allocation_stats().allocations;
+                    const std::size_t count = std::min(bs, n - first);
+                    gather_rows(X, order, first, count, batch);
+                    gather_rows(Y, order, first, count, ws_.targets);
+                    epoch_loss += train_step<LossType>(batch, ws_.targets, optimizer)
+                                  * static_cast<T>(count);
+                    last_step_allocations_ = utec::algebra::allocation_stats().allocations - allocs;
+                }
+                last_loss_ = epoch_loss / static_cast<T>(n);
+                profiler_.end_epoch();
+            }
+        }
+        // Forward, pérdida, backward y paso del optimizador sobre un lote;
+        // devuelve la pérdida media del lote (con entrada CSR la primera capa
+        // usa su ruta dispersa y solo calcula los gradientes de sus parámetros)
+        template <template <typename...> class LossType, typename Optimizer, typename Input>
+        T train_step(const Input& X, const utec::algebra::Tensor<T,2>& Y, Optimizer& optimizer) {
+            T loss;
+            if (checkpointing() && !layers_.empty()) loss = checkpointed_pass<LossType>(X, Y);
+            else if constexpr (!is_sparse<Input>) loss = compiled() ? planned_pass<LossType>(X, Y)
+                                                                    : full_pass<LossType>(X, Y);
+            else loss = full_pass<LossType>(X, Y);
+            // Un solo paso fusionado sobre toda la arena
+            ProfileScope<T> prof(profiler_, "optimizer", Phase::update,
+                                 2.0 * double(arena_.size()), 3.0 * double(arena_.size()) * sizeof(T));
+            optimizer.step(arena_.values(), arena_.grads(), arena_.size());
+            for (auto* layer : unmanaged_)
+                layer->update_params(optimizer);
+            return loss;
+        }
+
+        // Primera capa: densa o dispersa según la entrada
+        template<typename Input>
+        void forward_first(const Input& X, utec::algebra::Tensor<T,2>& out) {
+            ProfileScope<T> prof(profiler_, 0, *layers_[0], Phase::forward, X, out);
+            if constexpr (is_sparse<Input>) layers_[0]->forward_sparse_into(X, out);
+            else layers_[0]->forward_into(X, out);
+        }
+        template<typename Input>
+        void infer_first(const Input& X, utec::algebra::Tensor<T,2>& out) const {
+            ProfileScope<T> prof(profiler_, 0, *layers_[0], Phase::forward, X, out);
+            if constexpr (is_sparse<Input>) layers_[0]->infer_sparse_into(X, out);
+            else layers_[0]->infer_into(X, out);
+        }
+
+        template <template <typename...> class LossType>
+        T loss_gradient(const utec::algebra::Tensor<T,2>& pred, const utec::algebra::Tensor<T,2>& Y) {
+            const double n = double(pred.size());
+            ProfileScope<T> prof(profiler_, "loss", Phase::loss, 3 * n, 3 * n * sizeof(T));
+            LossType<T> loss_obj(pred, Y);
+            return loss_obj.loss_and_gradient_into(ws_.grads[0]);
+        }
+
+        // Backward de las capas [begin, end) en orden inverso sobre el
+        // ping-pong de gradientes (cur indica el buffer con el gradiente actual)
+        template<typename Input>
+        void backward_layers(std::size_t begin, std::size_t end, std::size_t& cur) {
+            for (std::size_t i = end; i-- > begin; cur ^= 1) {
+                ProfileScope<T> prof(profiler_, int(i), *layers_[i], Phase::backward,
+                                     ws_.grads[cur], ws_.grads[cur ^ 1]);
+                if constexpr (is_sparse<Input>) {
+                    if (i == 0) {
+                        layers_[0]->backward_sparse(ws_.grads[cur]);
+                        continue;
+                    }
+                }
+                layers_[i]->backward_into(ws_.grads[cur], ws_.grads[cur ^ 1]);
+            }
+        }
+
+        // Paso normal: todas las salidas y cachés de capa viven hasta backward
+        template <template <typename...> class LossType, typename Input>
+        T full_pass(const Input& X, const utec::algebra::Tensor<T,2>& Y) {
+            auto& acts = ws_.activations;
+            const std::size_t L = layers_.size();
+            const utec::algebra::Tensor<T,2>* out = nullptr;
+            if constexpr (!is_sparse<Input>) out = &X;   // red sin capas
+            if (L > 0) {
+                forward_first(X, acts[1]);
+                out = &acts[1];
+            }
+            for (std::size_t i = 1; i < L; ++i) {
+                ProfileScope<T> prof(profiler_, int(i), *layers_[i], Phase::forward, *out, acts[i + 1]);
+                layers_[i]->forward_into(*out, acts[i + 1]);
+                out = &acts[i + 1];
+            }
+            std::size_t bytes = 0;
+            for (std::size_t i = 0; i < L; ++i)
+                bytes += acts[i + 1].size() * sizeof(T) + layers_[i]->cache_bytes();
+            peak_activation_bytes_ = bytes;
+            const T loss = loss_gradient<LossType>(*out, Y);
+            std::size_t cur = 0;
+            backward_layers<Input>(0, L, cur);
+            return loss;
+        }
+
+        // Checkpointing: el forward corre sin cachés (infer_into) y solo
+        // guarda la entrada de cada segmento; en backward cada segmento, del
+        // último al primero, repite su forward con cachés, hace su backward
+        // y libera las cachés antes de pasar al anterior. Cuesta un forward
+        // extra por paso a cambio de mantener vivas las salidas y cachés de
+        // un solo segmento en lugar de las de toda la red. Las salidas del
+        // segmento repetido van a buffers distintos: una capa puede leer la
+        // suya en backward (contrato de forward_into).
+        template <template <typename...> class LossType, typename Input>
+        T checkpointed_pass(const Input& X, const utec::algebra::Tensor<T,2>& Y) {
+            const std::size_t L = layers_.size();
+            auto& ck = ws_.checkpoints;   // ck[s-1] = entrada del segmento s (s >= 1)
+            auto& seg = ws_.segments;     // primera capa de cada segmento
+            auto& buf = ws_.recompute;    // el forward sin cachés alterna buf[0] y buf[1]
+            if (buf.size() < 2) buf.resize(2);
+            seg.assign(1, 0);
+            std::size_t nck = 0, ck_bytes = 0, seg_bytes = 0, seg_len = 0;
+            const utec::algebra::Tensor<T,2>* out = nullptr;
+            for (std::size_t i = 0; i < L; ++i) {
+                auto& dst = buf[i & 1];
+                if (i == 0) {
+                    infer_first(X, dst);
+                } else {
+                    ProfileScope<T> prof(profiler_, int(i), *layers_[i], Phase::forward, *out, dst);
+                    layers_[i]->infer_into(*out, dst);
+                }
+                out = &dst;
+                seg_bytes += dst.size() * sizeof(T);
+                ++seg_len;
+                const bool cut = ckpt_every_ ? seg_len >= ckpt_every_ : seg_bytes >= ckpt_budget_ / 2;
+                if (cut && i + 1 < L) {
+                    if (ck.size() <= nck) ck.emplace_back();
+                    ck[nck].reshape(dst.shape());
+                    std::memcpy(ck[nck].data(), dst.data(), dst.size() * sizeof(T));
+                    ck_bytes += dst.size() * sizeof(T);
+                    out = &ck[nck++];
+                    seg.push_back(i + 1);
+                    seg_bytes = seg_len = 0;
+                }
+            }
+            const T loss = loss_gradient<LossType>(*out, Y);
+            std::size_t longest = 0;
+            for (std::size_t s = 0; s < seg.size(); ++s)
+                longest = std::max(longest, (s + 1 < seg.size() ? seg[s + 1] : L) - seg[s]);
+            if (buf.size() < longest) buf.resize(longest);
+            auto buf_bytes = [&] {
+                std::size_t bytes = 0;
+                for (const auto& t : buf) bytes += t.size() * sizeof(T);
+                return bytes;
+            };
+            std::size_t peak = ck_bytes + buf_bytes(), cur = 0;
+            for (std::size_t s = seg.size(); s-- > 0;) {
+                const std::size_t b = seg[s], e = s + 1 < seg.size() ? seg[s + 1] : L;
+                const utec::algebra::Tensor<T,2>* in = b > 0 ? &ck[s - 1] : nullptr;
+                for (std::size_t i = b; i < e; ++i) {
+                    auto& dst = buf[i - b];
+                    if (i == 0) {
+                        forward_first(X, dst);
+                    } else {
+                        ProfileScope<T> prof(profiler_, int(i), *layers_[i], Phase::forward, *in, dst);
+                        layers_[i]->forward_into(*in, dst);
+                    }
+                    in = &dst;
+                }
+                std::size_t cache = 0;
+                for (std::size_t i = b; i < e; ++i) cache += layers_[i]->cache_bytes();
+                peak = std::max(peak, ck_bytes + buf_bytes() + cache);
+                backward_layers<Input>(b, e, cur);
+                for (std::size_t i = b; i < e; ++i) layers_[i]->release_cache();
+            }
+            peak_activation_bytes_ = peak;
+            return loss;
+        }
+
+        // Ejecución del plan de compile(): un switch sobre el tipo de paso
+        // con llamadas directas a las capas final conocidas; solo los pasos
+        // generic pasan por la interfaz virtual
+        template<typename Layer>
+        Layer& plan_layer(const PlanStep& st) const { return static_cast<Layer&>(*layers_[st.layer]); }
+
+        template<typename Op>
+        static void plan_activation(const utec::algebra::Tensor<T,2>& in, utec::algebra::Tensor<T,2>& out) {
+            out.reshape(in.shape());   // no-op si el plan la hace in situ
+            Op::forward(in.data(), out.data(), in.size());
+        }
+        template<typename Op>
+        static void plan_activation_grad(const utec::algebra::Tensor<T,2>& y, utec::algebra::Tensor<T,2>& g,
+                                         utec::algebra::Tensor<T,2>* dx) {
+            if (!dx) return;
+            dx->reshape(g.shape());
+            Op::backward(g.data(), y.data(), dx->data(), g.size());
+        }
+
+        void plan_forward(const PlanStep& st, const utec::algebra::Tensor<T,2>& in,
+                          utec::algebra::Tensor<T,2>& out, bool training) {
+            switch (st.kind) {
+                case PlanKind::dense:         plan_layer<Dense<T>>(st).forward_planned(in, out); break;
+                case PlanKind::dense_relu:    plan_layer<Dense<T>>(st).template forward_planned<ReLUOp<T>>(in, out); break;
+                case PlanKind::dense_sigmoid: plan_layer<Dense<T>>(st).template forward_planned<SigmoidOp<T>>(in, out); break;
+                case PlanKind::dense_tanh:    plan_layer<Dense<T>>(st).template forward_planned<TanhOp<T>>(in, out); break;
+                case PlanKind::fused_relu:    plan_layer<DenseReLU<T>>(st).forward_planned(in, out); break;
+                case PlanKind::fused_sigmoid: plan_layer<DenseSigmoid<T>>(st).forward_planned(in, out); break;
+                case PlanKind::fused_tanh:    plan_layer<DenseTanh<T>>(st).forward_planned(in, out); break;
+                case PlanKind::relu:          plan_activation<ReLUOp<T>>(in, out); break;
+                case PlanKind::sigmoid:       plan_activation<SigmoidOp<T>>(in, out); break;
+                case PlanKind::tanh:          plan_activation<TanhOp<T>>(in, out); break;
+                case PlanKind::generic:
+                    if (training) layers_[st.layer]->forward_into(in, out);
+                    else layers_[st.layer]->infer_into(in, out);
+                    break;
+            }
+        }
+
+        void plan_backward(const PlanStep& st, const utec::algebra::Tensor<T,2>& in,
+                           const utec::algebra::Tensor<T,2>& out, utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>* dx) {
+            switch (st.kind) {
+                case PlanKind::dense:         plan_layer<Dense<T>>(st).backward_planned(in, out, g, dx); break;
+                case PlanKind::dense_relu:    plan_layer<Dense<T>>(st).template backward_planned<ReLUOp<T>>(in, out, g, dx); break;
+                case PlanKind::dense_sigmoid: plan_layer<Dense<T>>(st).template backward_planned<SigmoidOp<T>>(in, out, g, dx); break;
+                case PlanKind::dense_tanh:    plan_layer<Dense<T>>(st).template backward_planned<TanhOp<T>>(in, out, g, dx); break;
+                case PlanKind::fused_relu:    plan_layer<DenseReLU<T>>(st).backward_planned(in, out, g, dx); break;
+                case PlanKind::fused_sigmoid: plan_layer<DenseSigmoid<T>>(st).backward_planned(in, out, g, dx); break;
+                case PlanKind::fused_tanh:    plan_layer<DenseTanh<T>>(st).backward_planned(in, out, g, dx); break;
+                // ReLU: y > 0 <=> z > 0, así que la salida sirve como en ReLU::backward_into
+                case PlanKind::relu:          plan_activation_grad<ReLUOp<T>>(out, g, dx); break;
+                case PlanKind::sigmoid:       plan_activation_grad<SigmoidOp<T>>(out, g, dx); break;
+                case PlanKind::tanh:          plan_activation_grad<TanhOp<T>>(out, g, dx); break;
+                case PlanKind::generic:       layers_[st.layer]->backward_into(g, *dx); break;
+            }
+        }
+
+        // Los buffers del plan tienen capacidad para batch_size filas: un lote
+        // mayor los haría crecer (y reservar) en pleno entrenamiento
+        void check_plan_input(const utec::algebra::Tensor<T,2>& X) const {
+            if (X.shape()[1] != plan_.input_features)
+                throw std::invalid_argument("Input has " + std::to_string(X.shape()[1]) +
+                                            " features but the network was compiled for " +
+                                            std::to_string(plan_.input_features));
+            if (X.shape()[0] > plan_.batch_size)
+                throw std::invalid_argument("Batch has " + std::to_string(X.shape()[0]) +
+                                            " rows but the network was compiled for at most " +
+                                            std::to_string(plan_.batch_size));
+        }
+
+        // Forward del plan; devuelve el buffer con la salida de la red
+        const utec::algebra::Tensor<T,2>& planned_forward(const utec::algebra::Tensor<T,2>& X, bool training) {
+            check_plan_input(X);
+            auto& buf = ws_.planned;
+            for (const auto& st : plan_.steps) {
+                const auto& in = st.in == PlanStep::npos ? X : buf[st.in];
+                ProfileScope<T> prof(profiler_, int(st.layer), *layers_[st.layer],
+                                     training ? Phase::forward : Phase::infer, in, buf[st.out]);
+                plan_forward(st, in, buf[st.out], training);
+            }
+            return buf[plan_.steps.back().out];
+        }
+
+        template <template <typename...> class LossType>
+        T planned_pass(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y) {
+            auto& buf = ws_.planned;
+            const auto& pred = planned_forward(X, true);
+            T loss;
+            {
+                const double n = double(pred.size());
+                ProfileScope<T> prof(profiler_, "loss", Phase::loss, 3 * n, 3 * n * sizeof(T));
+                LossType<T> loss_obj(pred, Y);
+                loss = loss_obj.loss_and_gradient_into(buf[plan_.loss_grad]);
+            }
+            for (std::size_t k = plan_.steps.size(); k-- > 0;) {
+                const auto& st = plan_.steps[k];
+                auto& g = buf[st.grad_out];
+                auto* dx = st.grad_in == PlanStep::npos ? nullptr : &buf[st.grad_in];
+                ProfileScope<T> prof(profiler_, int(st.layer), *layers_[st.layer], Phase::backward,
+                                     g, dx ? *dx : g);
+                plan_backward(st, st.in == PlanStep::npos ? X : buf[st.in], buf[st.out], g, dx);
+            }
+            peak_activation_bytes_ = plan_.elements() / plan_.batch_size * X.shape()[0] * sizeof(T);
+            return loss;
+        }
     public:
         void add_layer(std::unique_ptr<ILayer<T>> layer) {
             layers_.push_back(std::move(layer));
+            arena_dirty_ = true;
+            drop_plan();
+        }
+
+        // Sustituye cada Dense seguida de ReLU/Sigmoid/Tanh por la capa fusionada
+        // equivalente (mismos pesos): bias + activación en el epílogo del GEMM.
+        void fuse_layers() {
+            std::vector<std::unique_ptr<ILayer<T>>> fused;
+            for (std::size_t i = 0; i < layers_.size(); ++i) {
+                auto* dense = dynamic_cast<Dense<T>*>(layers_[i].get());
+                ILayer<T>* next = i + 1 < layers_.size() ? layers_[i + 1].get() : nullptr;
+                if (dense && dynamic_cast<ReLU<T>*>(next)) {
+                    fused.push_back(std::make_unique<DenseReLU<T>>(
+                            utec::algebra::Tensor<T,2>(dense->weights()),
+                            utec::algebra::Tensor<T,2>(dense->bias())));
+                    ++i;
+                } else if (dense && dynamic_cast<Sigmoid<T>*>(next)) {
+                    fused.push_back(std::make_unique<DenseSigmoid<T>>(
+                            utec::algebra::Tensor<T,2>(dense->weights()),
+                            utec::algebra::Tensor<T,2>(dense->bias())));
+                    ++i;
+                } else if (dense && dynamic_cast<Tanh<T>*>(next)) {
+                    fused.push_back(std::make_unique<DenseTanh<T>>(
+                            utec::algebra::Tensor<T,2>(dense->weights()),
+                            utec::algebra::Tensor<T,2>(dense->bias())));
+                    ++i;
+                } else {
+                    fused.push_back(std::move(layers_[i]));
+                }
+            }
+            layers_ = std::move(fused);
+            arena_dirty_ = true;
+            drop_plan();
+        }
+
+        // Compila la red para lotes de hasta batch_size filas de
+        // input_features columnas: infiere y valida las formas capa a capa,
+        // fusiona cada Dense con la ReLU/Sigmoid/Tanh siguiente y reparte
+        // activaciones y gradientes en buffers compartidos según su vida.
+        // Desde aquí train (entrada densa, sin checkpointing) y predict
+        // ejecutan el plan en lugar de recorrer las capas por la interfaz
+        // virtual; infer y evaluate siguen siendo const y no lo usan.
+        // train rechaza lotes de más de batch_size filas y predict recorre
+        // la entrada en bloques de batch_size. add_layer y fuse_layers
+        // descartan el plan.
+        const ExecutionPlan& compile(std::size_t input_features, std::size_t batch_size) {
+            ExecutionPlan plan = plan_execution<T>(layers_, input_features, batch_size);
+            plan_ = std::move(plan);
+            // Buffers a capacidad completa: el primer paso ya no reserva
+            ws_.planned.clear();
+            for (auto elems : plan_.buffer_elems) ws_.planned.emplace_back(elems, 1);
+            // El plan sustituye a las salidas, gradientes y cachés por capa
+            for (std::size_t i = 1; i < ws_.activations.size(); ++i)
+                ws_.activations[i] = utec::algebra::Tensor<T,2>();
+            ws_.grads[0] = ws_.grads[1] = utec::algebra::Tensor<T,2>();
+            for (auto& layer : layers_) layer->release_cache();
+            return plan_;
+        }
+
+        bool compiled() const noexcept { return !plan_.empty(); }
+        const ExecutionPlan& plan() const noexcept { return plan_; }
+
+        const std::vector<std::unique_ptr<ILayer<T>>>& layers() const noexcept { return layers_; }
+
+        // Tamaño de los parámetros de todas las capas en bytes
+        std::size_t parameter_bytes() const noexcept {
+            std::size_t total = 0;
+            for (const auto& layer : layers_) total += layer->parameter_bytes();
+            return total;
+        }
+
+        // Tiempos, FLOPs, bytes y reservas por capa y fase (con UTEC_PROFILE)
+        const Profiler& profiler() const noexcept { return profiler_; }
+        Profiler& profiler() noexcept { return profiler_; }
+
+        // Checkpointing de activaciones: guarda solo la entrada de cada
+        // segmento de every_layers capas y recalcula su forward en backward
+        // (0 lo desactiva). Las capas deben implementar infer_into.
+        void set_checkpointing(std::size_t every_layers) {
+            ckpt_every_ = every_layers;
+            ckpt_budget_ = 0;
+            drop_activation_buffers();
+        }
+
+        // Igual, pero corta los segmentos para que las activaciones de cada
+        // uno ocupen como mucho la mitad del presupuesto (la otra mitad es
+        // para las fronteras). Es un objetivo: peak_activation_bytes() da el
+        // valor real. 0 lo desactiva.
+        void set_checkpoint_budget(std::size_t bytes) {
+            ckpt_budget_ = bytes;
+            ckpt_every_ = 0;
+            drop_activation_buffers();
+        }
+
+        bool checkpointing() const noexcept { return ckpt_every_ != 0 || ckpt_budget_ != 0; }
+
+        // Máximo de bytes de activaciones vivos durante el último paso de
+        // train: salidas de capa, fronteras de segmento y cachés de las capas
+        // (sin el lote de entrada ni los gradientes). Con la red compilada
+        // son los buffers del plan, que incluyen también los gradientes.
+        std::size_t peak_activation_bytes() const noexcept { return peak_activation_bytes_; }
+
+        // Semilla del barajado de mini-batches
+        void set_seed(unsigned seed) { rng_.seed(seed); }
+
+        // Reservas de Tensor durante el último paso de train (0 en régimen estable).
+        // El contador es global: otras hebras que reserven tensores también suman.
+        std::size_t last_step_allocations() const noexcept { return last_step_allocations_; }
+
+        // Pérdida media de los mini-batches de la última época de train
+        T last_loss() const noexcept { return last_loss_; }
+
+        // Parámetros entrenables registrados en la arena (tras el primer train)
+        std::size_t parameter_count() const noexcept {
+            std::size_t total = 0;
+            for (auto* p : arena_.parameters()) total += p->size();
+            return total;
+        }
+        const std::vector<Parameter<T>*>& parameters() const noexcept { return arena_.parameters(); }
+
+        // Arena con los parámetros de todas las capas (la construye si hace falta)
+        ParameterArena<T>& parameter_arena() {
+            if (arena_dirty_) rebuild_arena();
+            return arena_;
         }
 
         template <template <typename...> class LossType,
@@ -26,26 +541,141 @@ namespace utec::neural_network {
         void train(const utec::algebra::Tensor<T,2>& X,
                    const utec::algebra::Tensor<T,2>& Y,
                    size_t epochs, size_t batch_size, T learning_rate) {
+            train_rows<LossType, OptimizerType>(X, Y, epochs, batch_size, learning_rate);
+        }
+
+        // Entrada CSR (one-hot, bag-of-features): la primera capa hace SpMM y
+        // su gradiente de pesos solo toca las filas activas del lote
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType = SGD>
+        void train(const utec::algebra::CsrMatrix<T>& X,
+                   const utec::algebra::Tensor<T,2>& Y,
+                   size_t epochs, size_t batch_size, T learning_rate) {
+            check_sparse_input();
+            train_rows<LossType, OptimizerType>(X, Y, epochs, batch_size, learning_rate);
+        }
+
+        // Entrenamiento desde una fuente de lotes en streaming (p. ej.
+        // StreamingDataset): por época llama a source.begin_epoch() y consume
+        // source.next() hasta nullptr; cada lote expone X e Y. Los lotes se
+        // usan in situ, sin copiarlos al Workspace.
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType = SGD, typename Source>
+        void train(Source& source, size_t epochs, T learning_rate) {
             OptimizerType<T> optimizer(learning_rate);
+            if (arena_dirty_) rebuild_arena();
+            ws_.activations.resize(layers_.size() + 1);
             for (size_t e = 0; e < epochs; ++e) {
-                auto a = X;
-                for (auto& layer : layers_)
-                    a = layer->forward(a);
-                LossType<T> loss_obj(a, Y);
-                auto grad = loss_obj.loss_gradient();
-                for (auto it = layers_.rbegin(); it != layers_.rend(); ++it)
-                    grad = (*it)->backward(grad);
-                for (auto& layer : layers_)
-                    layer->update_params(optimizer);
+                profiler_.begin_epoch();
+                source.begin_epoch();
+                T epoch_loss = T(0);
+                std::size_t rows = 0;
+                while (const auto* batch = source.next()) {
+                    const std::size_t allocs = utec::algebra::allocation_stats().allocations;
+                    const std::size_t count = batch->X.shape()[0];
+                    if (batch->Y.shape()[0] != count)
+                        throw std::invalid_argument("X and Y must have the same number of rows");
+                    epoch_loss += train_step<LossType>(batch->X, batch->Y, optimizer) * static_cast<T>(count);
+                    rows += count;
+                    last_step_allocations_ = utec::algebra::allocation_stats().allocations - allocs;
+                }
+                if (rows) last_loss_ = epoch_loss / static_cast<T>(rows);
+                profiler_.end_epoch();
             }
         }
 
+        // Pérdida del modelo sobre (X, Y) con inferencia const; no construye
+        // copias de las predicciones más allá de los buffers de infer_into
+        template <template <typename...> class LossType>
+        T evaluate(const utec::algebra::Tensor<T,2>& X,
+                   const utec::algebra::Tensor<T,2>& Y) const {
+            utec::algebra::Tensor<T,2> out, scratch;
+            infer_into(X, out, scratch);
+            return LossType<T>(out, Y).loss();
+        }
+        template <template <typename...> class LossType>
+        T evaluate(const utec::algebra::CsrMatrix<T>& X,
+                   const utec::algebra::Tensor<T,2>& Y) const {
+            utec::algebra::Tensor<T,2> out, scratch;
+            infer_into(X, out, scratch);
+            return LossType<T>(out, Y).loss();
+        }
+
+        // Con la red compilada recorre X en bloques de batch_size filas
+        // sobre los buffers del plan
         utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X) {
-            auto a = X;
-            for (auto& layer : layers_)
-                a = layer->forward(a);
+            if (!compiled()) return infer(X);
+            const std::size_t n = X.shape()[0], cols = X.shape()[1], bs = plan_.batch_size;
+            if (n <= bs) return planned_forward(X, false);
+            const std::size_t out_cols = plan_.steps.back().out_features;
+            utec::algebra::Tensor<T,2> out(n, out_cols);
+            if (ws_.activations.empty()) ws_.activations.resize(1);
+            auto& chunk = ws_.activations.front();
+            for (std::size_t first = 0; first < n; first += bs) {
+                const std::size_t count = std::min(bs, n - first);
+                chunk.reshape(count, cols);
+                std::memcpy(chunk.data(), X.data() + first * cols, count * cols * sizeof(T));
+                const auto& y = planned_forward(chunk, false);
+                std::memcpy(out.data() + first * out_cols, y.data(), count * out_cols * sizeof(T));
+            }
+            return out;
+        }
+        utec::algebra::Tensor<T,2> predict(const utec::algebra::CsrMatrix<T>& X) {
+            return infer(X);
+        }
+
+        // Inferencia const: no toca las cachés de entrenamiento, así que
+        // cualquier número de hebras puede compartir un mismo modelo
+        utec::algebra::Tensor<T,2> infer(const utec::algebra::Tensor<T,2>& X) const {
+            utec::algebra::Tensor<T,2> a, b;
+            infer_into(X, a, b);
             return a;
         }
+        utec::algebra::Tensor<T,2> infer(const utec::algebra::CsrMatrix<T>& X) const {
+            utec::algebra::Tensor<T,2> a, b;
+            infer_into(X, a, b);
+            return a;
+        }
+
+        // Variante con buffers del llamador (reutilizables entre llamadas);
+        // el resultado queda en out
+        void infer_into(const utec::algebra::Tensor<T,2>& X,
+                        utec::algebra::Tensor<T,2>& out,
+                        utec::algebra::Tensor<T,2>& scratch) const {
+            if (layers_.empty()) {
+                out = X;
+                return;
+            }
+            infer_layers(X, out, scratch);
+        }
+        void infer_into(const utec::algebra::CsrMatrix<T>& X,
+                        utec::algebra::Tensor<T,2>& out,
+                        utec::algebra::Tensor<T,2>& scratch) const {
+            check_sparse_input();
+            infer_layers(X, out, scratch);
+        }
+
+    private:
+        template<typename Input>
+        void infer_layers(const Input& X, utec::algebra::Tensor<T,2>& out,
+                          utec::algebra::Tensor<T,2>& scratch) const {
+            // Alterna out/scratch de modo que la última capa escriba en out
+            const bool even = layers_.size() % 2 == 0;
+            auto* dst = even ? &scratch : &out;
+            auto* other = even ? &out : &scratch;
+            {
+                ProfileScope<T> prof(profiler_, 0, *layers_.front(), Phase::infer, X, *dst);
+                if constexpr (is_sparse<Input>) layers_.front()->infer_sparse_into(X, *dst);
+                else layers_.front()->infer_into(X, *dst);
+            }
+            for (std::size_t i = 1; i < layers_.size(); ++i) {
+                {
+                    ProfileScope<T> prof(profiler_, int(i), *layers_[i], Phase::infer, *dst, *other);
+                    layers_[i]->infer_into(*dst, *other);
+                }
+                std::swap(dst, other);
+            }
+        }
     };
 
 }
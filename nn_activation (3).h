@@ -6,49 +6,322 @@
 #define EPIC1_OFICIAL_NN_ACTIVATION_H
 #pragma once
 #include "nn_interfaces (4).h"
+#include "tensor_simd.h"
 #include <cmath>
 
 namespace utec::neural_network {
 
+    namespace detail {
+        using utec::algebra::detail::simd_for;
+        using utec::algebra::detail::vexp;
+        using utec::algebra::detail::use_libm;
+
+        // 1 / (1 + e^{-a}) por carril
+        template<typename V, typename T>
+        typename V::reg vsigmoid(typename V::reg a) noexcept {
+            auto e = vexp<V, T>(V::sub(V::zero(), a));
+            return V::div(V::set1(T(1)), V::add(V::set1(T(1)), e));
+        }
+
+        // GELU (aproximación tanh): x·0.5·(1 + tanh(u)) = x·sigmoid(2u),
+        // u = sqrt(2/pi)·(x + 0.044715·x³)
+        template<typename T>
+        struct gelu_consts {
+            static constexpr T k = T(0.7978845608028654);
+            static constexpr T c = T(0.044715);
+        };
+    }
+
+    // Funciones elementales compartidas con las capas fusionadas (FusedDense);
+    // la derivada se expresa en función de la salida y = f(z). forward y
+    // backward son los kernels vectorizados sobre n elementos contiguos
+    // (backward: dx = g · f'(y) en una sola pasada).
     template<typename T>
-    class ReLU final : public ILayer<T> {
-        utec::algebra::Tensor<T,2> last_z_;
+    struct ReLUOp {
+        static constexpr const char* name = "ReLU";
+        static T apply(T z) noexcept { return z > T(0) ? z : T(0); }
+        static T derivative(T y) noexcept { return y > T(0) ? T(1) : T(0); }
+
+        static void forward(const T* z, T* y, size_t n) noexcept {
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                V::store(y + i, V::max(V::load(z + i), V::zero()));
+            });
+        }
+        static void backward(const T* g, const T* y, T* dx, size_t n) noexcept {
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                V::store(dx + i, V::select_gt0(V::load(y + i), V::load(g + i), V::zero()));
+            });
+        }
+    };
+
+    template<typename T>
+    struct SigmoidOp {
+        static constexpr const char* name = "Sigmoid";
+        static T apply(T z) noexcept { return T(1) / (T(1) + std::exp(-z)); }
+        static T derivative(T y) noexcept { return y * (T(1) - y); }
+
+        static void forward(const T* z, T* y, size_t n) noexcept {
+            if (detail::use_libm<T>()) {
+                for (size_t i = 0; i < n; ++i) y[i] = apply(z[i]);
+                return;
+            }
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                V::store(y + i, detail::vsigmoid<V, T>(V::load(z + i)));
+            });
+        }
+        static void backward(const T* g, const T* y, T* dx, size_t n) noexcept {
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto yi = V::load(y + i);
+                V::store(dx + i, V::mul(V::load(g + i), V::mul(yi, V::sub(V::set1(T(1)), yi))));
+            });
+        }
+    };
+
+    template<typename T>
+    struct TanhOp {
+        static constexpr const char* name = "Tanh";
+        static T apply(T z) noexcept { return std::tanh(z); }
+        static T derivative(T y) noexcept { return T(1) - y * y; }
+
+        // tanh(z) = 1 - 2 / (e^{2z} + 1); error absoluto del orden de eps cerca de 0
+        static void forward(const T* z, T* y, size_t n) noexcept {
+            if (detail::use_libm<T>()) {
+                for (size_t i = 0; i < n; ++i) y[i] = apply(z[i]);
+                return;
+            }
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto zi = V::load(z + i);
+                auto e = detail::vexp<V, T>(V::add(zi, zi));
+                V::store(y + i, V::sub(V::set1(T(1)),
+                                       V::div(V::set1(T(2)), V::add(e, V::set1(T(1))))));
+            });
+        }
+        static void backward(const T* g, const T* y, T* dx, size_t n) noexcept {
+            detail::simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto yi = V::load(y + i);
+                V::store(dx + i, V::mul(V::load(g + i), V::sub(V::set1(T(1)), V::mul(yi, yi))));
+            });
+        }
+    };
+
+    namespace detail {
+        template<typename T>
+        void leaky_relu_forward(const T* z, T* y, size_t n, T alpha) noexcept {
+            simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto zi = V::load(z + i);
+                V::store(y + i, V::select_gt0(zi, zi, V::mul(zi, V::set1(alpha))));
+            });
+        }
+
+        template<typename T>
+        void leaky_relu_backward(const T* g, const T* z, T* dx, size_t n, T alpha) noexcept {
+            simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto gi = V::load(g + i);
+                V::store(dx + i, V::select_gt0(V::load(z + i), gi, V::mul(gi, V::set1(alpha))));
+            });
+        }
+
+        template<typename T>
+        void gelu_forward(const T* x, T* y, size_t n) noexcept {
+            using C = gelu_consts<T>;
+            if (use_libm<T>()) {
+                for (size_t i = 0; i < n; ++i) {
+                    T u = C::k * (x[i] + C::c * x[i] * x[i] * x[i]);
+                    y[i] = T(0.5) * x[i] * (T(1) + std::tanh(u));
+                }
+                return;
+            }
+            simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto xi = V::load(x + i);
+                auto x2 = V::mul(xi, xi);
+                auto u2 = V::mul(V::set1(T(2) * C::k), V::fmadd(V::mul(x2, V::set1(C::c)), xi, xi));
+                V::store(y + i, V::mul(xi, vsigmoid<V, T>(u2)));
+            });
+        }
+
+        // dx = g · (s + x·2s(1-s)·u'),  s = sigmoid(2u),  u' = k·(1 + 3c·x²);
+        // recalcula s a partir de la entrada en la misma pasada
+        template<typename T>
+        void gelu_backward(const T* g, const T* x, T* dx, size_t n) noexcept {
+            using C = gelu_consts<T>;
+            if (use_libm<T>()) {
+                for (size_t i = 0; i < n; ++i) {
+                    T x2 = x[i] * x[i];
+                    T s  = T(0.5) * (T(1) + std::tanh(C::k * (x[i] + C::c * x2 * x[i])));
+                    T du = C::k * (T(1) + T(3) * C::c * x2);
+                    dx[i] = g[i] * (s + x[i] * T(2) * s * (T(1) - s) * du);
+                }
+                return;
+            }
+            simd_for<T>(n, [&](auto v, size_t i) {
+                using V = decltype(v);
+                auto xi = V::load(x + i);
+                auto x2 = V::mul(xi, xi);
+                auto u2 = V::mul(V::set1(T(2) * C::k), V::fmadd(V::mul(x2, V::set1(C::c)), xi, xi));
+                auto s  = vsigmoid<V, T>(u2);
+                auto du = V::mul(V::set1(C::k), V::fmadd(x2, V::set1(T(3) * C::c), V::set1(T(1))));
+                auto ds = V::mul(V::mul(V::set1(T(2)), s), V::sub(V::set1(T(1)), s));
+                V::store(dx + i, V::mul(V::load(g + i), V::fmadd(V::mul(xi, ds), du, s)));
+            });
+        }
+    }
+
+    // Base de las activaciones elemento a elemento: forward/backward por valor
+    // delegan en las variantes _into que implementa cada capa
+    template<typename T>
+    class ActivationLayer : public ILayer<T> {
     public:
         utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>& z) override {
-            last_z_ = z;
-            auto out = z;
-            for (auto& v : out) v = (v > T(0) ? v : T(0));
+            utec::algebra::Tensor<T,2> out;
+            this->forward_into(z, out);
             return out;
         }
         utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& g) override {
-            auto grad = g;
-            auto it_z = last_z_.cbegin();
-            for (auto& v : grad) {
-                v = ((*it_z++) > T(0)) ? v : T(0);
-            }
+            utec::algebra::Tensor<T,2> grad;
+            this->backward_into(g, grad);
             return grad;
         }
+        std::size_t output_features(std::size_t input_features) const override { return input_features; }
     };
 
     template<typename T>
-    class Sigmoid final : public ILayer<T> {
+    class ReLU final : public ActivationLayer<T> {
+        utec::algebra::Tensor<T,2> last_z_;
+    public:
+        void forward_into(const utec::algebra::Tensor<T,2>& z,
+                          utec::algebra::Tensor<T,2>& out) override {
+            last_z_ = z;
+            infer_into(z, out);
+        }
+        void infer_into(const utec::algebra::Tensor<T,2>& z,
+                        utec::algebra::Tensor<T,2>& out) const override {
+            out.reshape(z.shape());
+            ReLUOp<T>::forward(z.data(), out.data(), z.size());
+        }
+        void backward_into(const utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>& grad) override {
+            grad.reshape(g.shape());
+            // z > 0 <=> relu(z) > 0, así que la entrada sirve como "salida"
+            ReLUOp<T>::backward(g.data(), last_z_.data(), grad.data(), g.size());
+        }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<ReLU<T>>(); }
+        const char* name() const noexcept override { return "ReLU"; }
+        std::size_t cache_bytes() const noexcept override { return last_z_.size() * sizeof(T); }
+        void release_cache() override { last_z_ = utec::algebra::Tensor<T,2>(); }
+    };
+
+    template<typename T>
+    class Sigmoid final : public ActivationLayer<T> {
         utec::algebra::Tensor<T,2> last_out_;
     public:
-        utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>& z) override {
-            auto out = z;
-            for (auto& v : out) v = T(1) / (T(1) + std::exp(-v));
+        void forward_into(const utec::algebra::Tensor<T,2>& z,
+                          utec::algebra::Tensor<T,2>& out) override {
+            infer_into(z, out);
             last_out_ = out;
-            return out;
         }
-        utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& g) override {
-            auto grad = g;
-            auto it_o = last_out_.cbegin();
-            for (auto& v : grad) {
-                T o = *it_o++;
-                v = v * o * (T(1) - o);
-            }
-            return grad;
+        void infer_into(const utec::algebra::Tensor<T,2>& z,
+                        utec::algebra::Tensor<T,2>& out) const override {
+            out.reshape(z.shape());
+            SigmoidOp<T>::forward(z.data(), out.data(), z.size());
+        }
+        void backward_into(const utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>& grad) override {
+            grad.reshape(g.shape());
+            SigmoidOp<T>::backward(g.data(), last_out_.data(), grad.data(), g.size());
+        }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Sigmoid<T>>(); }
+        const char* name() const noexcept override { return "Sigmoid"; }
+        std::size_t cache_bytes() const noexcept override { return last_out_.size() * sizeof(T); }
+        void release_cache() override { last_out_ = utec::algebra::Tensor<T,2>(); }
+    };
+
+    template<typename T>
+    class Tanh final : public ActivationLayer<T> {
+        utec::algebra::Tensor<T,2> last_out_;
+    public:
+        void forward_into(const utec::algebra::Tensor<T,2>& z,
+                          utec::algebra::Tensor<T,2>& out) override {
+            infer_into(z, out);
+            last_out_ = out;
+        }
+        void infer_into(const utec::algebra::Tensor<T,2>& z,
+                        utec::algebra::Tensor<T,2>& out) const override {
+            out.reshape(z.shape());
+            TanhOp<T>::forward(z.data(), out.data(), z.size());
+        }
+        void backward_into(const utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>& grad) override {
+            grad.reshape(g.shape());
+            TanhOp<T>::backward(g.data(), last_out_.data(), grad.data(), g.size());
+        }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Tanh<T>>(); }
+        const char* name() const noexcept override { return "Tanh"; }
+        std::size_t cache_bytes() const noexcept override { return last_out_.size() * sizeof(T); }
+        void release_cache() override { last_out_ = utec::algebra::Tensor<T,2>(); }
+    };
+
+    template<typename T>
+    class LeakyReLU final : public ActivationLayer<T> {
+        T alpha_;
+        utec::algebra::Tensor<T,2> last_z_;
+    public:
+        explicit LeakyReLU(T alpha = T(0.01)) : alpha_(alpha) {}
+
+        void forward_into(const utec::algebra::Tensor<T,2>& z,
+                          utec::algebra::Tensor<T,2>& out) override {
+            last_z_ = z;
+            infer_into(z, out);
+        }
+        void infer_into(const utec::algebra::Tensor<T,2>& z,
+                        utec::algebra::Tensor<T,2>& out) const override {
+            out.reshape(z.shape());
+            detail::leaky_relu_forward(z.data(), out.data(), z.size(), alpha_);
+        }
+        void backward_into(const utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>& grad) override {
+            grad.reshape(g.shape());
+            detail::leaky_relu_backward(g.data(), last_z_.data(), grad.data(), g.size(), alpha_);
+        }
+
+        T alpha() const noexcept { return alpha_; }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<LeakyReLU<T>>(alpha_); }
+        const char* name() const noexcept override { return "LeakyReLU"; }
+        std::size_t cache_bytes() const noexcept override { return last_z_.size() * sizeof(T); }
+        void release_cache() override { last_z_ = utec::algebra::Tensor<T,2>(); }
+    };
+
+    template<typename T>
+    class GELU final : public ActivationLayer<T> {
+        utec::algebra::Tensor<T,2> last_x_;
+    public:
+        void forward_into(const utec::algebra::Tensor<T,2>& x,
+                          utec::algebra::Tensor<T,2>& out) override {
+            last_x_ = x;
+            infer_into(x, out);
+        }
+        void infer_into(const utec::algebra::Tensor<T,2>& x,
+                        utec::algebra::Tensor<T,2>& out) const override {
+            out.reshape(x.shape());
+            detail::gelu_forward(x.data(), out.data(), x.size());
+        }
+        void backward_into(const utec::algebra::Tensor<T,2>& g,
+                           utec::algebra::Tensor<T,2>& grad) override {
+            grad.reshape(g.shape());
+            detail::gelu_backward(g.data(), last_x_.data(), grad.data(), g.size());
         }
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<GELU<T>>(); }
+        const char* name() const noexcept override { return "GELU"; }
+        std::size_t cache_bytes() const noexcept override { return last_x_.size() * sizeof(T); }
+        void release_cache() override { last_x_ = utec::algebra::Tensor<T,2>(); }
     };
 
 }
@@ -0,0 +1,249 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_BATCHING_H
+#define EPIC1_OFICIAL_NN_BATCHING_H
+
+#include "neural_network (4).h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Motor de micro-batching para inferencia: los clientes envían filas
+    // sueltas y reciben un future; un hilo despachador agrupa las filas
+    // pendientes en un Tensor<T,2> (hasta max_batch o hasta que vence el plazo
+    // de la más antigua), ejecuta una sola pasada infer() y reparte resultados.
+    template<typename T>
+    class BatchingEngine {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        struct Options {
+            std::size_t               max_batch = 64;
+            std::chrono::microseconds max_delay{2000};
+            std::size_t               latency_window = 1 << 16;  // muestras para p50/p99
+        };
+
+        struct Stats {
+            std::size_t              queue_depth = 0;
+            std::size_t              requests    = 0;
+            std::size_t              batches     = 0;
+            std::vector<std::size_t> batch_size_histogram;  // [k] = lotes de tamaño k
+            double                   mean_batch  = 0;
+            double                   p50_us      = 0;
+            double                   p99_us      = 0;
+        };
+
+        BatchingEngine(const NeuralNetwork<T>& net, std::size_t in_features, Options opt = {})
+                : net_(net), in_f_(in_features), opt_(opt) {
+            if (opt_.max_batch == 0)
+                throw std::invalid_argument("max_batch must be positive");
+            histogram_.assign(opt_.max_batch + 1, 0);
+            latencies_.reserve(opt_.latency_window);
+            dispatcher_ = std::thread([this] { dispatch_loop(); });
+        }
+
+        ~BatchingEngine() {
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            dispatcher_.join();
+        }
+
+        BatchingEngine(const BatchingEngine&) = delete;
+        BatchingEngine& operator=(const BatchingEngine&) = delete;
+
+        std::future<std::vector<T>> submit(std::vector<T> row) {
+            if (row.size() != in_f_)
+                throw std::invalid_argument("Row size does not match the model input");
+            Request req{std::move(row), {}, clock::now()};
+            auto fut = req.result.get_future();
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                if (stopping_) throw std::runtime_error("BatchingEngine is shutting down");
+                queue_.push_back(std::move(req));
+            }
+            cv_.notify_one();
+            return fut;
+        }
+
+        Stats stats() const {
+            Stats s;
+            std::vector<double> lat;
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                s.queue_depth = queue_.size();
+            }
+            {
+                std::lock_guard<std::mutex> lk(stats_mutex_);
+                s.requests = requests_;
+                s.batches  = batches_;
+                s.batch_size_histogram = histogram_;
+                lat = latencies_;
+            }
+            s.mean_batch = s.batches ? double(s.requests) / double(s.batches) : 0.0;
+            s.p50_us = percentile(lat, 0.50);
+            s.p99_us = percentile(lat, 0.99);
+            return s;
+        }
+
+        void reset_stats() {
+            std::lock_guard<std::mutex> lk(stats_mutex_);
+            requests_ = batches_ = 0;
+            std::fill(histogram_.begin(), histogram_.end(), 0);
+            latencies_.clear();
+            next_sample_ = 0;
+        }
+
+    private:
+        struct Request {
+            std::vector<T>              row;
+            std::promise<std::vector<T>> result;
+            clock::time_point           enqueued;
+        };
+
+        const NeuralNetwork<T>&  net_;
+        std::size_t              in_f_;
+        Options                  opt_;
+        std::deque<Request>      queue_;
+        mutable std::mutex       mutex_, stats_mutex_;
+        std::condition_variable  cv_;
+        bool                     stopping_ = false;
+        std::thread              dispatcher_;
+
+        std::size_t              requests_ = 0, batches_ = 0, next_sample_ = 0;
+        std::vector<std::size_t> histogram_;
+        std::vector<double>      latencies_;   // ventana circular (µs)
+
+        static double percentile(std::vector<double>& v, double q) {
+            if (v.empty()) return 0.0;
+            auto k = static_cast<std::size_t>(q * double(v.size() - 1) + 0.5);
+            std::nth_element(v.begin(), v.begin() + k, v.end());
+            return v[k];
+        }
+
+        void dispatch_loop() {
+            std::vector<Request> batch;
+            batch.reserve(opt_.max_batch);
+            utec::algebra::Tensor<T,2> X, out, scratch;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lk(mutex_);
+                    cv_.wait(lk, [this] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty()) return;  // stopping_ y sin pendientes
+                    // Espera a llenar el lote o a que venza el plazo de la fila más antigua
+                    auto deadline = queue_.front().enqueued + opt_.max_delay;
+                    cv_.wait_until(lk, deadline, [this] {
+                        return stopping_ || queue_.size() >= opt_.max_batch;
+                    });
+                    std::size_t take = std::min(opt_.max_batch, queue_.size());
+                    for (std::size_t i = 0; i < take; ++i) {
+                        batch.push_back(std::move(queue_.front()));
+                        queue_.pop_front();
+                    }
+                }
+                run_batch(batch, X, out, scratch);
+                batch.clear();
+            }
+        }
+
+        void run_batch(std::vector<Request>& batch, utec::algebra::Tensor<T,2>& X,
+                       utec::algebra::Tensor<T,2>& out, utec::algebra::Tensor<T,2>& scratch) {
+            const std::size_t rows = batch.size();
+            X.reshape(rows, in_f_);
+            for (std::size_t r = 0; r < rows; ++r)
+                std::memcpy(X.data() + r*in_f_, batch[r].row.data(), in_f_ * sizeof(T));
+            try {
+                net_.infer_into(X, out, scratch);
+            } catch (...) {
+                for (auto& req : batch) req.result.set_exception(std::current_exception());
+                return;
+            }
+            const std::size_t out_f = out.shape()[1];
+            auto done = clock::now();
+            {
+                std::lock_guard<std::mutex> lk(stats_mutex_);
+                requests_ += rows;
+                ++batches_;
+                ++histogram_[rows];
+                for (auto& req : batch) {
+                    double us = std::chrono::duration<double, std::micro>(done - req.enqueued).count();
+                    if (latencies_.size() < opt_.latency_window) latencies_.push_back(us);
+                    else latencies_[next_sample_++ % opt_.latency_window] = us;
+                }
+            }
+            for (std::size_t r = 0; r < rows; ++r) {
+                const T* src = out.data() + r*out_f;
+                batch[r].result.set_value(std::vector<T>(src, src + out_f));
+            }
+        }
+    };
+
+    // Generador de carga sintética en lazo cerrado: `clients` hebras envían
+    // filas aleatorias y esperan cada respuesta (con un tiempo de "pensar"
+    // opcional). Sirve para ajustar max_batch / max_delay localmente.
+    // Una petición fallida se cuenta y el cliente sigue; tras unir las
+    // hebras se relanza la primera excepción, salvo con rethrow_errors =
+    // false, que solo la informa en el reporte.
+    template<typename T>
+    struct LoadReport {
+        double                            seconds        = 0;
+        double                            throughput_rps = 0;   // respuestas correctas por segundo
+        std::size_t                       failed         = 0;   // peticiones que lanzaron
+        std::exception_ptr                first_error;
+        typename BatchingEngine<T>::Stats stats;
+    };
+
+    template<typename T>
+    LoadReport<T> run_synthetic_load(BatchingEngine<T>& engine, std::size_t in_features,
+                                     std::size_t clients, std::size_t requests_per_client,
+                                     std::chrono::microseconds think_time = std::chrono::microseconds(0),
+                                     unsigned seed = 42, bool rethrow_errors = true) {
+        engine.reset_stats();
+        LoadReport<T> rep;
+        std::mutex error_mutex;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (std::size_t c = 0; c < clients; ++c)
+            workers.emplace_back([&, c] {
+                std::mt19937 rng(seed + static_cast<unsigned>(c));
+                std::uniform_real_distribution<double> dist(-1.0, 1.0);
+                std::vector<T> row(in_features);
+                for (std::size_t i = 0; i < requests_per_client; ++i) {
+                    for (auto& v : row) v = static_cast<T>(dist(rng));
+                    try {
+                        engine.submit(row).get();
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lk(error_mutex);
+                        ++rep.failed;
+                        if (!rep.first_error) rep.first_error = std::current_exception();
+                    }
+                    if (think_time.count() > 0) std::this_thread::sleep_for(think_time);
+                }
+            });
+        for (auto& w : workers) w.join();
+        rep.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const std::size_t ok = clients * requests_per_client - rep.failed;
+        rep.throughput_rps = rep.seconds > 0 ? double(ok) / rep.seconds : 0.0;
+        rep.stats = engine.stats();
+        if (rethrow_errors && rep.first_error) std::rethrow_exception(rep.first_error);
+        return rep;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_NN_BATCHING_H
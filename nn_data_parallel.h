@@ -0,0 +1,270 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_DATA_PARALLEL_H
+#define EPIC1_OFICIAL_NN_DATA_PARALLEL_H
+
+#include "neural_network (4).h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utec::neural_network {
+
+    namespace detail {
+        inline constexpr std::size_t allreduce_grain = 1 << 14;
+    }
+
+    // Entrenamiento síncrono con paralelismo de datos: cada mini-batch se
+    // reparte en N trozos contiguos, una réplica por trozo hace forward y
+    // backward con sus propias cachés de capa, y los gradientes se combinan
+    // con una reducción en árbol (ponderada por filas de cada trozo) antes
+    // de un único paso del optimizador sobre la arena de la red.
+    //
+    // Las réplicas comparten los valores de la arena (sin copias) y cada una
+    // tiene su buffer de gradientes; la réplica 0 usa el de la propia arena.
+    // El orden de las sumas depende solo de N, así que con N fijo el
+    // resultado es determinista sin importar cómo se repartan las tareas.
+    // Dentro de cada réplica los GEMM corren en su hebra (las llamadas
+    // anidadas al pool son secuenciales).
+    template<typename T>
+    class DataParallelTrainer {
+    public:
+        explicit DataParallelTrainer(NeuralNetwork<T>& net,
+                                     std::size_t replicas = utec::algebra::num_threads())
+                : net_(net), replicas_(replicas) {
+            if (replicas_.empty()) throw std::invalid_argument("DataParallelTrainer needs at least one replica");
+        }
+
+        DataParallelTrainer(const DataParallelTrainer&) = delete;
+        DataParallelTrainer& operator=(const DataParallelTrainer&) = delete;
+
+        void set_seed(unsigned seed) { rng_.seed(seed); }
+        std::size_t replicas() const noexcept { return replicas_.size(); }
+        T last_loss() const noexcept { return last_loss_; }
+
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType = SGD>
+        void train(const utec::algebra::Tensor<T,2>& X,
+                   const utec::algebra::Tensor<T,2>& Y,
+                   std::size_t epochs, std::size_t batch_size, T learning_rate) {
+            const std::size_t n = X.shape()[0];
+            if (Y.shape()[0] != n)
+                throw std::invalid_argument("X and Y must have the same number of rows");
+            if (n == 0) return;
+            check_shapes(X, Y);
+            const std::size_t bs = (batch_size == 0 || batch_size > n) ? n : batch_size;
+
+            OptimizerType<T> optimizer(learning_rate);
+            auto& arena = net_.parameter_arena();
+            bind_replicas(arena);
+            order_.resize(n);
+            std::iota(order_.begin(), order_.end(), std::size_t(0));
+            const std::size_t N = replicas_.size();
+            for (std::size_t e = 0; e < epochs; ++e) {
+                std::shuffle(order_.begin(), order_.end(), rng_);
+                T epoch_loss = T(0);
+                for (std::size_t first = 0; first < n; first += bs) {
+                    const std::size_t count = std::min(bs, n - first);
+                    utec::algebra::default_thread_pool().parallel_for(N, [&](std::size_t r) {
+                        const std::size_t b = first + count * r / N;
+                        const std::size_t c = first + count * (r + 1) / N - b;
+                        replicas_[r].rows = c;
+                        if (c) run_guarded<LossType>(replicas_[r], X, Y, b, c);
+                    });
+                    // Tras la unión: la excepción de la réplica de menor índice
+                    std::exception_ptr error;
+                    for (auto& rep : replicas_)
+                        if (auto e = std::exchange(rep.error, nullptr); e && !error) error = e;
+                    if (error) std::rethrow_exception(error);
+                    T batch_loss = T(0);
+                    for (auto& rep : replicas_)
+                        if (rep.rows) batch_loss += rep.loss * static_cast<T>(rep.rows);
+                    epoch_loss += batch_loss;
+                    all_reduce(arena.size(), count);
+                    optimizer.step(arena.values(), arena.grads(), arena.size());
+                }
+                last_loss_ = epoch_loss / static_cast<T>(n);
+            }
+        }
+
+    private:
+        struct Replica {
+            std::vector<std::unique_ptr<ILayer<T>>> layers;
+            std::vector<utec::algebra::Tensor<T,2>> acts;
+            utec::algebra::Tensor<T,2>              X, Y, grads[2];
+            utec::algebra::Tensor<T,1>              own_grads;   // vacío en la réplica 0
+            T*                                      grad_buf = nullptr;
+            std::size_t                             rows = 0;
+            T                                       loss = T(0);
+            std::exception_ptr                      error;
+        };
+
+        NeuralNetwork<T>&        net_;
+        std::vector<Replica>     replicas_;
+        std::vector<std::size_t> order_;
+        std::mt19937             rng_{42};
+        T                        last_loss_ = T(0);
+
+        // Clona las capas de la red y apunta sus parámetros a la arena. Se
+        // rehace en cada train(): la red pudo cambiar de capas o de arena
+        void bind_replicas(ParameterArena<T>& arena) {
+            const auto& master = arena.parameters();
+            std::vector<Parameter<T>*> params;
+            for (std::size_t r = 0; r < replicas_.size(); ++r) {
+                auto& rep = replicas_[r];
+                rep.layers.clear();
+                for (const auto& layer : net_.layers()) rep.layers.push_back(layer->clone());
+                rep.acts.resize(rep.layers.size() + 1);
+                if (r == 0) {
+                    rep.own_grads = utec::algebra::Tensor<T,1>();
+                    rep.grad_buf = arena.grads();
+                } else {
+                    rep.own_grads = utec::algebra::Tensor<T,1>(arena.size());
+                    rep.own_grads.fill(T(0));
+                    rep.grad_buf = rep.own_grads.data();
+                }
+                params.clear();
+                for (auto& layer : rep.layers) layer->parameters(params);
+                if (params.size() != master.size())
+                    throw std::logic_error("Cloned layers do not expose the same parameters");
+                for (std::size_t i = 0; i < params.size(); ++i) {
+                    if (params[i]->size() != master[i]->size())
+                        throw std::logic_error("Cloned layers do not expose the same parameters");
+                    const std::size_t off = static_cast<std::size_t>(master[i]->value().data() - arena.values());
+                    params[i]->alias(arena.values() + off, rep.grad_buf + off);
+                }
+            }
+        }
+
+        // Comprueba X e Y contra la red antes de lanzar réplicas: así un
+        // error de forma se informa una vez y no a mitad de una época
+        void check_shapes(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y) const {
+            std::size_t width = X.shape()[1];
+            const auto& layers = net_.layers();
+            for (std::size_t i = 0; i < layers.size(); ++i) {
+                try {
+                    width = layers[i]->output_features(width);
+                } catch (const std::exception& e) {
+                    throw std::invalid_argument("DataParallelTrainer: layer " + std::to_string(i) + " (" +
+                                                layers[i]->name() + "): " + e.what());
+                }
+            }
+            if (Y.shape()[1] != width)
+                throw std::invalid_argument("DataParallelTrainer: Y has " + std::to_string(Y.shape()[1]) +
+                                            " columns but the network outputs " + std::to_string(width));
+        }
+
+        // Cada réplica guarda su excepción; se relanza tras la unión
+        template <template <typename...> class LossType>
+        void run_guarded(Replica& rep, const utec::algebra::Tensor<T,2>& X,
+                         const utec::algebra::Tensor<T,2>& Y, std::size_t first, std::size_t count) {
+            try {
+                run_replica<LossType>(rep, X, Y, first, count);
+            } catch (...) {
+                rep.error = std::current_exception();
+            }
+        }
+
+        template <template <typename...> class LossType>
+        void run_replica(Replica& rep, const utec::algebra::Tensor<T,2>& X,
+                         const utec::algebra::Tensor<T,2>& Y, std::size_t first, std::size_t count) {
+            const std::size_t fx = X.shape()[1], fy = Y.shape()[1];
+            rep.X.reshape(count, fx);
+            rep.Y.reshape(count, fy);
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t row = order_[first + i];
+                std::memcpy(rep.X.data() + i*fx, X.data() + row*fx, fx * sizeof(T));
+                std::memcpy(rep.Y.data() + i*fy, Y.data() + row*fy, fy * sizeof(T));
+            }
+            const utec::algebra::Tensor<T,2>* in = &rep.X;
+            for (std::size_t i = 0; i < rep.layers.size(); ++i) {
+                rep.layers[i]->forward_into(*in, rep.acts[i + 1]);
+                in = &rep.acts[i + 1];
+            }
+            LossType<T> loss_obj(*in, rep.Y);
+            rep.loss = loss_obj.loss_and_gradient_into(rep.grads[0]);
+            std::size_t cur = 0;
+            for (auto it = rep.layers.rbegin(); it != rep.layers.rend(); ++it, cur ^= 1)
+                (*it)->backward_into(rep.grads[cur], rep.grads[cur ^ 1]);
+        }
+
+        // g_0 = Σ_r (filas_r / filas) · g_r, por bloques de la arena en
+        // paralelo; dentro de cada bloque el árbol suma r += r + s para
+        // s = 1, 2, 4... (orden fijo para un N dado)
+        void all_reduce(std::size_t size, std::size_t batch_rows) {
+            const std::size_t N = replicas_.size();
+            utec::algebra::parallel_for_blocks(size, detail::allreduce_grain,
+                                               [&](std::size_t b, std::size_t e) {
+                for (auto& rep : replicas_) {
+                    T* g = rep.grad_buf;
+                    if (rep.rows == 0) {
+                        std::fill(g + b, g + e, T(0));
+                    } else if (rep.rows != batch_rows) {
+                        const T w = static_cast<T>(rep.rows) / static_cast<T>(batch_rows);
+                        for (std::size_t i = b; i < e; ++i) g[i] *= w;
+                    }
+                }
+                for (std::size_t s = 1; s < N; s *= 2)
+                    for (std::size_t r = 0; r + s < N; r += 2 * s) {
+                        T* dst = replicas_[r].grad_buf;
+                        const T* src = replicas_[r + s].grad_buf;
+                        for (std::size_t i = b; i < e; ++i) dst[i] += src[i];
+                    }
+            });
+        }
+    };
+
+    // Escalabilidad del entrenamiento con 1..max_threads hebras (una réplica
+    // por hebra); make_net() debe devolver siempre la misma red inicial
+    struct ScalingPoint {
+        std::size_t threads           = 1;
+        double      seconds_per_epoch = 0;
+        double      speedup           = 1;   // respecto a 1 hebra
+        double      efficiency        = 1;   // speedup / threads
+        double      final_loss        = 0;
+    };
+
+    template <template <typename...> class LossType,
+            template <typename...> class OptimizerType = SGD,
+            typename T, typename MakeNet>
+    std::vector<ScalingPoint> data_parallel_scaling(MakeNet make_net,
+                                                    const utec::algebra::Tensor<T,2>& X,
+                                                    const utec::algebra::Tensor<T,2>& Y,
+                                                    std::size_t batch_size, T learning_rate,
+                                                    std::size_t max_threads, std::size_t epochs = 1) {
+        const std::size_t saved = utec::algebra::num_threads();
+        std::vector<ScalingPoint> report;
+        for (std::size_t t = 1; t <= max_threads; ++t) {
+            utec::algebra::set_num_threads(t);
+            NeuralNetwork<T> net = make_net();
+            DataParallelTrainer<T> trainer(net, t);
+            trainer.template train<LossType, OptimizerType>(X, Y, 1, batch_size, learning_rate);  // calentamiento
+            auto start = std::chrono::steady_clock::now();
+            trainer.template train<LossType, OptimizerType>(X, Y, epochs, batch_size, learning_rate);
+            const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ScalingPoint p;
+            p.threads = t;
+            p.seconds_per_epoch = epochs ? secs / double(epochs) : 0.0;
+            p.final_loss = static_cast<double>(trainer.last_loss());
+            if (!report.empty() && p.seconds_per_epoch > 0)
+                p.speedup = report.front().seconds_per_epoch / p.seconds_per_epoch;
+            p.efficiency = p.speedup / double(t);
+            report.push_back(p);
+        }
+        utec::algebra::set_num_threads(saved);
+        return report;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_NN_DATA_PARALLEL_H
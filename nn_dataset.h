@@ -0,0 +1,439 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_DATASET_H
+#define EPIC1_OFICIAL_NN_DATASET_H
+
+#include "nn_serialization.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Archivo de registros (versión 1, little-endian):
+    //
+    //   [DatasetHeader 64 B][fila 0][fila 1]...
+    //
+    // Cada fila guarda features y luego targets como T contiguos, así que un
+    // registro se copia al lote con una sola lectura secuencial.
+    namespace dataset_format {
+        inline constexpr char          magic[8]    = {'U','T','E','C','D','S','\0','\0'};
+        inline constexpr std::uint32_t version     = 1;
+        inline constexpr std::uint64_t data_offset = 64;
+
+        struct DatasetHeader {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t endian_tag;
+            std::uint32_t scalar_size;
+            std::uint32_t reserved;
+            std::uint64_t features;
+            std::uint64_t targets;
+            std::uint64_t rows;
+            std::uint64_t data_offset;
+            std::uint64_t checksum;     // FNV-1a de la cabecera con checksum = 0
+        };
+        static_assert(sizeof(DatasetHeader) == 64, "DatasetHeader must be 64 bytes");
+
+        inline std::uint64_t checksum(DatasetHeader h) noexcept {
+            h.checksum = 0;
+            return model_format::fnv1a(&h, sizeof(h));
+        }
+    }
+
+    // Escritura incremental de un archivo de registros. Escribe en un temporal
+    // y lo renombra en finish(), así que un lector nunca ve un archivo a medias.
+    template<typename T>
+    class DatasetWriter {
+    public:
+        DatasetWriter(std::string path, std::size_t features, std::size_t targets)
+                : path_(std::move(path)), tmp_(path_ + ".tmp"), features_(features), targets_(targets),
+                  out_(tmp_, std::ios::binary | std::ios::trunc) {
+            static_assert(std::is_floating_point_v<T>, "Only floating-point datasets are supported");
+            if (features == 0 || targets == 0)
+                throw std::invalid_argument("Dataset needs at least one feature and one target");
+            if (!out_) throw std::runtime_error("Cannot create dataset file: " + tmp_);
+            const char zeros[dataset_format::data_offset] = {};
+            out_.write(zeros, sizeof(zeros));
+        }
+
+        DatasetWriter(const DatasetWriter&) = delete;
+        DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+        ~DatasetWriter() {
+            if (!finished_) {
+                out_.close();
+                std::error_code ec;
+                std::filesystem::remove(tmp_, ec);
+            }
+        }
+
+        void write(const T* features, const T* targets) {
+            out_.write(reinterpret_cast<const char*>(features), static_cast<std::streamsize>(features_ * sizeof(T)));
+            out_.write(reinterpret_cast<const char*>(targets), static_cast<std::streamsize>(targets_ * sizeof(T)));
+            ++rows_;
+        }
+
+        void write(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y) {
+            if (X.shape()[1] != features_ || Y.shape()[1] != targets_ || X.shape()[0] != Y.shape()[0])
+                throw std::invalid_argument("Tensor shapes do not match the dataset layout");
+            for (std::size_t i = 0; i < X.shape()[0]; ++i)
+                write(X.data() + i*features_, Y.data() + i*targets_);
+        }
+
+        void finish() {
+            if (finished_) return;
+            dataset_format::DatasetHeader h{};
+            std::memcpy(h.magic, dataset_format::magic, sizeof(h.magic));
+            h.version     = dataset_format::version;
+            h.endian_tag  = model_format::endian_tag;
+            h.scalar_size = sizeof(T);
+            h.features    = features_;
+            h.targets     = targets_;
+            h.rows        = rows_;
+            h.data_offset = dataset_format::data_offset;
+            h.checksum    = dataset_format::checksum(h);
+            out_.seekp(0);
+            out_.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out_.close();
+            if (!out_) throw std::runtime_error("Cannot write dataset file: " + tmp_);
+            std::filesystem::rename(tmp_, path_);
+            finished_ = true;
+        }
+
+        std::size_t rows() const noexcept { return rows_; }
+
+    private:
+        std::string   path_, tmp_;
+        std::size_t   features_, targets_, rows_ = 0;
+        std::ofstream out_;
+        bool          finished_ = false;
+    };
+
+    // Guarda (X, Y) ya en memoria como archivo de registros
+    template<typename T>
+    void write_dataset(const std::string& path, const utec::algebra::Tensor<T,2>& X,
+                       const utec::algebra::Tensor<T,2>& Y) {
+        DatasetWriter<T> w(path, X.shape()[1], Y.shape()[1]);
+        w.write(X, Y);
+        w.finish();
+    }
+
+    struct CsvOptions {
+        std::size_t targets   = 1;     // últimas columnas de cada fila
+        char        delimiter = ',';
+        bool        header    = true;  // salta la primera línea
+    };
+
+    // Convierte un CSV numérico en archivo de registros fila a fila (memoria
+    // constante). Devuelve el número de filas escritas.
+    template<typename T>
+    std::size_t import_csv(const std::string& csv_path, const std::string& dataset_path,
+                           CsvOptions opt = {}) {
+        std::ifstream in(csv_path);
+        if (!in) throw std::runtime_error("Cannot open CSV file: " + csv_path);
+        std::string line;
+        std::size_t line_no = 0;
+        if (opt.header) { std::getline(in, line); ++line_no; }
+        std::vector<T> row;
+        std::unique_ptr<DatasetWriter<T>> writer;
+        std::size_t cols = 0;
+        while (std::getline(in, line)) {
+            ++line_no;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            row.clear();
+            const char* p = line.c_str();
+            for (;;) {
+                char* end = nullptr;
+                const double v = std::strtod(p, &end);
+                if (end == p)
+                    throw std::runtime_error("Invalid number in " + csv_path + " at line " + std::to_string(line_no));
+                row.push_back(static_cast<T>(v));
+                while (*end == ' ' || *end == '\t') ++end;
+                if (*end == '\0') break;
+                if (*end != opt.delimiter)
+                    throw std::runtime_error("Unexpected character in " + csv_path + " at line " + std::to_string(line_no));
+                p = end + 1;
+            }
+            if (!writer) {
+                cols = row.size();
+                if (cols <= opt.targets)
+                    throw std::invalid_argument("CSV must have more columns than targets");
+                writer = std::make_unique<DatasetWriter<T>>(dataset_path, cols - opt.targets, opt.targets);
+            } else if (row.size() != cols) {
+                throw std::runtime_error("Inconsistent column count in " + csv_path + " at line " + std::to_string(line_no));
+            }
+            writer->write(row.data(), row.data() + (cols - opt.targets));
+        }
+        if (!writer) throw std::runtime_error("CSV file has no data rows: " + csv_path);
+        writer->finish();
+        return writer->rows();
+    }
+
+    struct StreamOptions {
+        std::size_t batch_size    = 32;
+        bool        shuffle       = true;
+        bool        drop_last     = false;
+        std::size_t block_rows    = 4096;  // unidad contigua de lectura
+        std::size_t window_blocks = 16;    // bloques barajados juntos (memoria de la ventana)
+        std::size_t prefetch      = 4;     // lotes listos como máximo (cola acotada)
+        std::size_t workers       = 1;     // hebras que arman lotes
+        unsigned    seed          = 42;
+    };
+
+    // Lote entregado por StreamingDataset
+    template<typename T>
+    struct Batch {
+        utec::algebra::Tensor<T,2> X, Y;
+    };
+
+    // Dataset en streaming sobre un archivo de registros mapeado. Cada época
+    // baraja el orden de los bloques y, dentro de ventanas de window_blocks
+    // bloques, el de las filas (barajado aproximado con memoria acotada; con
+    // una ventana que cubra todo el archivo es una permutación completa).
+    // Las hebras de fondo arman los lotes en un anillo de `prefetch` huecos
+    // reutilizados y el consumidor los recibe en orden con next(); el
+    // contenido de cada lote depende solo de (seed, época, índice), no del
+    // número de hebras.
+    template<typename T>
+    class StreamingDataset {
+    public:
+        struct Stats {
+            std::size_t batches      = 0;   // lotes entregados
+            double      wait_seconds = 0;   // tiempo del consumidor bloqueado en next()
+        };
+
+        explicit StreamingDataset(const std::string& path, StreamOptions opt = {})
+                : opt_(opt), file_(std::make_shared<detail::MappedFile>(path, LoadMode::map, false)) {
+            if (opt_.batch_size == 0 || opt_.block_rows == 0 || opt_.window_blocks == 0 ||
+                opt_.prefetch == 0 || opt_.workers == 0)
+                throw std::invalid_argument("Stream options must be positive");
+            if (file_->size() < sizeof(dataset_format::DatasetHeader))
+                throw std::runtime_error("Invalid dataset file: truncated header");
+            dataset_format::DatasetHeader h;
+            std::memcpy(&h, file_->data(), sizeof(h));
+            if (std::memcmp(h.magic, dataset_format::magic, sizeof(h.magic)) != 0)
+                throw std::runtime_error("Invalid dataset file: bad magic");
+            if (h.version != dataset_format::version)
+                throw std::runtime_error("Unsupported dataset file version " + std::to_string(h.version));
+            if (h.endian_tag != model_format::endian_tag)
+                throw std::runtime_error("Dataset file has a different byte order");
+            if (h.scalar_size != sizeof(T))
+                throw std::invalid_argument("Dataset scalar type does not match the requested type");
+            if (dataset_format::checksum(h) != h.checksum)
+                throw std::runtime_error("Invalid dataset file: checksum mismatch");
+            features_ = h.features;
+            targets_  = h.targets;
+            rows_     = h.rows;
+            stride_   = (features_ + targets_) * sizeof(T);
+            if (h.data_offset != dataset_format::data_offset || features_ == 0 || targets_ == 0 ||
+                rows_ > (file_->size() - h.data_offset) / stride_)
+                throw std::runtime_error("Invalid dataset file: inconsistent header");
+            data_ = file_->data() + h.data_offset;
+            slots_.resize(opt_.prefetch);
+        }
+
+        ~StreamingDataset() { stop(); }
+
+        StreamingDataset(const StreamingDataset&) = delete;
+        StreamingDataset& operator=(const StreamingDataset&) = delete;
+
+        std::size_t rows() const noexcept { return rows_; }
+        std::size_t features() const noexcept { return features_; }
+        std::size_t targets() const noexcept { return targets_; }
+        std::size_t batch_size() const noexcept { return opt_.batch_size; }
+        std::size_t batches_per_epoch() const noexcept {
+            return opt_.drop_last ? rows_ / opt_.batch_size
+                                  : (rows_ + opt_.batch_size - 1) / opt_.batch_size;
+        }
+
+        // Empieza una época nueva (cancela la anterior si no se terminó)
+        void begin_epoch() {
+            stop();
+            ++epoch_;
+            plan_epoch();
+            next_ = consumed_ = 0;
+            stopping_ = false;
+            error_ = nullptr;
+            for (auto& s : slots_) s.seq = npos;
+            for (std::size_t w = 0; w < opt_.workers; ++w)
+                workers_.emplace_back([this, w] { worker_loop(w); });
+        }
+
+        // Siguiente lote de la época o nullptr al terminar; el puntero vale
+        // hasta la siguiente llamada (el hueco se recicla entonces)
+        const Batch<T>* next() {
+            std::unique_lock<std::mutex> lk(mutex_);
+            if (next_ > consumed_) {
+                consumed_ = next_;
+                cv_space_.notify_all();
+            }
+            if (next_ >= batches_) return nullptr;
+            auto& slot = slots_[next_ % slots_.size()];
+            auto start = std::chrono::steady_clock::now();
+            cv_ready_.wait(lk, [&] { return slot.seq == next_ || error_; });
+            stats_.wait_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (error_) std::rethrow_exception(error_);
+            ++next_;
+            ++stats_.batches;
+            return &slot.batch;
+        }
+
+        Stats stats() const {
+            std::lock_guard<std::mutex> lk(mutex_);
+            return stats_;
+        }
+        void reset_stats() {
+            std::lock_guard<std::mutex> lk(mutex_);
+            stats_ = Stats{};
+        }
+
+    private:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        struct Slot {
+            Batch<T>    batch;
+            std::size_t seq = npos;   // lote que contiene (npos = libre)
+        };
+
+        // Caché de cada hebra: permutación de la última ventana usada
+        struct WindowCache {
+            std::size_t              window = npos;
+            std::vector<std::size_t> rows;
+        };
+
+        StreamOptions                      opt_;
+        std::shared_ptr<detail::MappedFile> file_;
+        const unsigned char*               data_ = nullptr;
+        std::size_t                        features_ = 0, targets_ = 0, rows_ = 0, stride_ = 0;
+
+        std::size_t                        epoch_ = 0, batches_ = 0;
+        std::vector<std::size_t>           blocks_;        // orden de los bloques en la época
+        std::vector<std::size_t>           window_start_;  // posición inicial de cada ventana
+
+        std::vector<Slot>                  slots_;
+        std::vector<std::thread>           workers_;
+        mutable std::mutex                 mutex_;
+        std::condition_variable            cv_ready_, cv_space_;
+        std::size_t                        next_ = 0, consumed_ = 0;
+        bool                               stopping_ = false;
+        std::exception_ptr                 error_;
+        Stats                              stats_;
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                stopping_ = true;
+            }
+            cv_space_.notify_all();
+            for (auto& w : workers_) w.join();
+            workers_.clear();
+        }
+
+        void plan_epoch() {
+            const std::size_t nb = (rows_ + opt_.block_rows - 1) / opt_.block_rows;
+            blocks_.resize(nb);
+            std::iota(blocks_.begin(), blocks_.end(), std::size_t(0));
+            if (opt_.shuffle) {
+                std::mt19937_64 rng(mix(opt_.seed, epoch_, npos));
+                std::shuffle(blocks_.begin(), blocks_.end(), rng);
+            }
+            window_start_.assign(1, 0);
+            for (std::size_t b = 0; b < nb; b += opt_.window_blocks) {
+                std::size_t n = 0;
+                for (std::size_t i = b; i < std::min(nb, b + opt_.window_blocks); ++i) n += block_size(blocks_[i]);
+                window_start_.push_back(window_start_.back() + n);
+            }
+            batches_ = batches_per_epoch();
+        }
+
+        std::size_t block_size(std::size_t b) const noexcept {
+            return std::min(opt_.block_rows, rows_ - b * opt_.block_rows);
+        }
+
+        static std::uint64_t mix(std::uint64_t seed, std::uint64_t epoch, std::uint64_t window) noexcept {
+            std::uint64_t h = seed * 0x9E3779B97F4A7C15ull ^ (epoch + 0x632BE59BD9B4E019ull);
+            h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ull ^ window;
+            return (h ^ (h >> 29)) * 0x94D049BB133111EBull;
+        }
+
+        // Filas de la ventana w en el orden de la época (y pide su lectura)
+        void load_window(std::size_t w, WindowCache& cache) const {
+            cache.window = w;
+            cache.rows.clear();
+            const std::size_t first = w * opt_.window_blocks;
+            const std::size_t last  = std::min(blocks_.size(), first + opt_.window_blocks);
+            for (std::size_t i = first; i < last; ++i) {
+                const std::size_t b = blocks_[i], begin = b * opt_.block_rows, n = block_size(b);
+                file_->will_need(dataset_format::data_offset + begin * stride_, n * stride_);
+                for (std::size_t r = 0; r < n; ++r) cache.rows.push_back(begin + r);
+            }
+            if (opt_.shuffle) {
+                std::mt19937_64 rng(mix(opt_.seed, epoch_, w));
+                std::shuffle(cache.rows.begin(), cache.rows.end(), rng);
+            }
+        }
+
+        void fill(std::size_t seq, Batch<T>& batch, WindowCache& cache) const {
+            const std::size_t first = seq * opt_.batch_size;
+            const std::size_t count = std::min(opt_.batch_size, rows_ - first);
+            batch.X.reshape(count, features_);
+            batch.Y.reshape(count, targets_);
+            T* x = batch.X.data();
+            T* y = batch.Y.data();
+            std::size_t w = std::upper_bound(window_start_.begin(), window_start_.end(), first)
+                            - window_start_.begin() - 1;
+            for (std::size_t p = first; p < first + count; ++p, x += features_, y += targets_) {
+                while (p >= window_start_[w + 1]) ++w;
+                if (cache.window != w) load_window(w, cache);
+                const auto* rec = reinterpret_cast<const T*>(data_ + cache.rows[p - window_start_[w]] * stride_);
+                std::memcpy(x, rec, features_ * sizeof(T));
+                std::memcpy(y, rec + features_, targets_ * sizeof(T));
+            }
+        }
+
+        void worker_loop(std::size_t id) {
+            WindowCache cache;
+            try {
+                for (std::size_t seq = id; seq < batches_; seq += opt_.workers) {
+                    Slot* slot;
+                    {
+                        std::unique_lock<std::mutex> lk(mutex_);
+                        cv_space_.wait(lk, [&] { return stopping_ || seq < consumed_ + slots_.size(); });
+                        if (stopping_) return;
+                        slot = &slots_[seq % slots_.size()];
+                    }
+                    // El hueco es de esta hebra hasta publicar seq
+                    fill(seq, slot->batch, cache);
+                    {
+                        std::lock_guard<std::mutex> lk(mutex_);
+                        slot->seq = seq;
+                    }
+                    cv_ready_.notify_all();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(mutex_);
+                if (!error_) error_ = std::current_exception();
+                cv_ready_.notify_all();
+            }
+        }
+    };
+
+}
+
+#endif //EPIC1_OFICIAL_NN_DATASET_H
@@ -7,8 +7,16 @@
 
 #include "nn_interfaces (4).h"
 #include "tensor (8).h"
+#include "tensor_sparse.h"
+#include "tensor_reduce.h"
 #include "nn_optimizer (5).h"
+#include "nn_activation (3).h"
+#include <algorithm>
+#include <cstdint>
 #include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
 template<typename T, std::size_t Rank>
@@ -16,46 +24,377 @@ using Tensor = utec::algebra::Tensor<T,Rank>;
 
 namespace utec::neural_network {
 
+    template<typename T>
+    struct IdentityOp {
+        static constexpr const char* name = "";
+        static T apply(T z) noexcept { return z; }
+        static T derivative(T) noexcept { return T(1); }
+        static void forward(const T*, T*, size_t) noexcept {}
+    };
+
+    // Epílogo del GEMM: z = act(x·W + b) sobre cada tile de salida
+    // (suma del bias y luego el kernel vectorizado de la activación in situ)
+    template<typename T, typename Act>
+    struct BiasActEpilogue {
+        const T* bias;
+        void operator()(size_t, size_t col, T* z, size_t n) const noexcept {
+            const T* b = bias + col;
+            for (size_t j = 0; j < n; ++j) z[j] += b[j];
+            Act::forward(z, z, n);
+        }
+    };
+
+    namespace detail {
+        template<typename T>
+        void check_dense_parameters(const Parameter<T>& w, const Parameter<T>& b) {
+            if (b.shape()[0] != 1 || b.shape()[1] != w.shape()[1])
+                throw std::invalid_argument("Bias shape must be 1 x out_features");
+        }
+
+        // grad_b = suma por columnas de dZ (rows x out)
+        template<typename T>
+        void bias_grad(const T* dz, size_t rows, size_t out, T* gb) {
+            utec::algebra::detail::column_sums(dz, rows, out, out, gb);
+        }
+
+        // Backward de Dense(+Act) con la entrada x y la salida y guardadas
+        // en los buffers del plan de NeuralNetwork::compile: dz = g ⊙ act'(y)
+        // se escribe sobre g y dx solo se calcula si se pide
+        template<typename T, typename Act>
+        void dense_backward_planned(const Tensor<T,2>& x, const Tensor<T,2>& y, Tensor<T,2>& g,
+                                    Parameter<T>& w, Parameter<T>& b, Tensor<T,2>* dx) {
+            if constexpr (!std::is_same_v<Act, IdentityOp<T>>)
+                Act::backward(g.data(), y.data(), g.data(), g.size());
+            matrix_product_into(x.view().transpose_2d(), g.view(), w.grad());
+            bias_grad(g.data(), g.shape()[0], g.shape()[1], b.grad().data());
+            if (dx) matrix_product_into(g.view(), w.value().transpose_2d(), *dx);
+        }
+
+        // Estado de la ruta dispersa de una Dense: la entrada CSR del último
+        // forward y las filas de grad W que escribió el último backward
+        // disperso. Solo esas filas se ponen a cero en el siguiente, así que
+        // el coste de grad W sigue a los no-ceros y no a in_features.
+        template<typename T>
+        struct SparseInputCache {
+            utec::algebra::CsrMatrix<T> input;
+            std::vector<std::uint32_t>  touched;
+            std::vector<unsigned char>  mark;
+            bool                        grad_dense = true;   // grad W escrito entero (ruta densa)
+
+            void weight_grad(const Tensor<T,2>& dz, utec::algebra::TensorView<T,2> gw) {
+                const size_t in = gw.shape()[0], out = gw.shape()[1];
+                T* g = gw.data();
+                if (grad_dense) {
+                    std::fill(g, g + in * out, T(0));
+                    grad_dense = false;
+                } else {
+                    for (auto r : touched) std::fill(g + r * out, g + (r + 1) * out, T(0));
+                }
+                mark.resize(in);
+                touched.clear();
+                for (auto c : input.col_idx())
+                    if (!mark[c]) { mark[c] = 1; touched.push_back(c); }
+                for (auto c : touched) mark[c] = 0;
+                utec::algebra::spmm_tn_accumulate(input, dz.view(), g);
+            }
+        };
+    }
+
     template<typename T>
     class Dense final : public ILayer<T> {
         size_t in_f_, out_f_;
-        Tensor<T,2> weights_, bias_;
+        Parameter<T> weights_, bias_;
         Tensor<T,2> last_input_;
-        Tensor<T,2> grad_w_, grad_b_;
+        detail::SparseInputCache<T> sparse_;
+
+        void check_input(size_t features) const {
+            if (features != in_f_)
+                throw std::invalid_argument(std::string(name()) + " expects " + std::to_string(in_f_) +
+                                            " input features, got " + std::to_string(features));
+        }
     public:
         template<typename InitWFun, typename InitBFun>
         Dense(size_t in_f, size_t out_f, InitWFun init_w_fun, InitBFun init_b_fun)
-                : in_f_(in_f), out_f_(out_f), weights_(in_f,out_f), bias_(1,out_f) {
-            init_w_fun(weights_);
-            init_b_fun(bias_);
+                : in_f_(in_f), out_f_(out_f),
+                  weights_(make_parameter<T>(in_f, out_f, init_w_fun)),
+                  bias_(make_parameter<T>(1, out_f, init_b_fun)) {}
+
+        // Toma parámetros ya construidos (p. ej. los de un modelo cargado)
+        Dense(Parameter<T> weights, Parameter<T> bias)
+                : in_f_(weights.shape()[0]), out_f_(weights.shape()[1]),
+                  weights_(std::move(weights)), bias_(std::move(bias)) {
+            detail::check_dense_parameters(weights_, bias_);
         }
 
         Tensor<T,2> forward(const Tensor<T,2>& x) override {
-            last_input_ = x;
-            auto z = matrix_product(x, weights_);
-            for (size_t i = 0; i < z.shape()[0]; ++i)
-                for (size_t j = 0; j < z.shape()[1]; ++j)
-                    z(i,j) += bias_(0,j);
+            Tensor<T,2> z;
+            forward_into(x, z);
             return z;
         }
 
+        void forward_into(const Tensor<T,2>& x, Tensor<T,2>& z) override {
+            last_input_ = x;
+            infer_into(x, z);
+        }
+
+        void infer_into(const Tensor<T,2>& x, Tensor<T,2>& z) const override {
+            matrix_product_into(x.view(), weights_.value(), z,
+                                BiasActEpilogue<T, IdentityOp<T>>{bias_.value().data()});
+        }
+
         Tensor<T,2> backward(const Tensor<T,2>& dZ) override {
-            auto xT = last_input_.transpose_2d();
-            grad_w_ = matrix_product(xT, dZ);
-            grad_b_ = Tensor<T,2>(1, out_f_);
-            grad_b_.fill(T(0));
-            for (size_t i = 0; i < dZ.shape()[0]; ++i)
-                for (size_t j = 0; j < dZ.shape()[1]; ++j)
-                    grad_b_(0,j) += dZ(i,j);
-            return matrix_product(dZ, weights_.transpose_2d());
+            Tensor<T,2> dX;
+            backward_into(dZ, dX);
+            return dX;
+        }
+
+        void backward_into(const Tensor<T,2>& dZ, Tensor<T,2>& dX) override {
+            matrix_product_into(last_input_.view().transpose_2d(), dZ.view(), weights_.grad());
+            sparse_.grad_dense = true;
+            detail::bias_grad(dZ.data(), dZ.shape()[0], out_f_, bias_.grad().data());
+            matrix_product_into(dZ.view(), weights_.value().transpose_2d(), dX);
+        }
+
+        // Ejecución planificada (NeuralNetwork::compile): sin llamadas
+        // virtuales ni cachés propias; Act es la activación que el plan
+        // fusiona en el epílogo cuando la capa siguiente es ReLU/Sigmoid/Tanh
+        template<typename Act = IdentityOp<T>>
+        void forward_planned(const Tensor<T,2>& x, Tensor<T,2>& y) const {
+            matrix_product_into(x.view(), weights_.value(), y, BiasActEpilogue<T, Act>{bias_.value().data()});
+        }
+
+        template<typename Act = IdentityOp<T>>
+        void backward_planned(const Tensor<T,2>& x, const Tensor<T,2>& y, Tensor<T,2>& g, Tensor<T,2>* dx) {
+            detail::dense_backward_planned<T, Act>(x, y, g, weights_, bias_, dx);
+            sparse_.grad_dense = true;
+        }
+
+        // SpMM: cada fila de z suma solo las filas de W de sus no-ceros
+        void forward_sparse_into(const utec::algebra::CsrMatrix<T>& x, Tensor<T,2>& z) override {
+            sparse_.input = x;
+            infer_sparse_into(x, z);
+        }
+
+        void infer_sparse_into(const utec::algebra::CsrMatrix<T>& x, Tensor<T,2>& z) const override {
+            utec::algebra::spmm_into(x, weights_.value(), z, BiasActEpilogue<T, IdentityOp<T>>{bias_.value().data()});
+        }
+
+        // grad W = Xᵀ·dZ tocando solo las filas de W activas en el lote
+        void backward_sparse(const Tensor<T,2>& dZ) override {
+            sparse_.weight_grad(dZ, weights_.grad());
+            detail::bias_grad(dZ.data(), dZ.shape()[0], out_f_, bias_.grad().data());
+        }
+
+        void update_params(IOptimizer<T>& optimizer) override {
+            optimizer.update(weights_.value(), weights_.grad());
+            optimizer.update(bias_.value(), bias_.grad());
+        }
+
+        void parameters(std::vector<Parameter<T>*>& out) override {
+            out.push_back(&weights_);
+            out.push_back(&bias_);
+        }
+
+        size_t parameter_bytes() const noexcept override {
+            return (weights_.size() + bias_.size()) * sizeof(T);
+        }
+
+        size_t output_features(size_t input_features) const override {
+            check_input(input_features);
+            return out_f_;
+        }
+
+        size_t cache_bytes() const noexcept override {
+            return last_input_.size() * sizeof(T) + sparse_.input.bytes();
+        }
+        void release_cache() override {
+            last_input_ = Tensor<T,2>();
+            sparse_.input = utec::algebra::CsrMatrix<T>();
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<Dense<T>>(Parameter<T>(Tensor<T,2>(weights_.value())),
+                                              Parameter<T>(Tensor<T,2>(bias_.value())));
+        }
+
+        const char* name() const noexcept override { return "Dense"; }
+        double flops(size_t rows, size_t, Phase phase) const noexcept override {
+            const double mm = 2.0 * double(rows) * double(in_f_) * double(out_f_);
+            return (phase == Phase::backward ? 2 * mm : mm) + double(rows) * double(out_f_);
+        }
+
+        size_t in_features() const noexcept { return in_f_; }
+        size_t out_features() const noexcept { return out_f_; }
+        utec::algebra::TensorView<T,2> weights() noexcept { return weights_.value(); }
+        utec::algebra::TensorView<const T,2> weights() const noexcept { return weights_.value(); }
+        utec::algebra::TensorView<T,2> bias() noexcept { return bias_.value(); }
+        utec::algebra::TensorView<const T,2> bias() const noexcept { return bias_.value(); }
+    };
+
+    // Dense seguida de una activación en una sola capa: bias y activación se
+    // aplican en el epílogo del GEMM, y en backward la derivada de la
+    // activación se fusiona con la reducción por columnas del gradiente del bias.
+    template<typename T, typename Act>
+    class FusedDense final : public ILayer<T> {
+        size_t in_f_, out_f_;
+        Parameter<T> weights_, bias_;
+        Tensor<T,2> last_input_, last_out_, dz_;
+        const Tensor<T,2>* out_ = nullptr;   // salida del último forward (para backward)
+        detail::SparseInputCache<T> sparse_;
+
+        void check_input(size_t features) const {
+            if (features != in_f_)
+                throw std::invalid_argument(std::string(name()) + " expects " + std::to_string(in_f_) +
+                                            " input features, got " + std::to_string(features));
+        }
+
+        // dz = g ⊙ act'(y) fusionado con la suma por columnas de grad_b
+        void activation_grad(const Tensor<T,2>& g) {
+            const size_t rows = g.shape()[0];
+            dz_.reshape(rows, out_f_);
+            T* gb = bias_.grad().data();
+            std::fill(gb, gb + out_f_, T(0));
+            const T* gp = g.data();
+            const T* yp = out_->data();
+            T* dz = dz_.data();
+            for (size_t i = 0; i < rows; ++i, gp += out_f_, yp += out_f_, dz += out_f_) {
+                Act::backward(gp, yp, dz, out_f_);
+                utec::algebra::detail::accumulate_rows(dz, 1, out_f_, out_f_, gb);
+            }
+        }
+    public:
+        template<typename InitWFun, typename InitBFun>
+        FusedDense(size_t in_f, size_t out_f, InitWFun init_w_fun, InitBFun init_b_fun)
+                : in_f_(in_f), out_f_(out_f),
+                  weights_(make_parameter<T>(in_f, out_f, init_w_fun)),
+                  bias_(make_parameter<T>(1, out_f, init_b_fun)) {}
+
+        // Toma los parámetros de una Dense existente (ver NeuralNetwork::fuse_layers)
+        FusedDense(Tensor<T,2> weights, Tensor<T,2> bias)
+                : in_f_(weights.shape()[0]), out_f_(weights.shape()[1]),
+                  weights_(Parameter<T>(std::move(weights))), bias_(Parameter<T>(std::move(bias))) {
+            detail::check_dense_parameters(weights_, bias_);
+        }
+        FusedDense(Parameter<T> weights, Parameter<T> bias)
+                : in_f_(weights.shape()[0]), out_f_(weights.shape()[1]),
+                  weights_(std::move(weights)), bias_(std::move(bias)) {
+            detail::check_dense_parameters(weights_, bias_);
+        }
+
+        // Por valor: la salida queda en la capa hasta backward y se devuelve una copia
+        Tensor<T,2> forward(const Tensor<T,2>& x) override {
+            forward_into(x, last_out_);
+            return last_out_;
+        }
+
+        // Sin copia de la salida: backward lee y, que el llamador mantiene
+        // intacta hasta entonces (ver ILayer::forward_into)
+        void forward_into(const Tensor<T,2>& x, Tensor<T,2>& y) override {
+            last_input_ = x;
+            infer_into(x, y);
+            out_ = &y;
+        }
+
+        void infer_into(const Tensor<T,2>& x, Tensor<T,2>& y) const override {
+            matrix_product_into(x.view(), weights_.value(), y,
+                                BiasActEpilogue<T, Act>{bias_.value().data()});
+        }
+
+        Tensor<T,2> backward(const Tensor<T,2>& g) override {
+            Tensor<T,2> dX;
+            backward_into(g, dX);
+            return dX;
+        }
+
+        void backward_into(const Tensor<T,2>& g, Tensor<T,2>& dX) override {
+            activation_grad(g);
+            matrix_product_into(last_input_.view().transpose_2d(), dz_.view(), weights_.grad());
+            sparse_.grad_dense = true;
+            matrix_product_into(dz_.view(), weights_.value().transpose_2d(), dX);
+        }
+
+        void forward_planned(const Tensor<T,2>& x, Tensor<T,2>& y) const { infer_into(x, y); }
+
+        void backward_planned(const Tensor<T,2>& x, const Tensor<T,2>& y, Tensor<T,2>& g, Tensor<T,2>* dx) {
+            detail::dense_backward_planned<T, Act>(x, y, g, weights_, bias_, dx);
+            sparse_.grad_dense = true;
+        }
+
+        void forward_sparse_into(const utec::algebra::CsrMatrix<T>& x, Tensor<T,2>& y) override {
+            sparse_.input = x;
+            infer_sparse_into(x, y);
+            out_ = &y;
+        }
+
+        void infer_sparse_into(const utec::algebra::CsrMatrix<T>& x, Tensor<T,2>& y) const override {
+            utec::algebra::spmm_into(x, weights_.value(), y, BiasActEpilogue<T, Act>{bias_.value().data()});
+        }
+
+        void backward_sparse(const Tensor<T,2>& g) override {
+            activation_grad(g);
+            sparse_.weight_grad(dz_, weights_.grad());
         }
 
         void update_params(IOptimizer<T>& optimizer) override {
-            optimizer.update(weights_, grad_w_);
-            optimizer.update(bias_, grad_b_);
+            optimizer.update(weights_.value(), weights_.grad());
+            optimizer.update(bias_.value(), bias_.grad());
+        }
+
+        void parameters(std::vector<Parameter<T>*>& out) override {
+            out.push_back(&weights_);
+            out.push_back(&bias_);
+        }
+
+        size_t parameter_bytes() const noexcept override {
+            return (weights_.size() + bias_.size()) * sizeof(T);
+        }
+
+        size_t output_features(size_t input_features) const override {
+            check_input(input_features);
+            return out_f_;
         }
+
+        // La salida de forward_into es del llamador: no cuenta como caché
+        size_t cache_bytes() const noexcept override {
+            return (last_input_.size() + last_out_.size() + dz_.size()) * sizeof(T) + sparse_.input.bytes();
+        }
+        void release_cache() override {
+            last_input_ = Tensor<T,2>();
+            last_out_ = Tensor<T,2>();
+            dz_ = Tensor<T,2>();
+            out_ = nullptr;
+            sparse_.input = utec::algebra::CsrMatrix<T>();
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<FusedDense<T, Act>>(Parameter<T>(Tensor<T,2>(weights_.value())),
+                                                        Parameter<T>(Tensor<T,2>(bias_.value())));
+        }
+
+        const char* name() const noexcept override {
+            static const std::string n = std::string("Dense") + Act::name;
+            return n.c_str();
+        }
+        double flops(size_t rows, size_t, Phase phase) const noexcept override {
+            const double mm = 2.0 * double(rows) * double(in_f_) * double(out_f_);
+            return (phase == Phase::backward ? 2 * mm : mm) + 2.0 * double(rows) * double(out_f_);
+        }
+
+        size_t in_features() const noexcept { return in_f_; }
+        size_t out_features() const noexcept { return out_f_; }
+        utec::algebra::TensorView<T,2> weights() noexcept { return weights_.value(); }
+        utec::algebra::TensorView<const T,2> weights() const noexcept { return weights_.value(); }
+        utec::algebra::TensorView<T,2> bias() noexcept { return bias_.value(); }
+        utec::algebra::TensorView<const T,2> bias() const noexcept { return bias_.value(); }
     };
 
+    template<typename T>
+    using DenseReLU = FusedDense<T, ReLUOp<T>>;
+    template<typename T>
+    using DenseSigmoid = FusedDense<T, SigmoidOp<T>>;
+    template<typename T>
+    using DenseTanh = FusedDense<T, TanhOp<T>>;
+
 }
 
 
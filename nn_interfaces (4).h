@@ -8,7 +8,12 @@
 
 #include <cstddef>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 #include "tensor (8).h"
+#include "tensor_sparse.h"
+#include "nn_parameters.h"
+#include "nn_profiler.h"
 
 namespace utec::neural_network {
 
@@ -23,8 +28,79 @@ namespace utec::neural_network {
         virtual ~ILayer() = default;
         virtual utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>& input) = 0;
         virtual utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>& grad_output) = 0;
+        // Variantes que escriben en un buffer del llamador; las capas propias las
+        // sobrescriben para reutilizar memoria entre pasos (sin reservas en régimen).
+        // El llamador mantiene output intacto hasta el backward_into del mismo
+        // paso: una capa puede leerlo ahí en lugar de guardar una copia
+        virtual void forward_into(const utec::algebra::Tensor<T,2>& input,
+                                  utec::algebra::Tensor<T,2>& output) {
+            output = forward(input);
+        }
+        virtual void backward_into(const utec::algebra::Tensor<T,2>& grad_output,
+                                   utec::algebra::Tensor<T,2>& grad_input) {
+            grad_input = backward(grad_output);
+        }
+        // Inferencia sin estado: no escribe cachés de entrenamiento, así que
+        // varias hebras pueden compartir la misma capa
+        virtual void infer_into(const utec::algebra::Tensor<T,2>& input,
+                                utec::algebra::Tensor<T,2>& output) const {
+            (void)input; (void)output;
+            throw std::logic_error("This layer does not implement const inference");
+        }
+        utec::algebra::Tensor<T,2> infer(const utec::algebra::Tensor<T,2>& input) const {
+            utec::algebra::Tensor<T,2> output;
+            infer_into(input, output);
+            return output;
+        }
+        // Entrada dispersa (CSR) para la primera capa de la red. El backward
+        // solo calcula los gradientes de los parámetros: no hay gradiente
+        // que propagar hacia una entrada que no se entrena. output sigue el
+        // mismo contrato que en forward_into
+        virtual void forward_sparse_into(const utec::algebra::CsrMatrix<T>& input,
+                                         utec::algebra::Tensor<T,2>& output) {
+            (void)input; (void)output;
+            throw std::logic_error("This layer does not accept sparse input");
+        }
+        virtual void infer_sparse_into(const utec::algebra::CsrMatrix<T>& input,
+                                       utec::algebra::Tensor<T,2>& output) const {
+            (void)input; (void)output;
+            throw std::logic_error("This layer does not accept sparse input");
+        }
+        virtual void backward_sparse(const utec::algebra::Tensor<T,2>& grad_output) {
+            (void)grad_output;
+            throw std::logic_error("This layer does not accept sparse input");
+        }
         // Now that IOptimizer is forward‐declared, this compiles
-        virtual void update_params(IOptimizer<T>& optimizer) {}
+        virtual void update_params(IOptimizer<T>& optimizer) { (void)optimizer; }
+        // Registra los parámetros entrenables (para la arena de NeuralNetwork)
+        virtual void parameters(std::vector<Parameter<T>*>& out) { (void)out; }
+        // Bytes que ocupan los parámetros del modelo (pesos, bias, escalas)
+        virtual std::size_t parameter_bytes() const noexcept { return 0; }
+        // Bytes de las cachés que forward guarda para backward, y su
+        // liberación (checkpointing de activaciones en NeuralNetwork)
+        virtual std::size_t cache_bytes() const noexcept { return 0; }
+        virtual void release_cache() {}
+        // Columnas de la salida para una entrada de input_features columnas
+        // (inferencia de formas de NeuralNetwork::compile); por defecto se
+        // averigua con una inferencia de una fila de ceros
+        virtual std::size_t output_features(std::size_t input_features) const {
+            utec::algebra::Tensor<T,2> x(1, input_features), y;
+            x.fill(T(0));
+            infer_into(x, y);
+            return y.shape()[1];
+        }
+        // Nombre y FLOPs nominales para el perfilador; rows x cols es el tensor
+        // que recibe la fase (entrada en forward/infer, gradiente en backward)
+        virtual const char* name() const noexcept { return "Layer"; }
+        virtual double flops(std::size_t rows, std::size_t cols, Phase phase) const noexcept {
+            (void)phase;
+            return double(rows) * double(cols);
+        }
+        // Copia independiente (mismos valores de parámetros, cachés propias)
+        // para entrenar réplicas en paralelo
+        virtual std::unique_ptr<ILayer<T>> clone() const {
+            throw std::logic_error("This layer does not support clone()");
+        }
     };
 
 
@@ -34,6 +110,14 @@ namespace utec::neural_network {
         virtual ~ILoss() = default;
         virtual T loss() const = 0;
         virtual utec::algebra::Tensor<T,2> loss_gradient() const = 0;
+        virtual void loss_gradient_into(utec::algebra::Tensor<T,2>& grad) const {
+            grad = loss_gradient();
+        }
+        // Valor y gradiente en una sola pasada sobre un buffer del llamador
+        virtual T loss_and_gradient_into(utec::algebra::Tensor<T,2>& grad) const {
+            loss_gradient_into(grad);
+            return loss();
+        }
     };
 
 
@@ -41,8 +125,15 @@ namespace utec::neural_network {
     class IOptimizer {
     public:
         virtual ~IOptimizer() = default;
-        virtual void update(utec::algebra::Tensor<T,2>& params,
-                            const utec::algebra::Tensor<T,2>& grads) = 0;
+        // Un Tensor<T,2> se convierte implícitamente en vista
+        virtual void update(utec::algebra::TensorView<T,2> params,
+                            utec::algebra::TensorView<const T,2> grads) = 0;
+        // Paso fusionado sobre buffers planos (ParameterArena); por defecto
+        // delega en update() tratándolos como una fila 1 x n
+        virtual void step(T* params, const T* grads, std::size_t n) {
+            update(utec::algebra::TensorView<T,2>(params, {1, n}, {n, 1}),
+                   utec::algebra::TensorView<const T,2>(grads, {1, n}, {n, 1}));
+        }
     };
 
 }
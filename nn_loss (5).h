@@ -7,71 +7,291 @@
 
 #pragma once
 #include "nn_interfaces (4).h"
+#include "tensor_simd.h"
+#include "tensor_reduce.h"
+#include "thread_pool.h"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <vector>
 
 namespace utec::neural_network {
 
+    namespace detail {
+        using utec::algebra::detail::simd_reduce;
+        using utec::algebra::detail::vexp;
+        using utec::algebra::detail::vlog;
+        using utec::algebra::detail::use_libm;
+        using utec::algebra::detail::simd_for;
+    }
 
+    // Base de las pérdidas elemento a elemento: guarda vistas (no copia las
+    // predicciones ni los objetivos, que deben seguir vivos) y valida formas.
+    // Cada pérdida calcula valor y gradiente en una sola pasada vectorizada.
     template<typename T>
-    class MSELoss final : public ILoss<T,2> {
-        utec::algebra::Tensor<T,2> y_pred_, y_true_;
-    public:
-        MSELoss(const utec::algebra::Tensor<T,2>& y_pred,
-                const utec::algebra::Tensor<T,2>& y_true)
-                : y_pred_(y_pred), y_true_(y_true) {}
+    class PointwiseLoss : public ILoss<T,2> {
+    protected:
+        utec::algebra::TensorView<const T,2> y_pred_, y_true_;
 
-        T loss() const override {
-            T sum = T(0);
-            auto it_p = y_pred_.cbegin(), it_t = y_true_.cbegin();
-            while (it_p != y_pred_.cend()) {
-                T diff = *it_p++ - *it_t++;
-                sum += diff * diff;
-            }
-            return sum / static_cast<T>(y_pred_.shape()[0] * y_pred_.shape()[1]);
+        PointwiseLoss(utec::algebra::TensorView<const T,2> y_pred,
+                      utec::algebra::TensorView<const T,2> y_true)
+                : y_pred_(y_pred), y_true_(y_true) {
+            if (y_pred_.shape() != y_true_.shape())
+                throw std::invalid_argument("Prediction and target shapes do not match");
+            if (!y_pred_.is_contiguous() || !y_true_.is_contiguous())
+                throw std::invalid_argument("Loss inputs must be contiguous");
         }
 
+        std::size_t count() const noexcept { return y_pred_.size(); }
+    public:
         utec::algebra::Tensor<T,2> loss_gradient() const override {
-            auto grad = y_pred_;
-            auto it_p = y_pred_.cbegin(), it_t = y_true_.cbegin(), it_g = grad.begin();
-            T scale = T(2) / static_cast<T>(y_pred_.shape()[0] * y_pred_.shape()[1]);
-            while (it_p != y_pred_.cend()) {
-                *it_g++ = (*it_p++ - *it_t++) * scale;
-            }
+            utec::algebra::Tensor<T,2> grad;
+            this->loss_gradient_into(grad);
             return grad;
         }
     };
 
 
     template<typename T>
-    class BCELoss final : public ILoss<T,2> {
-        utec::algebra::Tensor<T,2> y_pred_, y_true_;
+    class MSELoss final : public PointwiseLoss<T> {
+        template<bool Grad>
+        T run(T* grad) const {
+            const T* p = this->y_pred_.data();
+            const T* y = this->y_true_.data();
+            const T scale = T(2) / static_cast<T>(this->count());
+            T sum = detail::simd_reduce<T>(this->count(), [&](auto v, std::size_t i) {
+                using V = decltype(v);
+                auto d = V::sub(V::load(p + i), V::load(y + i));
+                if constexpr (Grad) V::store(grad + i, V::mul(d, V::set1(scale)));
+                return V::mul(d, d);
+            });
+            return sum / static_cast<T>(this->count());
+        }
     public:
+        MSELoss(utec::algebra::TensorView<const T,2> y_pred,
+                utec::algebra::TensorView<const T,2> y_true)
+                : PointwiseLoss<T>(y_pred, y_true) {}
+        MSELoss(utec::algebra::Tensor<T,2>&&, utec::algebra::TensorView<const T,2>) = delete;
+        MSELoss(utec::algebra::TensorView<const T,2>, utec::algebra::Tensor<T,2>&&) = delete;
+
+        T loss() const override { return run<false>(nullptr); }
+
+        void loss_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            run<true>(grad.data());
+        }
+
+        T loss_and_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            return run<true>(grad.data());
+        }
+    };
 
-        BCELoss(const utec::algebra::Tensor<T,2>& y_pred,
-                const utec::algebra::Tensor<T,2>& y_true)
-                : y_pred_(y_pred), y_true_(y_true) {}
 
-        T loss() const override {
+    template<typename T>
+    class BCELoss final : public PointwiseLoss<T> {
+        static constexpr T eps = T(1e-12);
+
+        template<bool Grad>
+        T run(T* grad) const {
+            const T* p = this->y_pred_.data();
+            const T* y = this->y_true_.data();
+            const std::size_t n = this->count();
+            const T inv_n = T(1) / static_cast<T>(n);
             T sum = T(0);
-            auto it_p = y_pred_.cbegin(), it_t = y_true_.cbegin();
-            while (it_p != y_pred_.cend()) {
-                T p = *it_p++;
-                T y = *it_t++;
-                sum += - (y * std::log(p + T(1e-12)) + (T(1)-y) * std::log(T(1)-p + T(1e-12)));
+            if (detail::use_libm<T>()) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += -(y[i] * std::log(p[i] + eps) + (T(1)-y[i]) * std::log(T(1)-p[i] + eps));
+                    if constexpr (Grad)
+                        grad[i] = inv_n * (-(y[i] / (p[i] + eps)) + ((T(1)-y[i]) / (T(1)-p[i] + eps)));
+                }
+            } else {
+                sum = detail::simd_reduce<T>(n, [&](auto v, std::size_t i) {
+                    using V = decltype(v);
+                    auto pi = V::load(p + i), yi = V::load(y + i);
+                    auto one = V::set1(T(1));
+                    auto a = V::add(pi, V::set1(eps));
+                    auto b = V::add(V::sub(one, pi), V::set1(eps));
+                    auto ny = V::sub(one, yi);
+                    // (1-y)/b - y/a con una sola división
+                    if constexpr (Grad)
+                        V::store(grad + i, V::div(V::mul(V::set1(inv_n),
+                                                         V::sub(V::mul(ny, a), V::mul(yi, b))),
+                                                  V::mul(a, b)));
+                    auto l = V::fmadd(yi, detail::vlog<V, T>(a), V::mul(ny, detail::vlog<V, T>(b)));
+                    return V::sub(V::zero(), l);
+                });
             }
-            return sum / static_cast<T>(y_pred_.shape()[0] * y_pred_.shape()[1]);
+            return sum / static_cast<T>(n);
         }
+    public:
+        BCELoss(utec::algebra::TensorView<const T,2> y_pred,
+                utec::algebra::TensorView<const T,2> y_true)
+                : PointwiseLoss<T>(y_pred, y_true) {}
+        BCELoss(utec::algebra::Tensor<T,2>&&, utec::algebra::TensorView<const T,2>) = delete;
+        BCELoss(utec::algebra::TensorView<const T,2>, utec::algebra::Tensor<T,2>&&) = delete;
 
-        utec::algebra::Tensor<T,2> loss_gradient() const override {
-            auto grad = y_pred_;
-            auto it_p = y_pred_.cbegin(), it_t = y_true_.cbegin(), it_g = grad.begin();
-            T inv_n = T(1) / static_cast<T>(y_pred_.shape()[0] * y_pred_.shape()[1]);
-            while (it_p != y_pred_.cend()) {
-                T p = *it_p++;
-                T y = *it_t++;
-                *it_g++ = inv_n * (-(y / (p + T(1e-12))) + ((T(1)-y) / (T(1)-p + T(1e-12))));
+        T loss() const override { return run<false>(nullptr); }
+
+        void loss_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            run<true>(grad.data());
+        }
+
+        T loss_and_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            return run<true>(grad.data());
+        }
+    };
+
+
+    // BCE sobre logits z (la red termina sin Sigmoid): la sigmoide se fusiona
+    // con la pérdida. Forma estable sin recorte:
+    //   l = max(z,0) - z·y + log(1 + e^{-|z|}),   dl/dz = sigmoid(z) - y
+    template<typename T>
+    class BCEWithLogitsLoss final : public PointwiseLoss<T> {
+        template<bool Grad>
+        T run(T* grad) const {
+            const T* z = this->y_pred_.data();
+            const T* y = this->y_true_.data();
+            const std::size_t n = this->count();
+            const T inv_n = T(1) / static_cast<T>(n);
+            T sum = T(0);
+            if (detail::use_libm<T>()) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    T e = std::exp(-std::abs(z[i]));
+                    sum += std::max(z[i], T(0)) - z[i] * y[i] + std::log1p(e);
+                    if constexpr (Grad) {
+                        T s = z[i] > T(0) ? T(1) / (T(1) + e) : e / (T(1) + e);
+                        grad[i] = inv_n * (s - y[i]);
+                    }
+                }
+            } else {
+                sum = detail::simd_reduce<T>(n, [&](auto v, std::size_t i) {
+                    using V = decltype(v);
+                    auto zi = V::load(z + i), yi = V::load(y + i);
+                    auto one = V::set1(T(1));
+                    auto e  = detail::vexp<V, T>(V::min(zi, V::sub(V::zero(), zi)));  // e^{-|z|}
+                    auto de = V::add(one, e);
+                    if constexpr (Grad) {
+                        auto r = V::div(one, de);
+                        auto s = V::select_gt0(zi, r, V::mul(e, r));
+                        V::store(grad + i, V::mul(V::set1(inv_n), V::sub(s, yi)));
+                    }
+                    auto l = V::sub(V::max(zi, V::zero()), V::mul(zi, yi));
+                    return V::add(l, detail::vlog<V, T>(de));
+                });
             }
-            return grad;
+            return sum / static_cast<T>(n);
+        }
+    public:
+        BCEWithLogitsLoss(utec::algebra::TensorView<const T,2> logits,
+                          utec::algebra::TensorView<const T,2> y_true)
+                : PointwiseLoss<T>(logits, y_true) {}
+        BCEWithLogitsLoss(utec::algebra::Tensor<T,2>&&, utec::algebra::TensorView<const T,2>) = delete;
+        BCEWithLogitsLoss(utec::algebra::TensorView<const T,2>, utec::algebra::Tensor<T,2>&&) = delete;
+
+        T loss() const override { return run<false>(nullptr); }
+
+        void loss_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            run<true>(grad.data());
+        }
+
+        T loss_and_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            return run<true>(grad.data());
+        }
+    };
+
+    // Softmax + entropía cruzada sobre logits z (rows x clases; la red
+    // termina sin activación) y objetivos one-hot o probabilidades por fila.
+    // Por fila, con m = max(z) y lse = m + log Σ e^{z-m} (estable sin recorte):
+    //   l = Σ_j y_j·(lse - z_j),   dl/dz = (Σ_j y_j)·softmax(z) - y
+    // que con one-hot es softmax - y. La pérdida es la media por fila; cada
+    // fila se procesa entera (máximo, exponenciales, suma y gradiente)
+    // mientras está en caché, sin tensores intermedios.
+    template<typename T>
+    class SoftmaxCrossEntropyLoss final : public PointwiseLoss<T> {
+        // Pérdida de la fila r; con Grad escribe su gradiente (escalado por inv_rows)
+        template<bool Grad>
+        T row(std::size_t r, T* grad, T inv_rows) const {
+            const std::size_t c = this->y_pred_.shape()[1];
+            const T* z = this->y_pred_.data() + r * c;
+            const T* y = this->y_true_.data() + r * c;
+            T* g = Grad ? grad + r * c : nullptr;
+            const T m = utec::algebra::detail::row_max(z, c);
+            T s, sum_y, sum_yz;
+            if (detail::use_libm<T>()) {
+                s = sum_y = sum_yz = T(0);
+                for (std::size_t j = 0; j < c; ++j) {
+                    const T e = std::exp(z[j] - m);
+                    if constexpr (Grad) g[j] = e;
+                    s += e;
+                    sum_y += y[j];
+                    sum_yz += y[j] * z[j];
+                }
+            } else {
+                s = detail::simd_reduce<T>(c, [&](auto v, std::size_t j) {
+                    using V = decltype(v);
+                    auto e = detail::vexp<V, T>(V::sub(V::load(z + j), V::set1(m)));
+                    if constexpr (Grad) V::store(g + j, e);
+                    return e;
+                });
+                sum_y = utec::algebra::detail::row_sum(y, c);
+                sum_yz = detail::simd_reduce<T>(c, [&](auto v, std::size_t j) {
+                    using V = decltype(v);
+                    return V::mul(V::load(y + j), V::load(z + j));
+                });
+            }
+            const T lse = m + std::log(s);
+            if constexpr (Grad) {
+                const T a = sum_y / s * inv_rows;
+                detail::simd_for<T>(c, [&](auto v, std::size_t j) {
+                    using V = decltype(v);
+                    V::store(g + j, V::sub(V::mul(V::load(g + j), V::set1(a)),
+                                           V::mul(V::load(y + j), V::set1(inv_rows))));
+                });
+            }
+            return sum_y * lse - sum_yz;
+        }
+
+        template<bool Grad>
+        T run(T* grad) const {
+            const std::size_t rows = this->y_pred_.shape()[0], c = this->y_pred_.shape()[1];
+            if (rows == 0) return T(0);
+            const T inv_rows = T(1) / static_cast<T>(rows);
+            // Suma por bloques fijos de filas: mismo resultado con cualquier número de hebras
+            const std::size_t grain = std::max<std::size_t>(1, utec::algebra::detail::reduce_grain / std::max<std::size_t>(c, 1));
+            const std::size_t blocks = (rows + grain - 1) / grain;
+            std::vector<T> partial(blocks, T(0));
+            utec::algebra::default_thread_pool().parallel_for(blocks, [&](std::size_t b) {
+                T acc = T(0);
+                for (std::size_t r = b * grain, e = std::min(rows, r + grain); r < e; ++r)
+                    acc += row<Grad>(r, grad, inv_rows);
+                partial[b] = acc;
+            });
+            T sum = T(0);
+            for (T p : partial) sum += p;
+            return sum * inv_rows;
+        }
+    public:
+        SoftmaxCrossEntropyLoss(utec::algebra::TensorView<const T,2> logits,
+                                utec::algebra::TensorView<const T,2> y_true)
+                : PointwiseLoss<T>(logits, y_true) {}
+        SoftmaxCrossEntropyLoss(utec::algebra::Tensor<T,2>&&, utec::algebra::TensorView<const T,2>) = delete;
+        SoftmaxCrossEntropyLoss(utec::algebra::TensorView<const T,2>, utec::algebra::Tensor<T,2>&&) = delete;
+
+        T loss() const override { return run<false>(nullptr); }
+
+        void loss_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            run<true>(grad.data());
+        }
+
+        T loss_and_gradient_into(utec::algebra::Tensor<T,2>& grad) const override {
+            grad.reshape(this->y_pred_.shape());
+            return run<true>(grad.data());
         }
     };
 
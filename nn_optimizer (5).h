@@ -7,73 +7,106 @@
 #pragma once
 #include "nn_interfaces (4).h"
 #include <cmath>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace utec::neural_network {
 
+    namespace detail {
+        // Elementos por bloque en los pasos paralelos del optimizador
+        inline constexpr std::size_t optimizer_grain = std::size_t(1) << 15;
+
+        template<typename T>
+        void check_update_shapes(const utec::algebra::TensorView<T,2>& params,
+                                 const utec::algebra::TensorView<const T,2>& grads) {
+            if (params.shape() != grads.shape())
+                throw std::invalid_argument("Parameter and gradient shapes do not match");
+            if (!params.is_contiguous() || !grads.is_contiguous())
+                throw std::invalid_argument("Optimizer updates require contiguous tensors");
+        }
+    }
+
     template<typename T>
     class SGD final : public IOptimizer<T> {
         T lr_;
+        bool parallel_ = true;
     public:
         explicit SGD(T learning_rate = T(0.01)) : lr_(learning_rate) {}
-        void update(utec::algebra::Tensor<T,2>& params,
-                    const utec::algebra::Tensor<T,2>& grads) override {
-            auto it_p = params.begin();
-            auto it_g = grads.cbegin();
-            while (it_p != params.end() && it_g != grads.cend()) {
-                *it_p = *it_p - lr_ * (*it_g);
-                ++it_p;
-                ++it_g;
-            }
+
+        void set_parallel(bool enabled) noexcept { parallel_ = enabled; }
+
+        void update(utec::algebra::TensorView<T,2> params,
+                    utec::algebra::TensorView<const T,2> grads) override {
+            detail::check_update_shapes(params, grads);
+            step(params.data(), grads.data(), params.size());
+        }
+
+        void step(T* params, const T* grads, std::size_t n) override {
+            const T lr = lr_;
+            auto kernel = [=](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    params[i] -= lr * grads[i];
+            };
+            if (parallel_) utec::algebra::parallel_for_blocks(n, detail::optimizer_grain, kernel);
+            else kernel(0, n);
         }
     };
 
     template<typename T>
     class Adam final : public IOptimizer<T> {
+        // Momentos y contador de pasos de un bloque de parámetros
+        struct State {
+            utec::algebra::Tensor<T,1> m, v;
+            T beta1_pow = T(1), beta2_pow = T(1);
+        };
+
         T lr_, beta1_, beta2_, eps_;
-        std::size_t t_;
-        utec::algebra::Tensor<T,2> m_, v_;
-        bool initialized_;
+        bool parallel_ = true;
+        State flat_;                                   // step() sobre la arena
+        std::unordered_map<const T*, State> states_;   // update() por tensor
+
+        void run(State& st, T* params, const T* grads, std::size_t n) {
+            if (st.m.size() != n) {
+                st.m = utec::algebra::Tensor<T,1>(n);
+                st.v = utec::algebra::Tensor<T,1>(n);
+                st.m.fill(T(0));
+                st.v.fill(T(0));
+                st.beta1_pow = st.beta2_pow = T(1);
+            }
+            // Corrección de sesgo con potencias acumuladas (sin std::pow por paso)
+            st.beta1_pow *= beta1_;
+            st.beta2_pow *= beta2_;
+            const T step_size = lr_ / (T(1) - st.beta1_pow);
+            const T inv_bc2   = T(1) / (T(1) - st.beta2_pow);
+            const T b1 = beta1_, b2 = beta2_, eps = eps_;
+            T* m = st.m.data();
+            T* v = st.v.data();
+            auto kernel = [=](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    T g = grads[i];
+                    m[i] = b1 * m[i] + (T(1) - b1) * g;
+                    v[i] = b2 * v[i] + (T(1) - b2) * g * g;
+                    params[i] -= step_size * m[i] / (std::sqrt(v[i] * inv_bc2) + eps);
+                }
+            };
+            if (parallel_) utec::algebra::parallel_for_blocks(n, detail::optimizer_grain, kernel);
+            else kernel(0, n);
+        }
     public:
         explicit Adam(T learning_rate = T(0.001), T beta1 = T(0.9), T beta2 = T(0.999), T epsilon = T(1e-8))
-                : lr_(learning_rate), beta1_(beta1), beta2_(beta2), eps_(epsilon),
-                  t_(0), initialized_(false) {}
-
-        void update(utec::algebra::Tensor<T,2>& params,
-                    const utec::algebra::Tensor<T,2>& grads) override {
-            if (!initialized_) {
-                m_ = utec::algebra::Tensor<T,2>(params.shape());
-                v_ = utec::algebra::Tensor<T,2>(params.shape());
-                m_.fill(T(0));
-                v_.fill(T(0));
-                initialized_ = true;
-            }
-            ++t_;
-            // biased moment estimates
-            auto it_m = m_.begin();
-            auto it_v = v_.begin();
-            auto it_g = grads.cbegin();
-            while (it_g != grads.cend()) {
-                T g = *it_g;
-                *it_m = beta1_ * (*it_m) + (T(1) - beta1_) * g;
-                *it_v = beta2_ * (*it_v) + (T(1) - beta2_) * g * g;
-                ++it_m;
-                ++it_v;
-                ++it_g;
-            }
+                : lr_(learning_rate), beta1_(beta1), beta2_(beta2), eps_(epsilon) {}
 
-            T bc1 = T(1) - std::pow(beta1_, t_);
-            T bc2 = T(1) - std::pow(beta2_, t_);
-            auto it_p = params.begin();
-            it_m = m_.begin();
-            it_v = v_.begin();
-            while (it_p != params.end()) {
-                T m_hat = *it_m / bc1;
-                T v_hat = *it_v / bc2;
-                *it_p = *it_p - lr_ * m_hat / (std::sqrt(v_hat) + eps_);
-                ++it_p;
-                ++it_m;
-                ++it_v;
-            }
+        void set_parallel(bool enabled) noexcept { parallel_ = enabled; }
+
+        // Cada tensor (identificado por su buffer) tiene sus propios momentos
+        void update(utec::algebra::TensorView<T,2> params,
+                    utec::algebra::TensorView<const T,2> grads) override {
+            detail::check_update_shapes(params, grads);
+            run(states_[params.data()], params.data(), grads.data(), params.size());
+        }
+
+        void step(T* params, const T* grads, std::size_t n) override {
+            run(flat_, params, grads, n);
         }
     };
 
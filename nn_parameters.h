@@ -0,0 +1,145 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_PARAMETERS_H
+#define EPIC1_OFICIAL_NN_PARAMETERS_H
+
+#include "tensor (8).h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Parámetro entrenable (valor + gradiente). Empieza con almacenamiento
+    // propio (o sobre memoria externa, p. ej. un modelo mapeado) y puede
+    // reubicarse en una arena contigua con bind(); las capas solo lo usan a
+    // través de vistas.
+    template<typename T>
+    class Parameter {
+    public:
+        Parameter() = default;
+        Parameter(std::size_t rows, std::size_t cols)
+                : Parameter(utec::algebra::Tensor<T,2>(rows, cols)) {}
+        explicit Parameter(utec::algebra::Tensor<T,2> value)
+                : own_value_(std::move(value)), own_grad_(own_value_.shape()) {
+            own_grad_.fill(T(0));
+            value_ = own_value_.view();
+            grad_  = own_grad_.view();
+        }
+        // Valor en memoria externa, sin copia; owner la mantiene viva. El
+        // gradiente se reserva al primer acceso mutable (solo si se entrena).
+        Parameter(utec::algebra::TensorView<T,2> value, std::shared_ptr<const void> owner)
+                : value_(value), owner_(std::move(owner)) {}
+
+        // Mover conserva el buffer de los vectores, así que las vistas siguen válidas
+        Parameter(Parameter&&) noexcept = default;
+        Parameter& operator=(Parameter&&) noexcept = default;
+        Parameter(const Parameter&) = delete;
+        Parameter& operator=(const Parameter&) = delete;
+
+        utec::algebra::TensorView<T,2> value() noexcept { return value_; }
+        utec::algebra::TensorView<const T,2> value() const noexcept { return value_; }
+        utec::algebra::TensorView<T,2> grad() {
+            if (!grad_.data() && size() != 0) {
+                own_grad_ = utec::algebra::Tensor<T,2>(value_.shape());
+                own_grad_.fill(T(0));
+                grad_ = own_grad_.view();
+            }
+            return grad_;
+        }
+        utec::algebra::TensorView<const T,2> grad() const noexcept { return grad_; }
+
+        const std::array<std::size_t,2>& shape() const noexcept { return value_.shape(); }
+        std::size_t size() const noexcept { return value_.size(); }
+        // true si el valor vive en memoria externa (sin copiar a la arena)
+        bool is_external() const noexcept { return owner_ != nullptr; }
+
+        // Copia valor y gradiente al almacenamiento indicado y pasa a usarlo
+        void bind(T* value, T* grad) {
+            const std::size_t n = size();
+            std::memcpy(value, value_.data(), n * sizeof(T));
+            if (grad_.data()) std::memcpy(grad, grad_.data(), n * sizeof(T));
+            else std::fill(grad, grad + n, T(0));
+            auto st = value_.strides();
+            value_ = utec::algebra::TensorView<T,2>(value, value_.shape(), st);
+            grad_  = utec::algebra::TensorView<T,2>(grad, value_.shape(), st);
+            own_value_ = utec::algebra::Tensor<T,2>();
+            own_grad_  = utec::algebra::Tensor<T,2>();
+            owner_.reset();
+        }
+
+        // Pasa a usar value/grad externos sin copiar nada (réplicas que
+        // comparten los valores de otra red y acumulan su propio gradiente)
+        void alias(T* value, T* grad) noexcept {
+            auto st = value_.strides();
+            value_ = utec::algebra::TensorView<T,2>(value, value_.shape(), st);
+            grad_  = utec::algebra::TensorView<T,2>(grad, value_.shape(), st);
+            own_value_ = utec::algebra::Tensor<T,2>();
+            own_grad_  = utec::algebra::Tensor<T,2>();
+            owner_.reset();
+        }
+
+    private:
+        utec::algebra::Tensor<T,2>     own_value_, own_grad_;
+        utec::algebra::TensorView<T,2> value_, grad_;
+        std::shared_ptr<const void>    owner_;
+    };
+
+    // Crea un parámetro rows x cols inicializado con init(Tensor<T,2>&)
+    template<typename T, typename Init>
+    Parameter<T> make_parameter(std::size_t rows, std::size_t cols, Init&& init) {
+        utec::algebra::Tensor<T,2> t(rows, cols);
+        init(t);
+        return Parameter<T>(std::move(t));
+    }
+
+    // Arena plana: todos los valores de la red en un buffer contiguo y todos
+    // los gradientes en otro con el mismo layout (cada parámetro alineado a
+    // 64 bytes). El optimizador recorre ambos en una sola pasada.
+    template<typename T>
+    class ParameterArena {
+    public:
+        static constexpr std::size_t align_elems = 64 / sizeof(T) ? 64 / sizeof(T) : 1;
+
+        template<typename Layers>
+        void build(Layers& layers) {
+            params_.clear();
+            for (auto& layer : layers) layer->parameters(params_);
+            std::vector<std::size_t> offsets;
+            std::size_t total = 0;
+            for (auto* p : params_) {
+                offsets.push_back(total);
+                total += (p->size() + align_elems - 1) / align_elems * align_elems;
+            }
+            // Buffers nuevos antes de soltar los viejos: los parámetros pueden
+            // seguir apuntando a la arena anterior mientras se copian
+            utec::algebra::Tensor<T,1> values(total), grads(total);
+            values.fill(T(0));
+            grads.fill(T(0));
+            for (std::size_t i = 0; i < params_.size(); ++i)
+                params_[i]->bind(values.data() + offsets[i], grads.data() + offsets[i]);
+            values_ = std::move(values);
+            grads_  = std::move(grads);
+        }
+
+        T* values() noexcept { return values_.data(); }
+        const T* values() const noexcept { return values_.data(); }
+        T* grads() noexcept { return grads_.data(); }
+        const T* grads() const noexcept { return grads_.data(); }
+        std::size_t size() const noexcept { return values_.size(); }
+        std::size_t count() const noexcept { return params_.size(); }
+        const std::vector<Parameter<T>*>& parameters() const noexcept { return params_; }
+
+        void zero_grad() noexcept { grads_.fill(T(0)); }
+
+    private:
+        std::vector<Parameter<T>*> params_;
+        utec::algebra::Tensor<T,1> values_, grads_;
+    };
+
+}
+
+#endif //EPIC1_OFICIAL_NN_PARAMETERS_H
@@ -0,0 +1,447 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_PIPELINE_PARALLEL_H
+#define EPIC1_OFICIAL_NN_PIPELINE_PARALLEL_H
+
+#include "neural_network (4).h"
+#include "thread_pool.h"
+#include "tensor_sparse.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Tiempo de una etapa del pipeline acumulado desde el último reset_stats()
+    struct PipelineStageStats {
+        std::size_t first_layer     = 0, layers = 0;
+        std::size_t parameter_bytes = 0;
+        std::size_t micro_batches   = 0;   // forward + backward completados
+        double      busy_seconds    = 0;   // calculando
+        double      bubble_seconds  = 0;   // esperando a otras etapas
+
+        double bubble_fraction() const noexcept {
+            const double total = busy_seconds + bubble_seconds;
+            return total > 0 ? bubble_seconds / total : 0.0;
+        }
+    };
+
+    namespace detail {
+        // Cortes contiguos de layers en `stages` tramos no vacíos que
+        // minimizan el mayor coste por tramo; devuelve la primera capa de cada uno
+        inline std::vector<std::size_t> balanced_partition(const std::vector<double>& cost, std::size_t stages) {
+            const std::size_t n = cost.size();
+            std::vector<double> prefix(n + 1, 0.0);
+            for (std::size_t i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + cost[i];
+            constexpr double inf = std::numeric_limits<double>::infinity();
+            // best[k][i] = mejor máximo para las i primeras capas en k tramos
+            std::vector<std::vector<double>> best(stages + 1, std::vector<double>(n + 1, inf));
+            std::vector<std::vector<std::size_t>> cut(stages + 1, std::vector<std::size_t>(n + 1, 0));
+            best[0][0] = 0.0;
+            for (std::size_t k = 1; k <= stages; ++k)
+                for (std::size_t i = k; i <= n; ++i)
+                    for (std::size_t j = k - 1; j < i; ++j) {
+                        const double c = std::max(best[k - 1][j], prefix[i] - prefix[j]);
+                        if (c < best[k][i]) { best[k][i] = c; cut[k][i] = j; }
+                    }
+            std::vector<std::size_t> first(stages);
+            for (std::size_t k = stages, i = n; k > 0; --k) {
+                i = cut[k][i];
+                first[k - 1] = i;
+            }
+            return first;
+        }
+    }
+
+    // Entrenamiento con paralelismo de pipeline: las capas de la red se
+    // reparten en etapas contiguas, cada una en su propia hebra, y cada
+    // mini-batch se divide en micro-batches que recorren las etapas con un
+    // horario 1F1B (tras un calentamiento de S - s - 1 forwards, la etapa s
+    // alterna un forward y un backward). Las etapas se pasan el índice del
+    // micro-batch por colas SPSC sin bloqueos; activaciones y gradientes de
+    // frontera viven en buffers por micro-batch que se reutilizan entre pasos.
+    //
+    // A diferencia de DataParallelTrainer no hay réplicas de la red: cada
+    // etapa solo clona sus capas, una copia por micro-batch en vuelo (como
+    // mucho S - s) para que cada una conserve sus cachés hasta su backward.
+    // Las copias comparten los valores de la arena; sus gradientes se
+    // acumulan en la arena ponderados por filas y se da un único paso del
+    // optimizador por mini-batch, así que el resultado equivale al de
+    // entrenar con el mini-batch completo (salvo el redondeo de sumar por
+    // micro-batches, en orden fijo).
+    //
+    // Por defecto las etapas se equilibran por bytes de parámetros;
+    // stage_stats() da el tiempo de burbuja de cada una para ajustar los
+    // cortes con set_partition(). Las hebras de las etapas no usan el pool
+    // de kernels (cada una ocupa su núcleo).
+    template<typename T>
+    class PipelineParallelTrainer {
+    public:
+        // micro_batches = 0 usa 2 por etapa
+        explicit PipelineParallelTrainer(NeuralNetwork<T>& net,
+                                         std::size_t stages = utec::algebra::num_threads(),
+                                         std::size_t micro_batches = 0)
+                : net_(net), micro_(micro_batches ? micro_batches : 2 * std::max<std::size_t>(stages, 1)) {
+            if (stages == 0) throw std::invalid_argument("PipelineParallelTrainer needs at least one stage");
+            if (net_.layers().empty()) throw std::invalid_argument("PipelineParallelTrainer needs a network with layers");
+            std::vector<double> cost;
+            for (const auto& layer : net_.layers()) cost.push_back(double(layer->parameter_bytes()));
+            partition_ = detail::balanced_partition(cost, std::min(stages, cost.size()));
+            reset_stats();
+        }
+
+        PipelineParallelTrainer(const PipelineParallelTrainer&) = delete;
+        PipelineParallelTrainer& operator=(const PipelineParallelTrainer&) = delete;
+
+        // Primera capa de cada etapa (empieza en 0, estrictamente creciente)
+        void set_partition(std::vector<std::size_t> first_layers) {
+            const std::size_t L = net_.layers().size();
+            if (first_layers.empty() || first_layers.front() != 0)
+                throw std::invalid_argument("Pipeline partition must start at layer 0");
+            for (std::size_t i = 1; i < first_layers.size(); ++i)
+                if (first_layers[i] <= first_layers[i - 1])
+                    throw std::invalid_argument("Pipeline partition must be strictly increasing");
+            if (first_layers.back() >= L)
+                throw std::invalid_argument("Pipeline partition leaves an empty stage");
+            partition_ = std::move(first_layers);
+            reset_stats();
+        }
+        const std::vector<std::size_t>& partition() const noexcept { return partition_; }
+
+        void set_micro_batches(std::size_t m) {
+            if (m == 0) throw std::invalid_argument("Pipeline needs at least one micro-batch");
+            micro_ = m;
+        }
+        std::size_t micro_batches() const noexcept { return micro_; }
+        std::size_t stages() const noexcept { return partition_.size(); }
+
+        void set_seed(unsigned seed) { rng_.seed(seed); }
+        T last_loss() const noexcept { return last_loss_; }
+
+        const std::vector<PipelineStageStats>& stage_stats() const noexcept { return stats_; }
+        void reset_stats() {
+            const std::size_t L = net_.layers().size();
+            stats_.assign(partition_.size(), PipelineStageStats{});
+            for (std::size_t s = 0; s < partition_.size(); ++s) {
+                auto& st = stats_[s];
+                st.first_layer = partition_[s];
+                st.layers = (s + 1 < partition_.size() ? partition_[s + 1] : L) - partition_[s];
+                for (std::size_t i = st.first_layer; i < st.first_layer + st.layers; ++i)
+                    st.parameter_bytes += net_.layers()[i]->parameter_bytes();
+            }
+        }
+        // Burbuja de un 1F1B ideal con etapas equilibradas: (S - 1) / (M + S - 1)
+        double ideal_bubble_fraction() const noexcept {
+            const double S = double(stages()), M = double(micro_);
+            return (S - 1) / (M + S - 1);
+        }
+
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType = SGD>
+        void train(const utec::algebra::Tensor<T,2>& X,
+                   const utec::algebra::Tensor<T,2>& Y,
+                   std::size_t epochs, std::size_t batch_size, T learning_rate) {
+            const std::size_t n = X.shape()[0];
+            if (Y.shape()[0] != n)
+                throw std::invalid_argument("X and Y must have the same number of rows");
+            if (n == 0 || epochs == 0) return;
+            const std::size_t bs = (batch_size == 0 || batch_size > n) ? n : batch_size;
+
+            OptimizerType<T> optimizer(learning_rate);
+            auto& arena = net_.parameter_arena();
+            build_stages(arena);
+            order_.resize(n);
+            std::iota(order_.begin(), order_.end(), std::size_t(0));
+
+            const std::size_t S = stages_.size();
+            std::barrier<> sync{std::ptrdiff_t(S)};
+            stop_ = false;
+            error_ = nullptr;
+            aborted_.store(false);
+            std::vector<std::thread> threads;
+            // Al salir (también por excepción) las hebras esperan en la
+            // barrera de inicio: se las libera con stop_ y se unen
+            struct Joiner {
+                PipelineParallelTrainer& self;
+                std::barrier<>& sync;
+                std::vector<std::thread>& threads;
+                ~Joiner() {
+                    if (threads.empty()) return;
+                    self.stop_ = true;
+                    sync.arrive_and_wait();
+                    for (auto& t : threads) t.join();
+                }
+            } joiner{*this, sync, threads};
+            for (std::size_t s = 1; s < S; ++s)
+                threads.emplace_back([this, s, &sync] {
+                    for (;;) {
+                        sync.arrive_and_wait();
+                        if (stop_) return;
+                        run_guarded<LossType>(s);
+                        sync.arrive_and_wait();
+                    }
+                });
+
+            for (std::size_t e = 0; e < epochs; ++e) {
+                std::shuffle(order_.begin(), order_.end(), rng_);
+                T epoch_loss = T(0);
+                for (std::size_t first = 0; first < n; first += bs) {
+                    const std::size_t count = std::min(bs, n - first);
+                    gather(X, first, count, batch_x_);
+                    gather(Y, first, count, batch_y_);
+                    batch_rows_ = count;
+                    active_micro_ = std::min(micro_, count);
+                    const auto start = std::chrono::steady_clock::now();
+                    sync.arrive_and_wait();
+                    run_guarded<LossType>(0);
+                    sync.arrive_and_wait();
+                    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (error_) std::rethrow_exception(error_);
+                    for (std::size_t s = 0; s < S; ++s) {
+                        stats_[s].busy_seconds += stages_[s].busy;
+                        stats_[s].bubble_seconds += std::max(0.0, wall - stages_[s].busy);
+                        stats_[s].micro_batches += active_micro_;
+                    }
+                    T batch_loss = T(0);
+                    for (std::size_t m = 0; m < active_micro_; ++m) batch_loss += losses_[m];
+                    epoch_loss += batch_loss;
+                    optimizer.step(arena.values(), arena.grads(), arena.size());
+                }
+                last_loss_ = epoch_loss / static_cast<T>(n);
+            }
+        }
+
+    private:
+        using Tensor2 = utec::algebra::Tensor<T,2>;
+
+        struct Stage {
+            std::size_t first = 0, last = 0;   // capas [first, last)
+            // Una copia de las capas por micro-batch en vuelo
+            std::vector<std::vector<std::unique_ptr<ILayer<T>>>> slots;
+            // Salida de cada capa por copia: las capas fusionadas la releen en backward
+            std::vector<std::vector<Tensor2>> outs;
+            utec::algebra::Tensor<T,1> grads;  // gradiente de un micro-batch, rango [grad_off, +size) de la arena
+            std::size_t grad_off = 0;
+            Tensor2 input, target, out, loss_grad, gtmp[2];
+            double busy = 0;
+        };
+
+        NeuralNetwork<T>&        net_;
+        std::vector<std::size_t> partition_;
+        std::size_t              micro_;
+        std::vector<Stage>       stages_;
+        // Fronteras entre la etapa s y s+1: activación y gradiente por micro-batch
+        std::vector<std::vector<Tensor2>> acts_, grads_;
+        std::vector<std::unique_ptr<utec::algebra::SpscQueue<std::size_t>>> fwd_, bwd_;
+        std::vector<PipelineStageStats> stats_;
+        std::vector<T>           losses_;     // pérdida de cada micro-batch ponderada por filas
+        std::vector<std::size_t> order_;
+        Tensor2                  batch_x_, batch_y_;
+        std::size_t              batch_rows_ = 0, active_micro_ = 0;
+        T*                       arena_grads_ = nullptr;
+        std::mt19937             rng_{42};
+        T                        last_loss_ = T(0);
+        bool                     stop_ = false;
+        std::atomic<bool>        aborted_{false};
+        std::exception_ptr       error_;
+        std::mutex               error_mutex_;
+
+        void gather(const Tensor2& src, std::size_t first, std::size_t count, Tensor2& dst) const {
+            const std::size_t cols = src.shape()[1];
+            dst.reshape(count, cols);
+            for (std::size_t r = 0; r < count; ++r)
+                std::memcpy(dst.data() + r * cols, src.data() + order_[first + r] * cols, cols * sizeof(T));
+        }
+
+        // Clona las capas de cada etapa y apunta sus parámetros a la arena
+        // (valores) y al buffer de gradientes de la etapa. Se rehace en cada
+        // train(): la red pudo cambiar de capas o de arena
+        void build_stages(ParameterArena<T>& arena) {
+            const auto& layers = net_.layers();
+            const auto& master = arena.parameters();
+            const std::size_t S = partition_.size(), L = layers.size();
+            if (partition_.back() >= L)
+                throw std::logic_error("Pipeline partition does not match the network");
+            arena_grads_ = arena.grads();
+            stages_.clear();
+            stages_.resize(S);
+            std::vector<Parameter<T>*> params;
+            std::size_t next_param = 0;
+            for (std::size_t s = 0; s < S; ++s) {
+                Stage& st = stages_[s];
+                st.first = partition_[s];
+                st.last = s + 1 < S ? partition_[s + 1] : L;
+                // Parámetros de la etapa: los siguientes de la arena, en orden de capa
+                std::size_t count = 0;
+                for (std::size_t i = st.first; i < st.last; ++i) {
+                    params.clear();
+                    layers[i]->parameters(params);
+                    count += params.size();
+                }
+                std::size_t lo = arena.size(), hi = 0;
+                for (std::size_t p = next_param; p < next_param + count; ++p) {
+                    const std::size_t off = std::size_t(master[p]->value().data() - arena.values());
+                    lo = std::min(lo, off);
+                    hi = std::max(hi, off + master[p]->size());
+                }
+                if (count == 0) lo = hi = 0;
+                st.grad_off = lo;
+                st.grads = utec::algebra::Tensor<T,1>(hi - lo);
+                st.grads.fill(T(0));
+                const std::size_t in_flight = std::min(S - s, micro_);
+                st.slots.resize(in_flight);
+                st.outs.assign(in_flight, std::vector<Tensor2>(st.last - st.first));
+                for (auto& slot : st.slots) {
+                    for (std::size_t i = st.first; i < st.last; ++i) slot.push_back(layers[i]->clone());
+                    params.clear();
+                    for (auto& layer : slot) layer->parameters(params);
+                    if (params.size() != count)
+                        throw std::logic_error("Cloned layers do not expose the same parameters");
+                    for (std::size_t p = 0; p < count; ++p) {
+                        const Parameter<T>* m = master[next_param + p];
+                        if (params[p]->size() != m->size())
+                            throw std::logic_error("Cloned layers do not expose the same parameters");
+                        const std::size_t off = std::size_t(m->value().data() - arena.values());
+                        params[p]->alias(arena.values() + off, st.grads.data() + (off - lo));
+                    }
+                }
+                next_param += count;
+            }
+            acts_.assign(S - 1, std::vector<Tensor2>(micro_));
+            grads_.assign(S - 1, std::vector<Tensor2>(micro_));
+            fwd_.clear();
+            bwd_.clear();
+            for (std::size_t s = 0; s + 1 < S; ++s) {
+                fwd_.push_back(std::make_unique<utec::algebra::SpscQueue<std::size_t>>(micro_));
+                bwd_.push_back(std::make_unique<utec::algebra::SpscQueue<std::size_t>>(micro_));
+            }
+            losses_.assign(micro_, T(0));
+        }
+
+        template <template <typename...> class LossType>
+        void run_guarded(std::size_t s) {
+            try {
+                run_stage<LossType>(s);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(error_mutex_);
+                if (!error_) error_ = std::current_exception();
+                aborted_.store(true);
+            }
+        }
+
+        // Espera el siguiente micro-batch de la cola (o aborta si otra etapa falló)
+        std::size_t pop(utec::algebra::SpscQueue<std::size_t>& q) {
+            std::size_t m;
+            while (!q.try_pop(m)) {
+                if (aborted_.load(std::memory_order_relaxed))
+                    throw std::runtime_error("Pipeline stage aborted");
+                std::this_thread::yield();
+            }
+            return m;
+        }
+        void push(utec::algebra::SpscQueue<std::size_t>& q, std::size_t m) {
+            while (!q.try_push(m)) std::this_thread::yield();
+        }
+
+        // Filas del micro-batch m dentro del mini-batch
+        std::size_t micro_begin(std::size_t m) const noexcept { return batch_rows_ * m / active_micro_; }
+
+        static void copy_rows(const Tensor2& src, std::size_t begin, std::size_t end, Tensor2& dst) {
+            const std::size_t cols = src.shape()[1];
+            dst.reshape(end - begin, cols);
+            std::memcpy(dst.data(), src.data() + begin * cols, (end - begin) * cols * sizeof(T));
+        }
+
+        // Horario 1F1B de la etapa s sobre los micro-batches del mini-batch
+        template <template <typename...> class LossType>
+        void run_stage(std::size_t s) {
+            utec::algebra::ThreadPool::SerialScope serial;
+            Stage& st = stages_[s];
+            st.busy = 0;
+            const std::size_t S = stages_.size(), M = active_micro_;
+            std::fill(arena_grads_ + st.grad_off, arena_grads_ + st.grad_off + st.grads.size(), T(0));
+            const std::size_t warmup = std::min(S - s - 1, M);
+            std::size_t f = 0, b = 0;
+            while (f < warmup) forward(s, f++);
+            while (f < M) {
+                forward(s, f++);
+                backward<LossType>(s, b++);
+            }
+            while (b < M) backward<LossType>(s, b++);
+        }
+
+        void forward(std::size_t s, std::size_t m) {
+            Stage& st = stages_[s];
+            const std::size_t S = stages_.size();
+            const Tensor2* in;
+            if (s == 0) {
+                const auto t0 = std::chrono::steady_clock::now();
+                copy_rows(batch_x_, micro_begin(m), micro_begin(m + 1), st.input);
+                st.busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                in = &st.input;
+            } else {
+                const std::size_t got = pop(*fwd_[s - 1]);
+                if (got != m) throw std::logic_error("Pipeline micro-batches arrived out of order");
+                in = &acts_[s - 1][m];
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            const std::size_t slot = m % st.slots.size();
+            auto& layers = st.slots[slot];
+            for (std::size_t i = 0; i < layers.size(); ++i) {
+                Tensor2& dst = i + 1 == layers.size() ? (s + 1 < S ? acts_[s][m] : st.out) : st.outs[slot][i];
+                layers[i]->forward_into(*in, dst);
+                in = &dst;
+            }
+            st.busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (s + 1 < S) push(*fwd_[s], m);
+        }
+
+        template <template <typename...> class LossType>
+        void backward(std::size_t s, std::size_t m) {
+            Stage& st = stages_[s];
+            const std::size_t S = stages_.size();
+            const std::size_t begin = micro_begin(m), end = micro_begin(m + 1);
+            const Tensor2* g;
+            std::chrono::steady_clock::time_point t0;
+            if (s + 1 == S) {
+                // La última etapa hace el backward justo tras su forward
+                t0 = std::chrono::steady_clock::now();
+                copy_rows(batch_y_, begin, end, st.target);
+                LossType<T> loss_obj(st.out, st.target);
+                losses_[m] = loss_obj.loss_and_gradient_into(st.loss_grad) * static_cast<T>(end - begin);
+                g = &st.loss_grad;
+            } else {
+                const std::size_t got = pop(*bwd_[s]);
+                if (got != m) throw std::logic_error("Pipeline micro-batches arrived out of order");
+                t0 = std::chrono::steady_clock::now();
+                g = &grads_[s][m];
+            }
+            auto& layers = st.slots[m % st.slots.size()];
+            for (std::size_t j = layers.size(); j-- > 0;) {
+                Tensor2& dst = j == 0 && s > 0 ? grads_[s - 1][m] : st.gtmp[j & 1];
+                layers[j]->backward_into(*g, dst);
+                g = &dst;
+            }
+            // Media del mini-batch: cada micro-batch pesa filas_m / filas
+            const T w = static_cast<T>(end - begin) / static_cast<T>(batch_rows_);
+            utec::algebra::detail::axpy(st.grads.size(), w, st.grads.data(), arena_grads_ + st.grad_off);
+            st.busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (s > 0) push(*bwd_[s - 1], m);
+        }
+    };
+
+}
+
+#endif //EPIC1_OFICIAL_NN_PIPELINE_PARALLEL_H
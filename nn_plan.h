@@ -0,0 +1,253 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_PLAN_H
+#define EPIC1_OFICIAL_NN_PLAN_H
+
+#include "nn_interfaces (4).h"
+#include "nn_dense (5).h"
+#include "nn_activation (3).h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Plan de ejecución estático para NeuralNetwork::compile: formas inferidas,
+// pasos planos (Dense + activación fusionadas, despacho sin llamadas
+// virtuales para los tipos conocidos) y activaciones y gradientes repartidos
+// en un conjunto mínimo de buffers compartidos según su intervalo de vida.
+
+namespace utec::neural_network {
+
+    enum class PlanKind {
+        dense, dense_relu, dense_sigmoid, dense_tanh,   // Dense (+ activación siguiente)
+        fused_relu, fused_sigmoid, fused_tanh,          // FusedDense
+        relu, sigmoid, tanh,                            // activación suelta
+        generic                                         // otra capa: llamadas virtuales
+    };
+
+    inline const char* plan_kind_name(PlanKind k) noexcept {
+        switch (k) {
+            case PlanKind::dense:         return "dense";
+            case PlanKind::dense_relu:    return "dense+relu";
+            case PlanKind::dense_sigmoid: return "dense+sigmoid";
+            case PlanKind::dense_tanh:    return "dense+tanh";
+            case PlanKind::fused_relu:    return "fused_relu";
+            case PlanKind::fused_sigmoid: return "fused_sigmoid";
+            case PlanKind::fused_tanh:    return "fused_tanh";
+            case PlanKind::relu:          return "relu";
+            case PlanKind::sigmoid:       return "sigmoid";
+            case PlanKind::tanh:          return "tanh";
+            case PlanKind::generic:       return "generic";
+        }
+        return "?";
+    }
+
+    struct PlanStep {
+        static constexpr std::size_t npos = std::size_t(-1);
+        PlanKind    kind = PlanKind::generic;
+        std::size_t layer = 0, layers = 1;            // primera capa de la red y cuántas cubre
+        std::size_t in_features = 0, out_features = 0;
+        std::size_t in = npos;                        // buffer de la entrada (npos: el lote)
+        std::size_t out = npos;                       // buffer de la salida
+        std::size_t grad_out = npos;                  // gradiente que llega a la salida
+        std::size_t grad_in = npos;                   // gradiente de la entrada (npos: no se calcula)
+    };
+
+    struct ExecutionPlan {
+        std::size_t              input_features = 0, batch_size = 0;
+        std::vector<PlanStep>    steps;
+        std::vector<std::size_t> buffer_elems;       // capacidad de cada buffer compartido
+        std::size_t              loss_grad = PlanStep::npos;
+        std::size_t              values = 0;         // activaciones + gradientes planificados
+
+        bool empty() const noexcept { return steps.empty(); }
+        std::size_t elements() const noexcept {
+            std::size_t n = 0;
+            for (auto e : buffer_elems) n += e;
+            return n;
+        }
+    };
+
+    namespace detail {
+        inline bool plan_is_act(PlanKind k) noexcept {
+            return k == PlanKind::relu || k == PlanKind::sigmoid || k == PlanKind::tanh;
+        }
+        // backward necesita la entrada (grad W = xᵀ·dz)
+        inline bool plan_keeps_input(PlanKind k) noexcept {
+            return k != PlanKind::generic && !plan_is_act(k);
+        }
+        // backward necesita la salida (derivada de la activación)
+        inline bool plan_keeps_output(PlanKind k) noexcept {
+            return k != PlanKind::generic && k != PlanKind::dense;
+        }
+
+        template<typename T>
+        PlanKind classify_layer(const ILayer<T>* layer, const ILayer<T>* next, std::size_t& span) {
+            span = 1;
+            if (dynamic_cast<const Dense<T>*>(layer)) {
+                span = 2;
+                if (dynamic_cast<const ReLU<T>*>(next))    return PlanKind::dense_relu;
+                if (dynamic_cast<const Sigmoid<T>*>(next)) return PlanKind::dense_sigmoid;
+                if (dynamic_cast<const Tanh<T>*>(next))    return PlanKind::dense_tanh;
+                span = 1;
+                return PlanKind::dense;
+            }
+            if (dynamic_cast<const DenseReLU<T>*>(layer))    return PlanKind::fused_relu;
+            if (dynamic_cast<const DenseSigmoid<T>*>(layer)) return PlanKind::fused_sigmoid;
+            if (dynamic_cast<const DenseTanh<T>*>(layer))    return PlanKind::fused_tanh;
+            if (dynamic_cast<const ReLU<T>*>(layer))         return PlanKind::relu;
+            if (dynamic_cast<const Sigmoid<T>*>(layer))      return PlanKind::sigmoid;
+            if (dynamic_cast<const Tanh<T>*>(layer))         return PlanKind::tanh;
+            return PlanKind::generic;
+        }
+    }
+
+    // Construye el plan de un paso de entrenamiento (forward, pérdida,
+    // backward) para lotes de batch_size filas. Los instantes son: forward
+    // del paso k en t = k, pérdida en t = S y backward del paso k en
+    // t = 2S - k. Cada activación y gradiente vive desde que se escribe hasta
+    // su última lectura; un buffer se reutiliza cuando su valor anterior ya
+    // murió. Las activaciones sueltas trabajan in situ (forward sobre su
+    // entrada si nadie más la necesita, backward sobre el gradiente).
+    template<typename T>
+    ExecutionPlan plan_execution(const std::vector<std::unique_ptr<ILayer<T>>>& layers,
+                                 std::size_t input_features, std::size_t batch_size) {
+        if (input_features == 0 || batch_size == 0)
+            throw std::invalid_argument("compile() needs non-zero input features and batch size");
+        ExecutionPlan plan;
+        plan.input_features = input_features;
+        plan.batch_size = batch_size;
+
+        // Pasos y formas
+        std::size_t width = input_features;
+        for (std::size_t i = 0; i < layers.size();) {
+            PlanStep st;
+            const ILayer<T>* next = i + 1 < layers.size() ? layers[i + 1].get() : nullptr;
+            st.kind = detail::classify_layer<T>(layers[i].get(), next, st.layers);
+            st.layer = i;
+            st.in_features = width;
+            try {
+                st.out_features = layers[i]->output_features(width);
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("compile(): layer " + std::to_string(i) + " (" +
+                                            layers[i]->name() + "): " + e.what());
+            }
+            plan.steps.push_back(st);
+            width = st.out_features;
+            i += st.layers;
+        }
+        const std::size_t S = plan.steps.size();
+        if (S == 0) return plan;
+
+        // Valores: A[k] = entrada del paso k (A[0] es el lote, fuera del
+        // plan; A[S] es la predicción), G[k] = gradiente respecto de A[k]
+        struct Value {
+            std::size_t elems = 0, def = 0, last = 0;
+            std::size_t root = PlanStep::npos;     // alias (mismo buffer) de otro valor
+            std::size_t buffer = PlanStep::npos;
+            bool used = false;
+        };
+        std::vector<Value> v(2 * (S + 1));
+        auto A = [&](std::size_t k) -> Value& { return v[k]; };
+        auto G = [&](std::size_t k) -> Value& { return v[S + 1 + k]; };
+        auto read = [&](Value& x, std::size_t t) { x.last = std::max(x.last, t); };
+        const auto& st = plan.steps;
+
+        for (std::size_t k = 0; k < S; ++k) {
+            Value& out = A(k + 1);
+            out.used = true;
+            out.elems = batch_size * st[k].out_features;
+            out.def = out.last = k;
+            if (k > 0) read(A(k), k);
+            if (detail::plan_keeps_output(st[k].kind)) read(out, 2 * S - k);
+            if (k > 0 && detail::plan_keeps_input(st[k].kind)) read(A(k), 2 * S - k);
+        }
+        read(A(S), S);
+        G(S).used = true;
+        G(S).elems = batch_size * st[S - 1].out_features;
+        G(S).def = G(S).last = S;
+        for (std::size_t k = S; k-- > 0;) {
+            const std::size_t t = 2 * S - k;
+            read(G(k + 1), t);
+            if (k == 0 && st[k].kind != PlanKind::generic) continue;   // nadie usa el gradiente del lote
+            Value& g = G(k);
+            g.used = true;
+            g.elems = batch_size * st[k].in_features;
+            g.def = g.last = t;
+        }
+
+        // Alias in situ: activación suelta sobre su entrada muerta y su
+        // backward sobre el gradiente de la salida
+        auto root_of = [&](std::size_t i) {
+            while (v[i].root != PlanStep::npos) i = v[i].root;
+            return i;
+        };
+        for (std::size_t k = 1; k < S; ++k)
+            if (detail::plan_is_act(st[k].kind)) {
+                const std::size_t r = root_of(k);
+                if (v[r].last == k) {
+                    A(k + 1).root = r;
+                    v[r].last = std::max(v[r].last, A(k + 1).last);
+                }
+            }
+        for (std::size_t k = S; k-- > 0;)
+            if (detail::plan_is_act(st[k].kind) && G(k).used) {
+                const std::size_t r = root_of(S + 1 + k + 1);
+                G(k).root = r;
+                v[r].last = std::max(v[r].last, G(k).last);
+            }
+
+        // Asignación lineal por instante de definición: el buffer libre de
+        // capacidad más ajustada (o el mayor libre, que se agranda)
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i < v.size(); ++i)
+            if (v[i].used && v[i].root == PlanStep::npos) order.push_back(i);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t a, std::size_t b) { return v[a].def < v[b].def; });
+        std::vector<std::size_t> busy_until;
+        for (std::size_t i : order) {
+            Value& x = v[i];
+            std::size_t best = PlanStep::npos;
+            for (std::size_t b = 0; b < busy_until.size(); ++b) {
+                if (busy_until[b] >= x.def) continue;
+                if (best == PlanStep::npos) { best = b; continue; }
+                const bool fits = plan.buffer_elems[b] >= x.elems, best_fits = plan.buffer_elems[best] >= x.elems;
+                if (fits != best_fits ? fits
+                                      : (fits ? plan.buffer_elems[b] < plan.buffer_elems[best]
+                                              : plan.buffer_elems[b] > plan.buffer_elems[best]))
+                    best = b;
+            }
+            if (best == PlanStep::npos) {
+                best = busy_until.size();
+                busy_until.push_back(0);
+                plan.buffer_elems.push_back(0);
+            }
+            plan.buffer_elems[best] = std::max(plan.buffer_elems[best], x.elems);
+            busy_until[best] = x.last;
+            x.buffer = best;
+        }
+        for (auto& x : v)
+            if (x.used) {
+                x.buffer = v[root_of(std::size_t(&x - v.data()))].buffer;
+                ++plan.values;
+            }
+
+        for (std::size_t k = 0; k < S; ++k) {
+            auto& s = plan.steps[k];
+            s.in = k > 0 ? A(k).buffer : PlanStep::npos;
+            s.out = A(k + 1).buffer;
+            s.grad_out = G(k + 1).buffer;
+            s.grad_in = G(k).used ? G(k).buffer : PlanStep::npos;
+        }
+        plan.loss_grad = G(S).buffer;
+        return plan;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_NN_PLAN_H
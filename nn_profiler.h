@@ -0,0 +1,309 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_PROFILER_H
+#define EPIC1_OFICIAL_NN_PROFILER_H
+
+#include "tensor (8).h"
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Instrumentación por capa y fase. Se activa compilando con UTEC_PROFILE=1
+// (opción UTEC_PROFILING de CMake); sin ella Profiler queda vacío y
+// ProfileScope no genera código, así que los builds normales no pagan nada.
+#ifndef UTEC_PROFILE
+#define UTEC_PROFILE 0
+#endif
+
+namespace utec::neural_network {
+
+    inline constexpr bool profiling_enabled = UTEC_PROFILE != 0;
+
+    enum class Phase { forward, backward, loss, update, infer };
+
+    inline const char* phase_name(Phase p) noexcept {
+        switch (p) {
+            case Phase::forward:  return "forward";
+            case Phase::backward: return "backward";
+            case Phase::loss:     return "loss";
+            case Phase::update:   return "update";
+            case Phase::infer:    return "infer";
+        }
+        return "?";
+    }
+
+    // Acumulado de una capa (layer = -1 para pérdida y optimizador) en una fase
+    struct ProfileEntry {
+        std::string name;
+        int         layer       = -1;
+        Phase       phase       = Phase::forward;
+        std::size_t calls       = 0;
+        double      seconds     = 0;
+        double      flops       = 0;
+        double      bytes       = 0;
+        std::size_t allocations = 0;
+    };
+
+    struct EpochProfile {
+        std::size_t               epoch   = 0;
+        double                    seconds = 0;
+        std::vector<ProfileEntry> entries;
+    };
+
+#if UTEC_PROFILE
+    class Profiler {
+    public:
+        using clock = std::chrono::steady_clock;
+        static constexpr bool enabled = true;
+
+        // Límite de eventos guardados para la traza (los agregados no se limitan)
+        explicit Profiler(std::size_t max_events = 1 << 20) : max_events_(max_events) {}
+
+        // El mutex no se mueve: cada Profiler tiene el suyo
+        Profiler(Profiler&& o) noexcept { move_from(o); }
+        Profiler& operator=(Profiler&& o) noexcept {
+            if (this != &o) move_from(o);
+            return *this;
+        }
+
+        void begin_epoch() {
+            std::lock_guard<std::mutex> lk(mutex_);
+            current_ = EpochProfile{};
+            current_.epoch = epochs_.size();
+            epoch_start_ = clock::now();
+            in_epoch_ = true;
+        }
+
+        void end_epoch() {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (!in_epoch_) return;
+            auto now = clock::now();
+            current_.seconds = std::chrono::duration<double>(now - epoch_start_).count();
+            add_event("epoch " + std::to_string(current_.epoch), "epoch", epoch_start_, now, -1, 0, 0, 0);
+            epochs_.push_back(std::move(current_));
+            in_epoch_ = false;
+        }
+
+        void record(int layer, const char* name, Phase phase, clock::time_point start, clock::time_point end,
+                    double flops, double bytes, std::size_t allocations) {
+            std::lock_guard<std::mutex> lk(mutex_);
+            const double secs = std::chrono::duration<double>(end - start).count();
+            // Fuera de una época (p. ej. predict) se acumula en el total de inferencia
+            auto& entries = in_epoch_ ? current_.entries : outside_;
+            ProfileEntry* e = nullptr;
+            for (auto& x : entries)
+                if (x.layer == layer && x.phase == phase && x.name == name) { e = &x; break; }
+            if (!e) {
+                entries.push_back(ProfileEntry{name, layer, phase});
+                e = &entries.back();
+            }
+            ++e->calls;
+            e->seconds     += secs;
+            e->flops       += flops;
+            e->bytes       += bytes;
+            e->allocations += allocations;
+            add_event(name, phase_name(phase), start, end, layer, flops, bytes, allocations);
+        }
+
+        // Épocas cerradas, en orden
+        const std::vector<EpochProfile>& epochs() const noexcept { return epochs_; }
+        // Llamadas registradas fuera de train (predict / infer)
+        const std::vector<ProfileEntry>& inference() const noexcept { return outside_; }
+        std::size_t dropped_events() const noexcept { return dropped_; }
+
+        // Suma de todas las épocas por capa y fase
+        std::vector<ProfileEntry> totals() const {
+            std::lock_guard<std::mutex> lk(mutex_);
+            std::vector<ProfileEntry> out;
+            for (const auto& ep : epochs_)
+                for (const auto& x : ep.entries) {
+                    ProfileEntry* e = nullptr;
+                    for (auto& y : out)
+                        if (y.layer == x.layer && y.phase == x.phase && y.name == x.name) { e = &y; break; }
+                    if (!e) {
+                        out.push_back(ProfileEntry{x.name, x.layer, x.phase});
+                        e = &out.back();
+                    }
+                    e->calls += x.calls;
+                    e->seconds += x.seconds;
+                    e->flops += x.flops;
+                    e->bytes += x.bytes;
+                    e->allocations += x.allocations;
+                }
+            return out;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lk(mutex_);
+            epochs_.clear();
+            outside_.clear();
+            events_.clear();
+            dropped_ = 0;
+            in_epoch_ = false;
+            origin_ = clock::now();
+        }
+
+        // Traza en formato Chrome trace-event (chrome://tracing, Perfetto)
+        void write_chrome_trace(std::ostream& os) const {
+            std::lock_guard<std::mutex> lk(mutex_);
+            os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            for (std::size_t i = 0; i < events_.size(); ++i) {
+                const auto& ev = events_[i];
+                os << (i ? ",\n" : "\n") << "{\"name\":\"" << ev.name << "\",\"cat\":\"" << ev.cat
+                   << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << ev.tid << ",\"ts\":" << ev.ts_us
+                   << ",\"dur\":" << ev.dur_us << ",\"args\":{\"layer\":" << ev.layer
+                   << ",\"flops\":" << ev.flops << ",\"bytes\":" << ev.bytes
+                   << ",\"allocations\":" << ev.allocations << "}}";
+            }
+            os << "\n]}\n";
+        }
+
+        void write_chrome_trace(const std::string& path) const {
+            std::ofstream out(path);
+            if (!out) throw std::runtime_error("Cannot write trace file: " + path);
+            write_chrome_trace(out);
+        }
+
+    private:
+        struct Event {
+            std::string name;
+            const char* cat;
+            double      ts_us, dur_us;
+            int         layer;
+            double      flops, bytes;
+            std::size_t allocations, tid;
+        };
+
+        mutable std::mutex        mutex_;
+        std::vector<EpochProfile> epochs_;
+        EpochProfile              current_;
+        std::vector<ProfileEntry> outside_;
+        std::vector<Event>        events_;
+        std::size_t               max_events_, dropped_ = 0;
+        bool                      in_epoch_ = false;
+        clock::time_point         origin_ = clock::now(), epoch_start_;
+
+        void move_from(Profiler& o) noexcept {
+            std::scoped_lock lk(mutex_, o.mutex_);
+            epochs_      = std::move(o.epochs_);
+            current_     = std::move(o.current_);
+            outside_     = std::move(o.outside_);
+            events_      = std::move(o.events_);
+            max_events_  = o.max_events_;
+            dropped_     = o.dropped_;
+            in_epoch_    = o.in_epoch_;
+            origin_      = o.origin_;
+            epoch_start_ = o.epoch_start_;
+        }
+
+        void add_event(std::string name, const char* cat, clock::time_point start, clock::time_point end,
+                       int layer, double flops, double bytes, std::size_t allocations) {
+            if (events_.size() >= max_events_) { ++dropped_; return; }
+            const double ts = std::chrono::duration<double, std::micro>(start - origin_).count();
+            const double dur = std::chrono::duration<double, std::micro>(end - start).count();
+            const std::size_t tid = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000;
+            events_.push_back(Event{std::move(name), cat, ts, dur, layer, flops, bytes, allocations, tid});
+        }
+    };
+
+    // Mide un tramo (capa + fase) y lo registra al salir del ámbito
+    template<typename T>
+    class ProfileScope {
+    public:
+        // Capa `index` procesando `in` (Tensor o CsrMatrix) hacia `out`
+        // (bytes = in + out + parámetros)
+        template<typename Layer, typename In>
+        ProfileScope(Profiler& p, int index, const Layer& layer, Phase phase,
+                     const In& in, const utec::algebra::Tensor<T,2>& out)
+                : p_(p), index_(index), name_(layer.name()), phase_(phase), out_(&out),
+                  param_bytes_(double(layer.parameter_bytes()) * (phase == Phase::backward ? 2 : 1)
+                               + input_bytes(in)),
+                  flops_(layer.flops(in.shape()[0], in.shape()[1], phase)) { start(); }
+
+        // Tramo sin capa (pérdida, optimizador) con coste dado
+        ProfileScope(Profiler& p, const char* name, Phase phase, double flops, double bytes)
+                : p_(p), index_(-1), name_(name), phase_(phase), param_bytes_(bytes), flops_(flops) { start(); }
+
+        ~ProfileScope() {
+            const auto end = Profiler::clock::now();
+            double bytes = param_bytes_;
+            if (out_) bytes += double(out_->size()) * sizeof(T);
+            p_.record(index_, name_, phase_, start_, end, flops_, bytes,
+                      utec::algebra::allocation_stats().allocations - allocs_);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        Profiler&                         p_;
+        int                               index_;
+        const char*                       name_;
+        Phase                             phase_;
+        const utec::algebra::Tensor<T,2>* out_ = nullptr;
+        double                            param_bytes_, flops_;
+        std::size_t                       allocs_ = 0;
+        Profiler::clock::time_point       start_;
+
+        void start() {
+            allocs_ = utec::algebra::allocation_stats().allocations;
+            start_ = Profiler::clock::now();
+        }
+
+        template<typename In>
+        static double input_bytes(const In& in) noexcept {
+            if constexpr (requires { in.bytes(); }) return double(in.bytes());
+            else return double(in.size()) * sizeof(T);
+        }
+    };
+#else
+    // Sin UTEC_PROFILE: misma interfaz, sin estado ni código
+    class Profiler {
+    public:
+        static constexpr bool enabled = false;
+        explicit Profiler(std::size_t = 0) noexcept {}
+        void begin_epoch() noexcept {}
+        void end_epoch() noexcept {}
+        const std::vector<EpochProfile>& epochs() const noexcept { return empty_epochs(); }
+        const std::vector<ProfileEntry>& inference() const noexcept { return empty_entries(); }
+        std::size_t dropped_events() const noexcept { return 0; }
+        std::vector<ProfileEntry> totals() const { return {}; }
+        void reset() noexcept {}
+        void write_chrome_trace(std::ostream& os) const { os << "{\"traceEvents\":[]}\n"; }
+        void write_chrome_trace(const std::string& path) const {
+            std::ofstream out(path);
+            if (!out) throw std::runtime_error("Cannot write trace file: " + path);
+            write_chrome_trace(out);
+        }
+    private:
+        static const std::vector<EpochProfile>& empty_epochs() noexcept {
+            static const std::vector<EpochProfile> e;
+            return e;
+        }
+        static const std::vector<ProfileEntry>& empty_entries() noexcept {
+            static const std::vector<ProfileEntry> e;
+            return e;
+        }
+    };
+
+    template<typename T>
+    class ProfileScope {
+    public:
+        template<typename Layer, typename In>
+        ProfileScope(Profiler&, int, const Layer&, Phase, const In&, const utec::algebra::Tensor<T,2>&) noexcept {}
+        ProfileScope(Profiler&, const char*, Phase, double, double) noexcept {}
+    };
+#endif
+
+}
+
+#endif //EPIC1_OFICIAL_NN_PROFILER_H
@@ -0,0 +1,245 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_QUANTIZATION_H
+#define EPIC1_OFICIAL_NN_QUANTIZATION_H
+
+#include "neural_network (4).h"
+#include "tensor_qgemm.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Epílogo del GEMM int8: y = act(acc · s_x · s_w[j] + b[j])
+    template<typename T, typename Act>
+    struct DequantBiasActEpilogue {
+        const T* scale;   // s_x · s_w[j], precalculado por columna
+        const T* bias;
+        void operator()(size_t, size_t col, const std::int32_t* acc, T* y, size_t n) const noexcept {
+            const T* s = scale + col;
+            const T* b = bias + col;
+            for (size_t j = 0; j < n; ++j) y[j] = static_cast<T>(acc[j]) * s[j] + b[j];
+            Act::forward(y, y, n);
+        }
+    };
+
+    // Dense solo de inferencia con pesos int8 simétricos por canal de salida
+    // (s_w[j] = max|W[:,j]| / 127) y entrada cuantizada por tensor con la escala
+    // calibrada s_x. La activación Act va en el epílogo, como en FusedDense.
+    template<typename T, typename Act = IdentityOp<T>>
+    class QuantizedDense final : public ILayer<T> {
+        size_t in_f_, out_f_;
+        std::vector<std::int8_t> weights_;   // empaquetados para qgemm
+        std::vector<T> w_scale_, out_scale_, bias_;
+        T in_scale_;
+    public:
+        QuantizedDense(utec::algebra::TensorView<const T,2> weights,
+                       utec::algebra::TensorView<const T,2> bias, T input_scale)
+                : in_f_(weights.shape()[0]), out_f_(weights.shape()[1]),
+                  w_scale_(out_f_), out_scale_(out_f_), bias_(out_f_), in_scale_(input_scale) {
+            if (bias.size() != out_f_)
+                throw std::invalid_argument("Bias size does not match the output features");
+            if (!(input_scale > T(0)))
+                throw std::invalid_argument("Input scale must be positive");
+            std::vector<std::int8_t> q(in_f_ * out_f_);
+            for (size_t j = 0; j < out_f_; ++j) {
+                T amax = T(0);
+                for (size_t i = 0; i < in_f_; ++i) amax = std::max(amax, std::abs(weights(i, j)));
+                w_scale_[j] = amax > T(0) ? amax / T(127) : T(1);
+                for (size_t i = 0; i < in_f_; ++i)
+                    q[i*out_f_ + j] = static_cast<std::int8_t>(std::lround(weights(i, j) / w_scale_[j]));
+                out_scale_[j] = in_scale_ * w_scale_[j];
+                bias_[j] = bias.data()[j];
+            }
+            weights_ = utec::algebra::qgemm_pack_b(in_f_, out_f_, q.data(), out_f_);
+        }
+
+        utec::algebra::Tensor<T,2> forward(const utec::algebra::Tensor<T,2>&) override {
+            throw std::logic_error("QuantizedDense is inference-only");
+        }
+        utec::algebra::Tensor<T,2> backward(const utec::algebra::Tensor<T,2>&) override {
+            throw std::logic_error("QuantizedDense is inference-only");
+        }
+
+        void infer_into(const utec::algebra::Tensor<T,2>& x,
+                        utec::algebra::Tensor<T,2>& y) const override {
+            if (x.shape()[1] != in_f_)
+                throw std::invalid_argument("Input features do not match the layer");
+            const size_t rows = x.shape()[0];
+            // Entrada cuantizada y empaquetada (un buffer por hilo)
+            thread_local std::vector<std::int16_t> xq;
+            xq.resize(utec::algebra::detail::qgemm_packed_a_size(rows, in_f_));
+            utec::algebra::quantize_pack_a(rows, in_f_, x.data(), in_f_, T(1) / in_scale_, xq.data());
+            y.reshape(rows, out_f_);
+            utec::algebra::qgemm(rows, out_f_, in_f_, xq.data(), weights_.data(), y.data(), out_f_,
+                                 DequantBiasActEpilogue<T, Act>{out_scale_.data(), bias_.data()});
+        }
+
+        size_t parameter_bytes() const noexcept override {
+            return in_f_ * out_f_ * sizeof(std::int8_t) + (w_scale_.size() + bias_.size()) * sizeof(T);
+        }
+
+        const char* name() const noexcept override { return "QuantizedDense"; }
+        double flops(size_t rows, size_t, Phase) const noexcept override {
+            return 2.0 * double(rows) * double(in_f_) * double(out_f_) + 3.0 * double(rows) * double(out_f_);
+        }
+
+        size_t in_features() const noexcept { return in_f_; }
+        size_t out_features() const noexcept { return out_f_; }
+        T input_scale() const noexcept { return in_scale_; }
+        const std::vector<T>& weight_scales() const noexcept { return w_scale_; }
+    };
+
+    namespace detail {
+        template<typename T>
+        T max_abs(const utec::algebra::Tensor<T,2>& x) noexcept {
+            T m = T(0);
+            for (auto it = x.cbegin(); it != x.cend(); ++it) m = std::max(m, std::abs(*it));
+            return m;
+        }
+
+        // Crea la QuantizedDense con la activación Act plegada en el epílogo
+        template<typename T, typename Act>
+        std::unique_ptr<ILayer<T>> make_quantized(utec::algebra::TensorView<const T,2> w,
+                                                  utec::algebra::TensorView<const T,2> b,
+                                                  const utec::algebra::Tensor<T,2>& calib) {
+            T amax = max_abs(calib);
+            return std::make_unique<QuantizedDense<T, Act>>(w, b, amax > T(0) ? amax / T(127) : T(1));
+        }
+
+        // Copia de una activación sin estado de entrenamiento (o nullptr)
+        template<typename T>
+        std::unique_ptr<ILayer<T>> clone_activation(const ILayer<T>* layer) {
+            if (dynamic_cast<const ReLU<T>*>(layer))    return std::make_unique<ReLU<T>>();
+            if (dynamic_cast<const Sigmoid<T>*>(layer)) return std::make_unique<Sigmoid<T>>();
+            if (dynamic_cast<const Tanh<T>*>(layer))    return std::make_unique<Tanh<T>>();
+            if (dynamic_cast<const GELU<T>*>(layer))    return std::make_unique<GELU<T>>();
+            if (auto* l = dynamic_cast<const LeakyReLU<T>*>(layer))
+                return std::make_unique<LeakyReLU<T>>(l->alpha());
+            return nullptr;
+        }
+    }
+
+    // Cuantización post-entrenamiento: recorre la red con el lote de
+    // calibración (inferencia en punto flotante) para fijar la escala de
+    // entrada de cada Dense y devuelve una red solo de inferencia con
+    // QuantizedDense. Dense + ReLU/Sigmoid/Tanh se pliegan en una sola capa.
+    template<typename T>
+    NeuralNetwork<T> quantize(const NeuralNetwork<T>& net, const utec::algebra::Tensor<T,2>& calibration) {
+        const auto& layers = net.layers();
+        NeuralNetwork<T> q;
+        utec::algebra::Tensor<T,2> cur = calibration, next;
+        for (size_t i = 0; i < layers.size(); ++i) {
+            const ILayer<T>* layer = layers[i].get();
+            const ILayer<T>* after = i + 1 < layers.size() ? layers[i + 1].get() : nullptr;
+            std::unique_ptr<ILayer<T>> ql;
+            if (auto* d = dynamic_cast<const Dense<T>*>(layer)) {
+                bool folded = true;
+                if (dynamic_cast<const ReLU<T>*>(after))
+                    ql = detail::make_quantized<T, ReLUOp<T>>(d->weights(), d->bias(), cur);
+                else if (dynamic_cast<const Sigmoid<T>*>(after))
+                    ql = detail::make_quantized<T, SigmoidOp<T>>(d->weights(), d->bias(), cur);
+                else if (dynamic_cast<const Tanh<T>*>(after))
+                    ql = detail::make_quantized<T, TanhOp<T>>(d->weights(), d->bias(), cur);
+                else {
+                    ql = detail::make_quantized<T, IdentityOp<T>>(d->weights(), d->bias(), cur);
+                    folded = false;
+                }
+                if (folded) {
+                    // La activación plegada también avanza la calibración
+                    layer->infer_into(cur, next);
+                    std::swap(cur, next);
+                    layer = after;
+                    ++i;
+                }
+            } else if (auto* r = dynamic_cast<const DenseReLU<T>*>(layer)) {
+                ql = detail::make_quantized<T, ReLUOp<T>>(r->weights(), r->bias(), cur);
+            } else if (auto* s = dynamic_cast<const DenseSigmoid<T>*>(layer)) {
+                ql = detail::make_quantized<T, SigmoidOp<T>>(s->weights(), s->bias(), cur);
+            } else if (auto* t = dynamic_cast<const DenseTanh<T>*>(layer)) {
+                ql = detail::make_quantized<T, TanhOp<T>>(t->weights(), t->bias(), cur);
+            } else {
+                ql = detail::clone_activation(layer);
+                if (!ql) throw std::invalid_argument("Layer type is not supported by quantize()");
+            }
+            layer->infer_into(cur, next);
+            std::swap(cur, next);
+            q.add_layer(std::move(ql));
+        }
+        return q;
+    }
+
+    // Comparación de exactitud entre la red flotante y la cuantizada
+    struct QuantizationReport {
+        double max_abs_error    = 0;
+        double mean_abs_error   = 0;
+        double relative_rmse    = 0;   // ||q - f|| / ||f||
+        double argmax_agreement = 1;   // fracción de filas con la misma clase
+        size_t reference_bytes  = 0;
+        size_t quantized_bytes  = 0;
+    };
+
+    template<typename T>
+    QuantizationReport compare_quantized(const NeuralNetwork<T>& reference,
+                                         const NeuralNetwork<T>& quantized,
+                                         const utec::algebra::Tensor<T,2>& X) {
+        auto f = reference.infer(X);
+        auto q = quantized.infer(X);
+        if (f.shape() != q.shape())
+            throw std::invalid_argument("Networks produce different output shapes");
+        QuantizationReport r;
+        double err2 = 0, ref2 = 0, sum = 0;
+        for (size_t i = 0; i < f.size(); ++i) {
+            double d = double(q.data()[i]) - double(f.data()[i]);
+            r.max_abs_error = std::max(r.max_abs_error, std::abs(d));
+            sum  += std::abs(d);
+            err2 += d * d;
+            ref2 += double(f.data()[i]) * double(f.data()[i]);
+        }
+        r.mean_abs_error = f.size() ? sum / double(f.size()) : 0.0;
+        r.relative_rmse  = ref2 > 0 ? std::sqrt(err2 / ref2) : std::sqrt(err2);
+        const size_t rows = f.shape()[0], cols = f.shape()[1];
+        if (cols > 1 && rows > 0) {
+            size_t same = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                const T* fr = f.data() + i*cols;
+                const T* qr = q.data() + i*cols;
+                same += std::max_element(fr, fr + cols) - fr == std::max_element(qr, qr + cols) - qr;
+            }
+            r.argmax_agreement = double(same) / double(rows);
+        }
+        r.reference_bytes = reference.parameter_bytes();
+        r.quantized_bytes = quantized.parameter_bytes();
+        return r;
+    }
+
+    // Rendimiento de inferencia con buffers reutilizados (filas por segundo)
+    struct InferenceBenchmark {
+        double seconds_per_batch = 0;
+        double rows_per_second   = 0;
+    };
+
+    template<typename T>
+    InferenceBenchmark benchmark_inference(const NeuralNetwork<T>& net,
+                                           const utec::algebra::Tensor<T,2>& X,
+                                           size_t iterations = 20) {
+        utec::algebra::Tensor<T,2> out, scratch;
+        net.infer_into(X, out, scratch);   // calentamiento
+        auto start = std::chrono::steady_clock::now();
+        for (size_t it = 0; it < iterations; ++it) net.infer_into(X, out, scratch);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        InferenceBenchmark b;
+        b.seconds_per_batch = iterations ? secs / double(iterations) : 0.0;
+        b.rows_per_second   = secs > 0 ? double(iterations * X.shape()[0]) / secs : 0.0;
+        return b;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_NN_QUANTIZATION_H
@@ -0,0 +1,362 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_SERIALIZATION_H
+#define EPIC1_OFICIAL_NN_SERIALIZATION_H
+
+#include "neural_network (4).h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTEC_HAS_MMAP 1
+#endif
+
+namespace utec::neural_network {
+
+    // Formato binario de modelo (versión 1, little-endian):
+    //
+    //   [ModelHeader 64 B][LayerRecord x layer_count][padding][payloads]
+    //
+    // Cada tensor (pesos in x out en orden de filas, bias 1 x out) empieza en un
+    // offset alineado a model_alignment, de modo que al mapear el archivo las
+    // capas usan los pesos in situ, sin parsear ni copiar. El checksum cubre la
+    // cabecera y la tabla de capas; los payloads no se recorren al cargar.
+    namespace model_format {
+        inline constexpr char          magic[8]  = {'U','T','E','C','N','N','\0','\0'};
+        inline constexpr std::uint32_t version   = 1;
+        inline constexpr std::uint32_t endian_tag = 0x01020304u;
+        inline constexpr std::uint64_t alignment = 64;
+
+        enum class LayerKind : std::uint32_t {
+            dense = 1, dense_relu, dense_sigmoid, dense_tanh,
+            relu, sigmoid, tanh, leaky_relu, gelu
+        };
+
+        struct ModelHeader {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t endian_tag;
+            std::uint32_t scalar_size;     // sizeof(T)
+            std::uint32_t layer_count;
+            std::uint32_t alignment;
+            std::uint32_t reserved;
+            std::uint64_t table_offset;
+            std::uint64_t payload_offset;
+            std::uint64_t file_size;
+            std::uint64_t checksum;        // FNV-1a de cabecera (con checksum = 0) + tabla
+        };
+
+        struct LayerRecord {
+            std::uint32_t kind;
+            std::uint32_t reserved;
+            std::uint64_t in_features;     // 0 en las activaciones
+            std::uint64_t out_features;
+            double        param;           // alpha de LeakyReLU
+            std::uint64_t weights_offset;
+            std::uint64_t bias_offset;
+        };
+
+        static_assert(sizeof(ModelHeader) == 64, "ModelHeader must be 64 bytes");
+        static_assert(sizeof(LayerRecord) == 48, "LayerRecord must be 48 bytes");
+        static_assert(std::is_trivially_copyable_v<ModelHeader> &&
+                      std::is_trivially_copyable_v<LayerRecord>);
+
+        inline std::uint64_t align_up(std::uint64_t n) noexcept {
+            return (n + alignment - 1) / alignment * alignment;
+        }
+
+        inline std::uint64_t fnv1a(const void* data, std::size_t n,
+                                   std::uint64_t h = 14695981039346656037ull) noexcept {
+            auto* p = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+            return h;
+        }
+
+        inline std::uint64_t checksum(ModelHeader h, const LayerRecord* table) noexcept {
+            h.checksum = 0;
+            return fnv1a(table, h.layer_count * sizeof(LayerRecord), fnv1a(&h, sizeof(h)));
+        }
+    }
+
+    enum class LoadMode {
+        map,    // mmap MAP_PRIVATE: pesos compartidos vía page cache, copia al escribir
+        copy    // lee el archivo y copia cada tensor a memoria propia
+    };
+
+    namespace detail {
+        // Archivo completo en memoria: mapeado (map) o leído a un buffer (copy).
+        // Con copy_on_write el mapeo es MAP_PRIVATE escribible; si no, de solo
+        // lectura y compartido (datasets).
+        class MappedFile {
+        public:
+            MappedFile(const std::string& path, LoadMode mode, bool copy_on_write = true) {
+#ifdef UTEC_HAS_MMAP
+                if (mode == LoadMode::map) {
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+                    struct stat st{};
+                    if (::fstat(fd, &st) != 0) {
+                        ::close(fd);
+                        throw std::runtime_error("Cannot stat file: " + path);
+                    }
+                    size_ = static_cast<std::size_t>(st.st_size);
+                    if (size_ != 0) {
+                        // MAP_PRIVATE: las páginas se comparten con el page cache
+                        // mientras nadie las escriba (p. ej. al entrenar el modelo)
+                        void* p = copy_on_write
+                                  ? ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+                                  : ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+                        ::close(fd);
+                        if (p == MAP_FAILED) throw std::runtime_error("Cannot map file: " + path);
+                        data_ = static_cast<unsigned char*>(p);
+                        mapped_ = true;
+                    } else {
+                        ::close(fd);
+                    }
+                    return;
+                }
+#else
+                (void)mode; (void)copy_on_write;
+#endif
+                std::ifstream in(path, std::ios::binary | std::ios::ate);
+                if (!in) throw std::runtime_error("Cannot open file: " + path);
+                size_ = static_cast<std::size_t>(in.tellg());
+                // Buffer alineado igual que los payloads del archivo
+                buffer_.resize(size_ / sizeof(std::uint64_t) + 8);
+                data_ = reinterpret_cast<unsigned char*>(buffer_.data());
+                in.seekg(0);
+                if (!in.read(reinterpret_cast<char*>(data_), static_cast<std::streamsize>(size_)))
+                    throw std::runtime_error("Cannot read file: " + path);
+            }
+
+            ~MappedFile() {
+#ifdef UTEC_HAS_MMAP
+                if (mapped_) ::munmap(data_, size_);
+#endif
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            unsigned char* data() const noexcept { return data_; }
+            std::size_t size() const noexcept { return size_; }
+            bool mapped() const noexcept { return mapped_; }
+
+            // Pide al kernel que lea [offset, offset + len) por adelantado
+            void will_need(std::size_t offset, std::size_t len) const noexcept {
+#ifdef UTEC_HAS_MMAP
+                if (!mapped_ || offset >= size_) return;
+                const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                const std::size_t first = offset / page * page;
+                len = std::min(len + (offset - first), size_ - first);
+                ::madvise(data_ + first, len, MADV_WILLNEED);
+#else
+                (void)offset; (void)len;
+#endif
+            }
+
+        private:
+            unsigned char*             data_ = nullptr;
+            std::size_t                size_ = 0;
+            bool                       mapped_ = false;
+            std::vector<std::uint64_t> buffer_;
+        };
+
+        // Tensor rows x cols del payload: vista sobre el mapeo o copia propia
+        template<typename T>
+        Parameter<T> load_parameter(const std::shared_ptr<MappedFile>& file, std::uint64_t offset,
+                                    std::size_t rows, std::size_t cols) {
+            const std::uint64_t bytes = std::uint64_t(rows) * cols * sizeof(T);
+            if (offset % model_format::alignment != 0 || offset > file->size() ||
+                bytes > file->size() - offset)
+                throw std::runtime_error("Invalid model file: tensor payload out of bounds");
+            T* src = reinterpret_cast<T*>(file->data() + offset);
+            if (file->mapped())
+                return Parameter<T>(utec::algebra::TensorView<T,2>(src, {rows, cols}, {cols, 1}), file);
+            utec::algebra::Tensor<T,2> t(rows, cols);
+            std::memcpy(t.data(), src, bytes);
+            return Parameter<T>(std::move(t));
+        }
+
+        template<typename T>
+        std::unique_ptr<ILayer<T>> load_layer(const std::shared_ptr<MappedFile>& file,
+                                              const model_format::LayerRecord& r) {
+            using model_format::LayerKind;
+            const auto kind = static_cast<LayerKind>(r.kind);
+            switch (kind) {
+                case LayerKind::relu:       return std::make_unique<ReLU<T>>();
+                case LayerKind::sigmoid:    return std::make_unique<Sigmoid<T>>();
+                case LayerKind::tanh:       return std::make_unique<Tanh<T>>();
+                case LayerKind::gelu:       return std::make_unique<GELU<T>>();
+                case LayerKind::leaky_relu: return std::make_unique<LeakyReLU<T>>(static_cast<T>(r.param));
+                case LayerKind::dense:
+                case LayerKind::dense_relu:
+                case LayerKind::dense_sigmoid:
+                case LayerKind::dense_tanh:
+                    break;
+                default:
+                    throw std::runtime_error("Invalid model file: unknown layer kind");
+            }
+            const std::size_t in_f = r.in_features, out_f = r.out_features;
+            if (in_f == 0 || out_f == 0)
+                throw std::runtime_error("Invalid model file: empty Dense layer");
+            auto w = load_parameter<T>(file, r.weights_offset, in_f, out_f);
+            auto b = load_parameter<T>(file, r.bias_offset, 1, out_f);
+            switch (kind) {
+                case LayerKind::dense_relu:    return std::make_unique<DenseReLU<T>>(std::move(w), std::move(b));
+                case LayerKind::dense_sigmoid: return std::make_unique<DenseSigmoid<T>>(std::move(w), std::move(b));
+                case LayerKind::dense_tanh:    return std::make_unique<DenseTanh<T>>(std::move(w), std::move(b));
+                default:                       return std::make_unique<Dense<T>>(std::move(w), std::move(b));
+            }
+        }
+
+        // Registro de una capa para save_model (tensores a escribir aparte)
+        template<typename T>
+        struct SavedLayer {
+            model_format::LayerRecord            record{};
+            utec::algebra::TensorView<const T,2> weights, bias;
+        };
+
+        template<typename T>
+        SavedLayer<T> describe_layer(const ILayer<T>* layer) {
+            using model_format::LayerKind;
+            SavedLayer<T> s;
+            auto with_params = [&](LayerKind kind, auto* d) {
+                s.record.kind = static_cast<std::uint32_t>(kind);
+                s.record.in_features  = d->in_features();
+                s.record.out_features = d->out_features();
+                s.weights = d->weights();
+                s.bias    = d->bias();
+            };
+            if (auto* d = dynamic_cast<const Dense<T>*>(layer))               with_params(LayerKind::dense, d);
+            else if (auto* r = dynamic_cast<const DenseReLU<T>*>(layer))      with_params(LayerKind::dense_relu, r);
+            else if (auto* g = dynamic_cast<const DenseSigmoid<T>*>(layer))   with_params(LayerKind::dense_sigmoid, g);
+            else if (auto* t = dynamic_cast<const DenseTanh<T>*>(layer))      with_params(LayerKind::dense_tanh, t);
+            else if (dynamic_cast<const ReLU<T>*>(layer))    s.record.kind = static_cast<std::uint32_t>(LayerKind::relu);
+            else if (dynamic_cast<const Sigmoid<T>*>(layer)) s.record.kind = static_cast<std::uint32_t>(LayerKind::sigmoid);
+            else if (dynamic_cast<const Tanh<T>*>(layer))    s.record.kind = static_cast<std::uint32_t>(LayerKind::tanh);
+            else if (dynamic_cast<const GELU<T>*>(layer))    s.record.kind = static_cast<std::uint32_t>(LayerKind::gelu);
+            else if (auto* l = dynamic_cast<const LeakyReLU<T>*>(layer)) {
+                s.record.kind  = static_cast<std::uint32_t>(LayerKind::leaky_relu);
+                s.record.param = static_cast<double>(l->alpha());
+            } else {
+                throw std::invalid_argument("Layer type is not supported by save_model()");
+            }
+            if (s.weights.data() && !(s.weights.is_contiguous() && s.bias.is_contiguous()))
+                throw std::logic_error("Dense parameters must be contiguous to be saved");
+            return s;
+        }
+    }
+
+    // Guarda topología y pesos. Escribe a un temporal y lo renombra, así que
+    // los procesos que tengan mapeada la versión anterior no ven cambios.
+    template<typename T>
+    void save_model(const NeuralNetwork<T>& net, const std::string& path) {
+        using namespace model_format;
+        static_assert(std::is_floating_point_v<T>, "Only floating-point models can be saved");
+        std::vector<detail::SavedLayer<T>> layers;
+        for (const auto& layer : net.layers()) layers.push_back(detail::describe_layer(layer.get()));
+
+        std::vector<LayerRecord> table;
+        std::uint64_t offset = align_up(sizeof(ModelHeader) + layers.size() * sizeof(LayerRecord));
+        const std::uint64_t payload_offset = offset;
+        for (auto& l : layers) {
+            if (l.weights.data()) {
+                l.record.weights_offset = offset;
+                offset = align_up(offset + l.weights.size() * sizeof(T));
+                l.record.bias_offset = offset;
+                offset = align_up(offset + l.bias.size() * sizeof(T));
+            }
+            table.push_back(l.record);
+        }
+
+        ModelHeader h{};
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version        = version;
+        h.endian_tag     = endian_tag;
+        h.scalar_size    = sizeof(T);
+        h.layer_count    = static_cast<std::uint32_t>(layers.size());
+        h.alignment      = static_cast<std::uint32_t>(alignment);
+        h.table_offset   = sizeof(ModelHeader);
+        h.payload_offset = payload_offset;
+        h.file_size      = offset;
+        h.checksum       = checksum(h, table.data());
+
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("Cannot create model file: " + tmp);
+            const char zeros[alignment] = {};
+            std::uint64_t pos = 0;
+            auto put = [&](const void* p, std::uint64_t n) {
+                out.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+                pos += n;
+            };
+            auto pad_to = [&](std::uint64_t target) { put(zeros, target - pos); };
+            put(&h, sizeof(h));
+            put(table.data(), table.size() * sizeof(LayerRecord));
+            for (const auto& l : layers) {
+                if (!l.weights.data()) continue;
+                pad_to(l.record.weights_offset);
+                put(l.weights.data(), l.weights.size() * sizeof(T));
+                pad_to(l.record.bias_offset);
+                put(l.bias.data(), l.bias.size() * sizeof(T));
+            }
+            pad_to(h.file_size);
+            if (!out.flush()) throw std::runtime_error("Cannot write model file: " + tmp);
+        }
+        std::filesystem::rename(tmp, path);
+    }
+
+    // Carga un modelo guardado con save_model. En modo map los Parameter de
+    // cada Dense apuntan directamente al archivo mapeado (el mapeo vive
+    // mientras alguna capa lo use); entrenar la red copia los pesos a su arena.
+    template<typename T>
+    NeuralNetwork<T> load_model(const std::string& path, LoadMode mode = LoadMode::map) {
+        using namespace model_format;
+        auto file = std::make_shared<detail::MappedFile>(path, mode);
+        if (file->size() < sizeof(ModelHeader))
+            throw std::runtime_error("Invalid model file: truncated header");
+        ModelHeader h;
+        std::memcpy(&h, file->data(), sizeof(h));
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("Invalid model file: bad magic");
+        if (h.version != version)
+            throw std::runtime_error("Unsupported model file version " + std::to_string(h.version));
+        if (h.endian_tag != endian_tag)
+            throw std::runtime_error("Model file has a different byte order");
+        if (h.scalar_size != sizeof(T))
+            throw std::invalid_argument("Model scalar type does not match the requested network type");
+        if (h.alignment != alignment || h.file_size != file->size() ||
+            h.table_offset != sizeof(ModelHeader) ||
+            h.layer_count > (file->size() - sizeof(ModelHeader)) / sizeof(LayerRecord))
+            throw std::runtime_error("Invalid model file: inconsistent header");
+
+        std::vector<LayerRecord> table(h.layer_count);
+        std::memcpy(table.data(), file->data() + h.table_offset, table.size() * sizeof(LayerRecord));
+        if (checksum(h, table.data()) != h.checksum)
+            throw std::runtime_error("Invalid model file: checksum mismatch");
+
+        NeuralNetwork<T> net;
+        for (const auto& r : table) net.add_layer(detail::load_layer<T>(file, r));
+        return net;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_NN_SERIALIZATION_H
@@ -0,0 +1,344 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_NN_STATIC_H
+#define EPIC1_OFICIAL_NN_STATIC_H
+
+#include "nn_dense (5).h"
+#include "nn_activation (3).h"
+#include "nn_loss (5).h"
+#include "nn_optimizer (5).h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+// Redes de topología fija para modelos diminutos (p. ej. 1→10→1): formas en
+// tiempo de compilación, parámetros en un std::array plano y forward/backward
+// encadenados sin despacho virtual ni reservas en el heap. Pensado para
+// ejecutar muchísimos micro-modelos, donde el coste de Tensor y de ILayer
+// supera al de la aritmética.
+
+namespace utec::neural_network {
+
+    // Dense de In→Out con activación opcional fusionada (mismo layout que
+    // Dense: W fila mayor In×Out seguido del bias)
+    template<typename T, std::size_t In, std::size_t Out, typename Act = IdentityOp<T>>
+    struct StaticDense {
+        static_assert(In > 0 && Out > 0, "StaticDense needs non-zero dimensions");
+        static constexpr std::size_t in = In, out = Out;
+        static constexpr std::size_t param_count = In * Out + Out;
+        static constexpr bool has_weights = true;
+
+        // y = act(x·W + b)
+        static void forward(const T* p, const T* x, T* y) noexcept {
+            const T* w = p;
+            const T* b = p + In * Out;
+            for (std::size_t j = 0; j < Out; ++j) y[j] = T(0);
+            for (std::size_t i = 0; i < In; ++i) {
+                const T xi = x[i];
+#pragma GCC unroll 16
+                for (std::size_t j = 0; j < Out; ++j) y[j] += xi * w[i * Out + j];
+            }
+#pragma GCC unroll 16
+            for (std::size_t j = 0; j < Out; ++j) y[j] = Act::apply(y[j] + b[j]);
+        }
+
+        // g (gradiente de la salida) se reutiliza como dZ; acumula en gp y,
+        // si NeedDx, escribe el gradiente de la entrada en dx
+        template<bool NeedDx>
+        static void backward(const T* p, T* gp, const T* x, const T* y, T* g, T* dx) noexcept {
+            const T* w = p;
+            T* gw = gp;
+            T* gb = gp + In * Out;
+#pragma GCC unroll 16
+            for (std::size_t j = 0; j < Out; ++j) {
+                g[j] *= Act::derivative(y[j]);
+                gb[j] += g[j];
+            }
+            for (std::size_t i = 0; i < In; ++i) {
+                const T xi = x[i];
+                T acc = T(0);
+#pragma GCC unroll 16
+                for (std::size_t j = 0; j < Out; ++j) {
+                    gw[i * Out + j] += xi * g[j];
+                    if constexpr (NeedDx) acc += g[j] * w[i * Out + j];
+                }
+                if constexpr (NeedDx) dx[i] = acc;
+            }
+        }
+    };
+
+    // Activación elemento a elemento sobre N valores
+    template<typename T, std::size_t N, typename Op>
+    struct StaticActivation {
+        static_assert(N > 0, "StaticActivation needs a non-zero width");
+        static constexpr std::size_t in = N, out = N;
+        static constexpr std::size_t param_count = 0;
+        static constexpr bool has_weights = false;
+
+        static void forward(const T*, const T* x, T* y) noexcept {
+#pragma GCC unroll 16
+            for (std::size_t i = 0; i < N; ++i) y[i] = Op::apply(x[i]);
+        }
+
+        // La derivada se evalúa sobre la salida (válido para ReLU, Sigmoid y Tanh)
+        template<bool NeedDx>
+        static void backward(const T*, T*, const T*, const T* y, T* g, T* dx) noexcept {
+            if constexpr (NeedDx) {
+#pragma GCC unroll 16
+                for (std::size_t i = 0; i < N; ++i) dx[i] = g[i] * Op::derivative(y[i]);
+            }
+        }
+    };
+
+    template<typename T, std::size_t N> using StaticReLU    = StaticActivation<T, N, ReLUOp<T>>;
+    template<typename T, std::size_t N> using StaticSigmoid = StaticActivation<T, N, SigmoidOp<T>>;
+    template<typename T, std::size_t N> using StaticTanh    = StaticActivation<T, N, TanhOp<T>>;
+
+    namespace detail {
+        // Pérdidas por elemento equivalentes a las de nn_loss: valor y derivada
+        // respecto a la predicción (sin el factor 1/n, que aplica la red)
+        template<template<typename...> class Loss>
+        struct static_loss;
+
+        template<>
+        struct static_loss<MSELoss> {
+            template<typename T> static T value(T p, T y) noexcept { return (p - y) * (p - y); }
+            template<typename T> static T grad(T p, T y) noexcept { return T(2) * (p - y); }
+        };
+
+        template<>
+        struct static_loss<BCELoss> {
+            template<typename T> static constexpr T eps = T(1e-12);
+            template<typename T> static T value(T p, T y) noexcept {
+                return -(y * std::log(p + eps<T>) + (T(1) - y) * std::log(T(1) - p + eps<T>));
+            }
+            template<typename T> static T grad(T p, T y) noexcept {
+                return -(y / (p + eps<T>)) + (T(1) - y) / (T(1) - p + eps<T>);
+            }
+        };
+
+        template<>
+        struct static_loss<BCEWithLogitsLoss> {
+            template<typename T> static T value(T z, T y) noexcept {
+                return std::max(z, T(0)) - z * y + std::log1p(std::exp(-std::abs(z)));
+            }
+            template<typename T> static T grad(T z, T y) noexcept {
+                const T e = std::exp(-std::abs(z));
+                return (z > T(0) ? T(1) / (T(1) + e) : e / (T(1) + e)) - y;
+            }
+        };
+
+        template<typename... Layers, std::size_t... I>
+        constexpr bool static_chain_ok(std::index_sequence<I...>) {
+            constexpr std::array<std::size_t, sizeof...(Layers)> ins{Layers::in...};
+            constexpr std::array<std::size_t, sizeof...(Layers)> outs{Layers::out...};
+            return ((outs[I] == ins[I + 1]) && ...);
+        }
+
+        template<std::size_t N>
+        constexpr std::array<std::size_t, N + 1> exclusive_scan(const std::array<std::size_t, N>& v) {
+            std::array<std::size_t, N + 1> r{};
+            for (std::size_t i = 0; i < N; ++i) r[i + 1] = r[i] + v[i];
+            return r;
+        }
+    }
+
+    // Red estática: StaticNetwork<float, StaticDense<float,1,10,ReLUOp<float>>,
+    // StaticDense<float,10,1>>. Las formas se comprueban al compilar y el
+    // objeto solo contiene los parámetros; las activaciones y gradientes de
+    // train viven en la pila. El entrenamiento reproduce el de NeuralNetwork
+    // (mismo barajado con el mismo generador, misma pérdida y optimizador),
+    // con diferencias solo de redondeo por el orden de las sumas.
+    template<typename T, typename... Layers>
+    class StaticNetwork {
+        static_assert(sizeof...(Layers) > 0, "StaticNetwork needs at least one layer");
+        static_assert(detail::static_chain_ok<Layers...>(std::make_index_sequence<sizeof...(Layers) - 1>{}),
+                      "Each layer's input width must match the previous layer's output width");
+
+        template<std::size_t I> using layer_t = std::tuple_element_t<I, std::tuple<Layers...>>;
+
+        static constexpr std::size_t depth = sizeof...(Layers);
+        static constexpr auto param_offsets =
+                detail::exclusive_scan(std::array<std::size_t, depth>{Layers::param_count...});
+        static constexpr auto act_offsets =
+                detail::exclusive_scan(std::array<std::size_t, depth>{Layers::out...});
+        static constexpr std::size_t max_width = std::max({layer_t<0>::in, Layers::out...});
+
+    public:
+        static constexpr std::size_t in_features     = layer_t<0>::in;
+        static constexpr std::size_t out_features    = layer_t<depth - 1>::out;
+        static constexpr std::size_t parameter_count = param_offsets[depth];
+        static constexpr std::size_t activation_count = act_offsets[depth];
+
+        using input_type  = std::array<T, in_features>;
+        using output_type = std::array<T, out_features>;
+
+        StaticNetwork() noexcept { params_.fill(T(0)); }
+
+        // Mismos inicializadores que Dense (reciben un Tensor<T,2> In×Out y
+        // uno 1×Out), aplicados capa a capa en orden
+        template<typename InitWFun, typename InitBFun>
+        StaticNetwork(InitWFun init_w_fun, InitBFun init_b_fun) {
+            params_.fill(T(0));
+            initialize<0>(init_w_fun, init_b_fun);
+        }
+
+        // Parámetros planos (capa a capa, W y luego b)
+        std::array<T, parameter_count>& parameters() noexcept { return params_; }
+        const std::array<T, parameter_count>& parameters() const noexcept { return params_; }
+
+        template<std::size_t I>
+        utec::algebra::TensorView<T,2> weights() noexcept {
+            static_assert(layer_t<I>::has_weights, "Layer has no weights");
+            return {params_.data() + param_offsets[I], {layer_t<I>::in, layer_t<I>::out}, {layer_t<I>::out, 1}};
+        }
+        template<std::size_t I>
+        utec::algebra::TensorView<T,2> bias() noexcept {
+            static_assert(layer_t<I>::has_weights, "Layer has no bias");
+            return {params_.data() + param_offsets[I] + layer_t<I>::in * layer_t<I>::out,
+                    {1, layer_t<I>::out}, {layer_t<I>::out, 1}};
+        }
+
+        // Inferencia de una muestra: sin heap, sin estado compartido
+        void predict(const T* x, T* y) const noexcept {
+            std::array<T, activation_count> acts;
+            forward_from<0>(x, acts.data());
+            const T* out = acts.data() + act_offsets[depth - 1];
+            std::copy(out, out + out_features, y);
+        }
+
+        output_type predict(const input_type& x) const noexcept {
+            output_type y;
+            predict(x.data(), y.data());
+            return y;
+        }
+
+        utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X) const {
+            check_features(X, in_features, "Input");
+            const std::size_t n = X.shape()[0];
+            utec::algebra::Tensor<T,2> out(n, out_features);
+            for (std::size_t i = 0; i < n; ++i)
+                predict(X.data() + i * in_features, out.data() + i * out_features);
+            return out;
+        }
+
+        template <template <typename...> class LossType>
+        T evaluate(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y) const {
+            const auto out = predict(X);
+            return LossType<T>(out, Y).loss();
+        }
+
+        // Un paso de optimización sobre rows muestras contiguas; devuelve la
+        // pérdida media del lote
+        template <template <typename...> class LossType, typename Optimizer>
+        T train_batch(const T* X, const T* Y, std::size_t rows, Optimizer& optimizer) {
+            return step<LossType>(X, Y, nullptr, rows, optimizer);
+        }
+
+        // Igual que NeuralNetwork::train, pero el generador del barajado lo
+        // aporta el llamador (para no guardar un mt19937 en cada modelo);
+        // devuelve la pérdida media de la última época
+        template <template <typename...> class LossType,
+                template <typename...> class OptimizerType = SGD, typename URBG>
+        T train(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y,
+                std::size_t epochs, std::size_t batch_size, T learning_rate, URBG& rng) {
+            check_features(X, in_features, "Input");
+            check_features(Y, out_features, "Target");
+            const std::size_t n = X.shape()[0];
+            if (Y.shape()[0] != n)
+                throw std::invalid_argument("X and Y must have the same number of rows");
+            if (n == 0) return T(0);
+            const std::size_t bs = (batch_size == 0 || batch_size > n) ? n : batch_size;
+
+            OptimizerType<T> optimizer(learning_rate);
+            std::vector<std::size_t> order(n);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            T last = T(0);
+            for (std::size_t e = 0; e < epochs; ++e) {
+                std::shuffle(order.begin(), order.end(), rng);
+                T epoch_loss = T(0);
+                for (std::size_t first = 0; first < n; first += bs) {
+                    const std::size_t count = std::min(bs, n - first);
+                    epoch_loss += step<LossType>(X.data(), Y.data(), order.data() + first, count, optimizer)
+                                  * static_cast<T>(count);
+                }
+                last = epoch_loss / static_cast<T>(n);
+            }
+            return last;
+        }
+
+    private:
+        std::array<T, parameter_count> params_;
+
+        static void check_features(const utec::algebra::Tensor<T,2>& t, std::size_t cols, const char* what) {
+            if (t.shape()[1] != cols)
+                throw std::invalid_argument(std::string(what) + " width does not match the static network");
+        }
+
+        template<std::size_t I, typename InitWFun, typename InitBFun>
+        void initialize(InitWFun& init_w_fun, InitBFun& init_b_fun) {
+            using L = layer_t<I>;
+            if constexpr (L::has_weights) {
+                utec::algebra::Tensor<T,2> w(L::in, L::out), b(1, L::out);
+                init_w_fun(w);
+                init_b_fun(b);
+                T* p = params_.data() + param_offsets[I];
+                std::copy(w.data(), w.data() + w.size(), p);
+                std::copy(b.data(), b.data() + b.size(), p + L::in * L::out);
+            }
+            if constexpr (I + 1 < depth) initialize<I + 1>(init_w_fun, init_b_fun);
+        }
+
+        template<std::size_t I>
+        void forward_from(const T* x, T* acts) const noexcept {
+            layer_t<I>::forward(params_.data() + param_offsets[I], x, acts + act_offsets[I]);
+            if constexpr (I + 1 < depth) forward_from<I + 1>(acts + act_offsets[I], acts);
+        }
+
+        // g entra con el gradiente de la salida de la capa I; los buffers se
+        // alternan como en NeuralNetwork::train_step
+        template<std::size_t I>
+        void backward_from(const T* x, const T* acts, T* grads, T* g, T* dx) const noexcept {
+            const T* in = I == 0 ? x : acts + act_offsets[I == 0 ? 0 : I - 1];
+            layer_t<I>::template backward<(I > 0)>(params_.data() + param_offsets[I], grads + param_offsets[I],
+                                                   in, acts + act_offsets[I], g, dx);
+            if constexpr (I > 0) backward_from<I - 1>(x, acts, grads, dx, g);
+        }
+
+        // rows filas de X/Y (en el orden de idx si no es nulo): gradiente
+        // medio acumulado muestra a muestra y un paso del optimizador
+        template <template <typename...> class LossType, typename Optimizer>
+        T step(const T* X, const T* Y, const std::size_t* idx, std::size_t rows, Optimizer& optimizer) {
+            using L = detail::static_loss<LossType>;
+            std::array<T, parameter_count> grads{};
+            std::array<T, activation_count> acts;
+            std::array<T, max_width> g0, g1;
+            const T scale = T(1) / static_cast<T>(rows * out_features);
+            T loss = T(0);
+            for (std::size_t r = 0; r < rows; ++r) {
+                const std::size_t row = idx ? idx[r] : r;
+                const T* x = X + row * in_features;
+                const T* y = Y + row * out_features;
+                forward_from<0>(x, acts.data());
+                const T* p = acts.data() + act_offsets[depth - 1];
+                for (std::size_t j = 0; j < out_features; ++j) {
+                    loss += L::template value<T>(p[j], y[j]);
+                    g0[j] = scale * L::template grad<T>(p[j], y[j]);
+                }
+                backward_from<depth - 1>(x, acts.data(), grads.data(), g0.data(), g1.data());
+            }
+            optimizer.step(params_.data(), grads.data(), parameter_count);
+            return loss * scale;
+        }
+    };
+
+}
+
+#endif //EPIC1_OFICIAL_NN_STATIC_H
@@ -16,9 +16,234 @@
 #include <algorithm>
 #include <type_traits>
 #include <string>
+#include <atomic>
+#include <new>
+#include "tensor_gemm.h"
+#include "tensor_expr.h"
 
 namespace utec::algebra {
 
+    // Contadores globales de reservas de memoria de Tensor (todas las hebras)
+    struct AllocationStats {
+        std::size_t allocations   = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes         = 0;
+    };
+
+    namespace detail {
+
+        struct allocation_counters {
+            std::atomic<std::size_t> allocations{0}, deallocations{0}, bytes{0};
+        };
+        inline allocation_counters& counters() noexcept {
+            static allocation_counters c;
+            return c;
+        }
+
+        // Allocator de Tensor: alinea a 64 bytes (SIMD) y cuenta cada reserva
+        template <typename T>
+        struct counting_allocator {
+            using value_type = T;
+            static constexpr std::size_t alignment = 64;
+
+            counting_allocator() noexcept = default;
+            template <typename U>
+            counting_allocator(const counting_allocator<U>&) noexcept {}
+
+            T* allocate(std::size_t n) {
+                auto& c = counters();
+                c.allocations.fetch_add(1, std::memory_order_relaxed);
+                c.bytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+            }
+            void deallocate(T* p, std::size_t) noexcept {
+                counters().deallocations.fetch_add(1, std::memory_order_relaxed);
+                ::operator delete(p, std::align_val_t(alignment));
+            }
+            template <typename U>
+            bool operator==(const counting_allocator<U>&) const noexcept { return true; }
+            template <typename U>
+            bool operator!=(const counting_allocator<U>&) const noexcept { return false; }
+        };
+
+        template <std::size_t Rank>
+        constexpr std::array<std::size_t, Rank> row_major_strides(const std::array<std::size_t, Rank>& s) {
+            std::array<std::size_t, Rank> st{};
+            std::size_t acc = 1;
+            for (std::size_t i = Rank; i-- > 0;) {
+                st[i] = acc;
+                acc  *= s[i];
+            }
+            return st;
+        }
+
+        // Odometro sobre todos los ejes menos el ultimo: llama a
+        // row(off_a, off_b, off_out, n) por cada fila interna de n elementos,
+        // actualizando los offsets de forma incremental (sin div/mod).
+        template <std::size_t Rank, typename Row>
+        void for_each_row(const std::array<std::size_t, Rank>& shape,
+                          const std::array<std::size_t, Rank>& sa,
+                          const std::array<std::size_t, Rank>& sb, Row&& row) {
+            std::size_t outer = 1;
+            for (std::size_t i = 0; i + 1 < Rank; ++i) outer *= shape[i];
+            const std::size_t n = shape[Rank-1];
+            if (outer == 0 || n == 0) return;
+            std::array<std::size_t, Rank> idx{};
+            std::size_t oa = 0, ob = 0, out = 0;
+            for (std::size_t r = 0; r < outer; ++r, out += n) {
+                row(oa, ob, out, n);
+                for (std::size_t d = Rank - 1; d-- > 0;) {
+                    if (++idx[d] < shape[d]) { oa += sa[d]; ob += sb[d]; break; }
+                    idx[d] = 0;
+                    oa -= sa[d] * (shape[d] - 1);
+                    ob -= sb[d] * (shape[d] - 1);
+                }
+            }
+        }
+
+        // Kernel binario con broadcasting. Mismas formas y buffers contiguos:
+        // bucle plano vectorizable. Si no: strides 0 en los ejes difundidos y
+        // odometro por filas, con la fila interna especializada por stride.
+        template <std::size_t Rank, typename TA, typename TB, typename TR, typename Op>
+        void binary_kernel(const std::array<std::size_t, Rank>& rshape, TR* out,
+                           const TA* pa, const std::array<std::size_t, Rank>& shape_a,
+                           const std::array<std::size_t, Rank>& strides_a,
+                           const TB* pb, const std::array<std::size_t, Rank>& shape_b,
+                           const std::array<std::size_t, Rank>& strides_b,
+                           bool contiguous, Op op) {
+            if (contiguous && shape_a == shape_b) {
+                std::size_t n = 1;
+                for (auto v : rshape) n *= v;
+                for (std::size_t i = 0; i < n; ++i) out[i] = op(pa[i], pb[i]);
+                return;
+            }
+            std::array<std::size_t, Rank> sa{}, sb{};
+            for (std::size_t i = 0; i < Rank; ++i) {
+                sa[i] = shape_a[i] == 1 ? 0 : strides_a[i];
+                sb[i] = shape_b[i] == 1 ? 0 : strides_b[i];
+            }
+            const std::size_t ia = sa[Rank-1], ib = sb[Rank-1];
+            for_each_row<Rank>(rshape, sa, sb,
+                [&](std::size_t oa, std::size_t ob, std::size_t o, std::size_t n) {
+                    const TA* ra = pa + oa;
+                    const TB* rb = pb + ob;
+                    TR* ro = out + o;
+                    if (ia == 1 && ib == 1)
+                        for (std::size_t j = 0; j < n; ++j) ro[j] = op(ra[j], rb[j]);
+                    else if (ia == 1 && ib == 0)
+                        for (std::size_t j = 0; j < n; ++j) ro[j] = op(ra[j], *rb);
+                    else if (ia == 0 && ib == 1)
+                        for (std::size_t j = 0; j < n; ++j) ro[j] = op(*ra, rb[j]);
+                    else
+                        for (std::size_t j = 0; j < n; ++j) ro[j] = op(ra[j*ia], rb[j*ib]);
+                });
+        }
+
+        // Broadcasting: cada eje debe coincidir o valer 1
+        template <std::size_t Rank>
+        std::array<std::size_t, Rank> broadcast_shape(const std::array<std::size_t, Rank>& a,
+                                                      const std::array<std::size_t, Rank>& b) {
+            std::array<std::size_t, Rank> r{};
+            for (std::size_t i = 0; i < Rank; ++i) {
+                if      (a[i] == b[i]) r[i] = a[i];
+                else if (a[i] == 1)    r[i] = b[i];
+                else if (b[i] == 1)    r[i] = a[i];
+                else throw std::invalid_argument(
+                            "Shapes do not match and are not compatible for broadcasting");
+            }
+            return r;
+        }
+
+    }
+
+    // Vista no propietaria: comparte el buffer y lleva su propia forma y
+    // strides, asi que transpuestas, rebanadas de filas y reshapes no copian.
+    template <typename T, std::size_t Rank>
+    class TensorView {
+    public:
+        using Shape      = std::array<std::size_t, Rank>;
+        using value_type = std::remove_const_t<T>;
+
+        TensorView() noexcept = default;
+        TensorView(T* data, const Shape& shape, const Shape& strides) noexcept
+                : data_(data), shape_(shape), strides_(strides) {}
+
+        // Vista mutable -> vista de solo lectura
+        template <typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+        operator TensorView<const U, Rank>() const noexcept {
+            return TensorView<const U, Rank>(data_, shape_, strides_);
+        }
+
+        template <typename... Idxs, typename = std::enable_if_t<sizeof...(Idxs) == Rank>>
+        T& operator()(Idxs... idxs) const {
+            Shape idx{ static_cast<std::size_t>(idxs)... };
+            std::size_t off = 0;
+            for (std::size_t i = 0; i < Rank; ++i)
+                off += idx[i] * strides_[i];
+            return data_[off];
+        }
+
+        T* data() const noexcept { return data_; }
+        const Shape& shape() const noexcept { return shape_; }
+        const Shape& strides() const noexcept { return strides_; }
+
+        std::size_t size() const noexcept {
+            std::size_t n = 1;
+            for (auto v : shape_) n *= v;
+            return n;
+        }
+
+        bool is_contiguous() const noexcept {
+            std::size_t acc = 1;
+            for (std::size_t i = Rank; i-- > 0;) {
+                if (shape_[i] != 1 && strides_[i] != acc) return false;
+                acc *= shape_[i];
+            }
+            return true;
+        }
+
+        // Transpuesta perezosa (swap de los dos ultimos ejes, solo strides)
+        TensorView transpose_2d() const {
+            if constexpr (Rank < 2) {
+                throw std::invalid_argument("Cannot transpose 1D tensor: need at least 2 dimensions");
+            } else {
+                TensorView r = *this;
+                std::swap(r.shape_[Rank-2],   r.shape_[Rank-1]);
+                std::swap(r.strides_[Rank-2], r.strides_[Rank-1]);
+                return r;
+            }
+        }
+
+        // Rango [first, first + count) sobre el primer eje
+        TensorView slice(std::size_t first, std::size_t count) const {
+            if (first + count > shape_[0])
+                throw std::out_of_range("Slice exceeds the first dimension");
+            Shape s = shape_;
+            s[0] = count;
+            return TensorView(data_ + first * strides_[0], s, strides_);
+        }
+
+        // Reinterpreta la forma (solo vistas contiguas)
+        template <std::size_t R2>
+        TensorView<T, R2> reshape(const std::array<std::size_t, R2>& new_shape) const {
+            if (!is_contiguous())
+                throw std::invalid_argument("Cannot reshape a non-contiguous view");
+            std::size_t n = 1;
+            for (auto v : new_shape) n *= v;
+            if (n != size())
+                throw std::invalid_argument("Data size does not match tensor size");
+            return TensorView<T, R2>(data_, new_shape, detail::row_major_strides(new_shape));
+        }
+        template <typename... Dims>
+        auto reshape(Dims... dims) const {
+            return reshape(std::array<std::size_t, sizeof...(Dims)>{ static_cast<std::size_t>(dims)... });
+        }
+
+    private:
+        T*    data_ = nullptr;
+        Shape shape_{}, strides_{};
+    };
+
     template <typename T, std::size_t Rank>
     class Tensor {
     public:
@@ -48,6 +273,25 @@ namespace utec::algebra {
             }
         }
 
+        // 4) Materializa una vista (con cualquier stride) en un tensor contiguo
+        template <typename U, typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+        explicit Tensor(const TensorView<U, Rank>& v)
+                : Tensor(v.shape()) {
+            const U* src = v.data();
+            const std::size_t inner = v.strides()[Rank-1];
+            detail::for_each_row<Rank>(shape_, v.strides(), strides_,
+                [&](std::size_t off, std::size_t, std::size_t out, std::size_t n) {
+                    for (std::size_t j = 0; j < n; ++j)
+                        data_[out + j] = src[off + j*inner];
+                });
+        }
+
+        // Vistas sobre el propio buffer (también como conversión implícita)
+        TensorView<T, Rank> view() noexcept { return { data_.data(), shape_, strides_ }; }
+        TensorView<const T, Rank> view() const noexcept { return { data_.data(), shape_, strides_ }; }
+        operator TensorView<T, Rank>() noexcept { return view(); }
+        operator TensorView<const T, Rank>() const noexcept { return view(); }
+
         // Acceso variádico
         template <typename... Idxs, typename = std::enable_if_t<sizeof...(Idxs) == Rank>>
         T& operator()(Idxs... idxs) {
@@ -66,6 +310,10 @@ namespace utec::algebra {
         auto cbegin() const noexcept { return data_.cbegin(); }
         auto cend()   const noexcept { return data_.cend();   }
 
+        // Acceso crudo al buffer contiguo (row-major)
+        T* data() noexcept             { return data_.data(); }
+        const T* data() const noexcept { return data_.data(); }
+
         // Nuevo: tamaño total de elementos
         std::size_t size() const noexcept { return data_.size(); }
 
@@ -106,79 +354,38 @@ namespace utec::algebra {
 
         // Operación elemento a elemento con broadcasting
         Tensor elementwise_op(const Tensor& other, auto op) const {
-            Shape rshape;
-            for (std::size_t i = 0; i < Rank; ++i) {
-                auto s1 = shape_[i], s2 = other.shape_[i];
-                if      (s1 == s2) rshape[i] = s1;
-                else if (s1 == 1)  rshape[i] = s2;
-                else if (s2 == 1)  rshape[i] = s1;
-                else throw std::invalid_argument(
-                            "Shapes do not match and are not compatible for broadcasting");
-            }
-            Tensor result(rshape);
-            std::array<std::size_t, Rank> idx;
-            for (std::size_t lin = 0, tot = result.data_.size(); lin < tot; ++lin) {
-                std::size_t rem = lin;
-                for (std::size_t i = 0; i < Rank; ++i) {
-                    idx[i] = rem / result.strides_[i];
-                    rem    %= result.strides_[i];
-                }
-                std::size_t off1 = 0, off2 = 0;
-                for (std::size_t i = 0; i < Rank; ++i) {
-                    auto id = (shape_[i] == 1 ? 0 : idx[i]);
-                    off1 += id * strides_[i];
-                    auto jd = (other.shape_[i] == 1 ? 0 : idx[i]);
-                    off2 += jd * other.strides_[i];
-                }
-                result.data_[lin] = op(data_[off1], other.data_[off2]);
-            }
+            Tensor result(detail::broadcast_shape(shape_, other.shape_));
+            detail::binary_kernel<Rank>(result.shape_, result.data_.data(),
+                                        data_.data(), shape_, strides_,
+                                        other.data_.data(), other.shape_, other.strides_,
+                                        true, op);
             return result;
         }
 
-        Tensor operator+(const Tensor& o) const { return elementwise_op(o, std::plus<>()); }
-        Tensor operator-(const Tensor& o) const { return elementwise_op(o, std::minus<>()); }
-        Tensor operator*(const Tensor& o) const { return elementwise_op(o, std::multiplies<>()); }
-
-        // Operaciones escalares
-        Tensor operator*(const T& s) const {
-            Tensor r(shape_);
-            for (std::size_t i = 0; i < data_.size(); ++i) r.data_[i] = data_[i] * s;
-            return r;
-        }
-        Tensor operator/(const T& s) const {
-            Tensor r(shape_);
-            for (std::size_t i = 0; i < data_.size(); ++i) r.data_[i] = data_[i] / s;
-            return r;
-        }
-        Tensor operator+(const T& s) const noexcept {
-            Tensor r(shape_);
-            for (std::size_t i = 0; i < data_.size(); ++i) r.data_[i] = data_[i] + s;
-            return r;
+        // Aritmética (+, -, *, / con tensores o escalares): ver tensor_expr.h.
+        // Se evalúa en una sola pasada al construir o asignar un Tensor.
+        template <typename E, typename = std::enable_if_t<expr::is_expr_v<E>>>
+        Tensor(const E& e)
+                : Tensor(e.shape()) {
+            expr::evaluate(e, data_.data());
         }
-        Tensor operator-(const T& s) const noexcept {
-            Tensor r(shape_);
-            for (std::size_t i = 0; i < data_.size(); ++i) r.data_[i] = data_[i] - s;
-            return r;
+        template <typename E, typename = std::enable_if_t<expr::is_expr_v<E>>>
+        Tensor& operator=(const E& e) {
+            if (e.shape() == shape_ && !data_.empty()) {
+                // Cada salida solo depende de la misma posición en los operandos
+                // de igual forma, así que a = a + b puede evaluarse in situ
+                // (a = std::move(a) + b deja a sin datos: va por la copia).
+                expr::evaluate(e, data_.data());
+            } else {
+                Tensor tmp(e);
+                *this = std::move(tmp);
+            }
+            return *this;
         }
 
         // Transpuesta 2D (swap de últimos dos ejes)
         Tensor transpose_2d() const {
-            if constexpr (Rank < 2)
-                throw std::invalid_argument("Cannot transpose 1D tensor: need at least 2 dimensions");
-            Shape nshape = shape_;
-            std::swap(nshape[Rank-2], nshape[Rank-1]);
-            Tensor r(nshape);
-            std::array<std::size_t, Rank> idx;
-            for (std::size_t lin = 0; lin < data_.size(); ++lin) {
-                std::size_t rem = lin;
-                for (std::size_t i = 0; i < Rank; ++i) {
-                    idx[i] = rem / strides_[i];
-                    rem    %= strides_[i];
-                }
-                std::swap(idx[Rank-2], idx[Rank-1]);
-                r.data_[r.linear_offset(idx)] = data_[lin];
-            }
-            return r;
+            return Tensor(view().transpose_2d());
         }
 
         // Impresión anidada
@@ -189,7 +396,7 @@ namespace utec::algebra {
 
     private:
         Shape          shape_{}, strides_{};
-        std::vector<T> data_;
+        std::vector<T, detail::counting_allocator<T>> data_;
 
         static constexpr std::size_t num_elems(const Shape& s) {
             std::size_t n = 1;
@@ -232,27 +439,75 @@ namespace utec::algebra {
     template <typename T, std::size_t R>
     Tensor<T,R> transpose_2d(const Tensor<T,R>& t) { return t.transpose_2d(); }
 
-    template <typename T>
-    Tensor<T,2> matrix_product(const Tensor<T,2>& a,
-                               const Tensor<T,2>& b) {
+    template <typename T, std::size_t R>
+    TensorView<T,R> transpose_2d(const TensorView<T,R>& v) { return v.transpose_2d(); }
+
+    // Operación elemento a elemento sobre vistas; el kernel se elige según los strides
+    template <typename TA, typename TB, std::size_t Rank, typename Op>
+    Tensor<std::remove_const_t<TA>, Rank> elementwise_op(const TensorView<TA,Rank>& a,
+                                                         const TensorView<TB,Rank>& b, Op op) {
+        Tensor<std::remove_const_t<TA>, Rank> r(detail::broadcast_shape(a.shape(), b.shape()));
+        detail::binary_kernel<Rank>(r.shape(), r.data(),
+                                    a.data(), a.shape(), a.strides(),
+                                    b.data(), b.shape(), b.strides(),
+                                    a.is_contiguous() && b.is_contiguous(), op);
+        return r;
+    }
+
+    // Producto matricial sobre vistas: los strides van directo al empaquetado del GEMM.
+    // La variante _into escribe en out reutilizando su buffer si ya tiene capacidad.
+    // epi(fila, col, ptr, n) se aplica sobre cada tile de la salida recién
+    // calculado (p. ej. bias + activación) en vez de en una pasada aparte.
+    template <typename TA, typename TB, typename Epi = detail::no_epilogue>
+    void matrix_product_into(const TensorView<TA,2>& a, const TensorView<TB,2>& b,
+                             Tensor<std::remove_const_t<TA>,2>& out, const Epi& epi = Epi{}) {
+        static_assert(std::is_same_v<std::remove_const_t<TA>, std::remove_const_t<TB>>,
+                      "matrix_product operands must share the element type");
         auto ash = a.shape(), bsh = b.shape();
         size_t M = ash[0], K = ash[1], K2 = bsh[0], N = bsh[1];
         if (K != K2)
             throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
-        Tensor<T,2> r(M, N);
-        for (size_t i = 0; i < M; ++i)
-            for (size_t j = 0; j < N; ++j) {
-                T sum{};
-                for (size_t k = 0; k < K; ++k)
-                    sum += a(i,k) * b(k,j);
-                r(i,j) = sum;
-            }
+        out.reshape(M, N);
+        detail::gemm_batched<std::remove_const_t<TA>>(1, M, N, K,
+                             a.data(), 0, a.strides()[0], a.strides()[1],
+                             b.data(), 0, b.strides()[0], b.strides()[1], out.data(), 0, N,
+                             false, epi);
+    }
+
+    // Igual, pero escribiendo en una vista ya dimensionada (filas contiguas)
+    template <typename TA, typename TB, typename TC, typename Epi = detail::no_epilogue>
+    void matrix_product_into(const TensorView<TA,2>& a, const TensorView<TB,2>& b,
+                             const TensorView<TC,2>& out, const Epi& epi = Epi{}) {
+        static_assert(std::is_same_v<std::remove_const_t<TA>, TC> &&
+                      std::is_same_v<std::remove_const_t<TB>, TC>,
+                      "matrix_product operands must share the element type");
+        auto ash = a.shape(), bsh = b.shape();
+        size_t M = ash[0], K = ash[1], K2 = bsh[0], N = bsh[1];
+        if (K != K2)
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        if (out.shape()[0] != M || out.shape()[1] != N)
+            throw std::invalid_argument("Output view has the wrong shape for this product");
+        if (N > 1 && out.strides()[1] != 1)
+            throw std::invalid_argument("Output view must have contiguous rows");
+        detail::gemm_batched<TC>(1, M, N, K,
+                                 a.data(), 0, a.strides()[0], a.strides()[1],
+                                 b.data(), 0, b.strides()[0], b.strides()[1],
+                                 out.data(), 0, out.strides()[0], false, epi);
+    }
+
+    template <typename TA, typename TB>
+    Tensor<std::remove_const_t<TA>,2> matrix_product(const TensorView<TA,2>& a,
+                                                     const TensorView<TB,2>& b) {
+        Tensor<std::remove_const_t<TA>,2> r;
+        matrix_product_into(a, b, r);
         return r;
     }
 
-    template <typename T>
-    Tensor<T,3> matrix_product(const Tensor<T,3>& a,
-                               const Tensor<T,3>& b) {
+    template <typename TA, typename TB>
+    Tensor<std::remove_const_t<TA>,3> matrix_product(const TensorView<TA,3>& a,
+                                                     const TensorView<TB,3>& b) {
+        static_assert(std::is_same_v<std::remove_const_t<TA>, std::remove_const_t<TB>>,
+                      "matrix_product operands must share the element type");
         auto ash = a.shape(), bsh = b.shape();
         size_t B = ash[0], M = ash[1], K = ash[2];
         size_t B2 = bsh[0], K2 = bsh[1], N = bsh[2];
@@ -260,18 +515,59 @@ namespace utec::algebra {
             throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
         if (B != B2)
             throw std::invalid_argument("Batch dimensions do not match for multiplication");
-        Tensor<T,3> r(B, M, N);
-        for (size_t batch = 0; batch < B; ++batch)
-            for (size_t i = 0; i < M; ++i)
-                for (size_t j = 0; j < N; ++j) {
-                    T sum{};
-                    for (size_t k = 0; k < K; ++k)
-                        sum += a(batch,i,k) * b(batch,k,j);
-                    r(batch,i,j) = sum;
-                }
+        Tensor<std::remove_const_t<TA>,3> r(B, M, N);
+        const auto& sa = a.strides();
+        const auto& sb = b.strides();
+        detail::gemm_batched<std::remove_const_t<TA>>(B, M, N, K,
+                             a.data(), sa[0], sa[1], sa[2],
+                             b.data(), sb[0], sb[1], sb[2], r.data(), M*N, N);
         return r;
     }
 
+    template <typename T, std::size_t R>
+    Tensor<T,R> matrix_product(const Tensor<T,R>& a, const Tensor<T,R>& b) {
+        static_assert(R == 2 || R == 3, "matrix_product supports 2D and batched 3D tensors");
+        return matrix_product(a.view(), b.view());
+    }
+    template <typename T, typename U, std::size_t R>
+    Tensor<T,R> matrix_product(const Tensor<T,R>& a, const TensorView<U,R>& b) {
+        return matrix_product(a.view(), b);
+    }
+    template <typename T, typename U, std::size_t R>
+    Tensor<std::remove_const_t<U>,R> matrix_product(const TensorView<U,R>& a, const Tensor<T,R>& b) {
+        return matrix_product(a, b.view());
+    }
+
+    template <typename T>
+    void matrix_product_into(const Tensor<T,2>& a, const Tensor<T,2>& b, Tensor<T,2>& out) {
+        matrix_product_into(a.view(), b.view(), out);
+    }
+    template <typename T, typename U>
+    void matrix_product_into(const Tensor<T,2>& a, const TensorView<U,2>& b, Tensor<T,2>& out) {
+        matrix_product_into(a.view(), b, out);
+    }
+    template <typename T, typename U>
+    void matrix_product_into(const TensorView<U,2>& a, const Tensor<T,2>& b, Tensor<T,2>& out) {
+        matrix_product_into(a, b.view(), out);
+    }
+
+    inline AllocationStats allocation_stats() noexcept {
+        auto& c = detail::counters();
+        return { c.allocations.load(std::memory_order_relaxed),
+                 c.deallocations.load(std::memory_order_relaxed),
+                 c.bytes.load(std::memory_order_relaxed) };
+    }
+
+    // Fuerza la evaluación de una expresión
+    template <typename E, typename = std::enable_if_t<expr::is_expr_v<E>>>
+    auto eval(const E& e) {
+        return Tensor<typename E::value_type, E::rank>(e);
+    }
+    template <typename E, typename = std::enable_if_t<expr::is_expr_v<E>>>
+    std::ostream& operator<<(std::ostream& os, const E& e) {
+        return os << eval(e);
+    }
+
     // CTAD
     template<typename... Dims>
     Tensor(Dims...)-> Tensor<std::common_type_t<Dims...>, sizeof...(Dims)>;
@@ -0,0 +1,254 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_EXPR_H
+#define EPIC1_OFICIAL_TENSOR_EXPR_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Expression templates para la aritmética de Tensor: a * s + b - c construye
+// un árbol de nodos ligeros que se evalúa en un solo bucle al asignarse a un
+// Tensor. Los nodos guardan punteros a los datos, no copias: los tensores
+// operandos deben seguir vivos hasta la evaluación (igual que en Eigen).
+// Un Tensor temporal (rvalue) se mueve a la expresión, que lo mantiene vivo:
+// `auto e = make() + b;` es seguro mientras b siga vivo.
+
+namespace utec::algebra {
+
+    template <typename T, std::size_t Rank>
+    class Tensor;
+
+    namespace expr {
+
+        template <typename E>
+        struct is_expr : std::false_type {};
+        template <typename E>
+        inline constexpr bool is_expr_v = is_expr<std::remove_cv_t<std::remove_reference_t<E>>>::value;
+
+        // Hoja: referencia a los datos de un Tensor; strides 0 en ejes difundidos
+        template <typename T, std::size_t Rank>
+        class Leaf {
+        public:
+            using value_type = T;
+            using Shape      = std::array<std::size_t, Rank>;
+            static constexpr std::size_t rank = Rank;
+
+            explicit Leaf(const Tensor<T, Rank>& t) noexcept
+                    : data_(t.data()), shape_(t.shape()) {}
+
+            const Shape& shape() const noexcept { return shape_; }
+            bool same_shape(const Shape& r) const noexcept { return shape_ == r; }
+            T at(std::size_t i) const noexcept { return data_[i]; }
+
+            void bind(const Shape& r) noexcept {
+                std::size_t acc = 1;
+                for (std::size_t i = Rank; i-- > 0;) {
+                    stride_[i] = (shape_[i] == 1 && r[i] != 1) ? 0 : acc;
+                    acc *= shape_[i];
+                }
+                off_ = 0;
+            }
+            void step(std::size_t d) noexcept { off_ += stride_[d]; }
+            void rewind(std::size_t d, std::size_t n) noexcept { off_ -= stride_[d] * (n - 1); }
+            T inner(std::size_t j) const noexcept { return data_[off_ + j * stride_[Rank-1]]; }
+
+        private:
+            const T*    data_;
+            Shape       shape_;
+            Shape       stride_{};
+            std::size_t off_ = 0;
+        };
+
+        // Hoja de un Tensor temporal: se queda con él (compartido entre las
+        // copias del nodo, así que copiar la expresión no copia los datos)
+        template <typename T, std::size_t Rank>
+        class OwnedLeaf : public Leaf<T, Rank> {
+        public:
+            explicit OwnedLeaf(Tensor<T, Rank>&& t)
+                    : OwnedLeaf(std::make_shared<const Tensor<T, Rank>>(std::move(t))) {}
+
+        private:
+            std::shared_ptr<const Tensor<T, Rank>> owner_;
+
+            explicit OwnedLeaf(std::shared_ptr<const Tensor<T, Rank>> p)
+                    : Leaf<T, Rank>(*p), owner_(std::move(p)) {}
+        };
+
+        // Escalar: forma de unos, se difunde a cualquier forma
+        template <typename T, std::size_t Rank>
+        class Scalar {
+        public:
+            using value_type = T;
+            using Shape      = std::array<std::size_t, Rank>;
+            static constexpr std::size_t rank = Rank;
+
+            explicit Scalar(T v) noexcept : v_(v) { shape_.fill(1); }
+
+            const Shape& shape() const noexcept { return shape_; }
+            bool same_shape(const Shape&) const noexcept { return true; }
+            T at(std::size_t) const noexcept { return v_; }
+            void bind(const Shape&) noexcept {}
+            void step(std::size_t) noexcept {}
+            void rewind(std::size_t, std::size_t) noexcept {}
+            T inner(std::size_t) const noexcept { return v_; }
+
+        private:
+            T     v_;
+            Shape shape_;
+        };
+
+        template <typename Op, typename L, typename R>
+        class Binary {
+        public:
+            using value_type = typename L::value_type;
+            using Shape      = typename L::Shape;
+            static constexpr std::size_t rank = L::rank;
+
+            Binary(const L& l, const R& r)
+                    : l_(l), r_(r), shape_(broadcast(l_.shape(), r_.shape())) {}
+
+            const Shape& shape() const noexcept { return shape_; }
+            bool same_shape(const Shape& s) const noexcept { return l_.same_shape(s) && r_.same_shape(s); }
+            value_type at(std::size_t i) const { return Op{}(l_.at(i), r_.at(i)); }
+            void bind(const Shape& s) noexcept { l_.bind(s); r_.bind(s); }
+            void step(std::size_t d) noexcept { l_.step(d); r_.step(d); }
+            void rewind(std::size_t d, std::size_t n) noexcept { l_.rewind(d, n); r_.rewind(d, n); }
+            value_type inner(std::size_t j) const { return Op{}(l_.inner(j), r_.inner(j)); }
+
+        private:
+            L     l_;
+            R     r_;
+            Shape shape_;
+
+            static Shape broadcast(const Shape& a, const Shape& b) {
+                Shape s{};
+                for (std::size_t i = 0; i < rank; ++i) {
+                    if      (a[i] == b[i]) s[i] = a[i];
+                    else if (a[i] == 1)    s[i] = b[i];
+                    else if (b[i] == 1)    s[i] = a[i];
+                    else throw std::invalid_argument(
+                                "Shapes do not match and are not compatible for broadcasting");
+                }
+                return s;
+            }
+        };
+
+        template <typename T, std::size_t Rank>
+        struct is_expr<Leaf<T, Rank>> : std::true_type {};
+        template <typename T, std::size_t Rank>
+        struct is_expr<OwnedLeaf<T, Rank>> : std::true_type {};
+        template <typename T, std::size_t Rank>
+        struct is_expr<Scalar<T, Rank>> : std::true_type {};
+        template <typename Op, typename L, typename R>
+        struct is_expr<Binary<Op, L, R>> : std::true_type {};
+
+        template <typename X>
+        struct is_tensor : std::false_type {};
+        template <typename T, std::size_t Rank>
+        struct is_tensor<Tensor<T, Rank>> : std::true_type {};
+
+        template <typename X>
+        inline constexpr bool is_operand_v =
+                is_expr_v<X> || is_tensor<std::remove_cv_t<std::remove_reference_t<X>>>::value;
+
+        // Tensor -> hoja (propietaria si es temporal); un nodo se pasa por valor
+        template <typename T, std::size_t Rank>
+        Leaf<T, Rank> as_node(const Tensor<T, Rank>& t) noexcept { return Leaf<T, Rank>(t); }
+        template <typename T, std::size_t Rank>
+        OwnedLeaf<T, Rank> as_node(Tensor<T, Rank>&& t) { return OwnedLeaf<T, Rank>(std::move(t)); }
+        template <typename T, std::size_t Rank>
+        void as_node(const Tensor<T, Rank>&&) = delete;   // no se puede mover: quedaría colgando
+        template <typename E, typename = std::enable_if_t<is_expr_v<E>>>
+        std::remove_cvref_t<E> as_node(E&& e) { return std::forward<E>(e); }
+
+        // X es el tipo deducido de una referencia universal (T o T&)
+        template <typename X>
+        using node_t = std::remove_cvref_t<decltype(as_node(std::declval<X>()))>;
+
+        template <typename S>
+        inline constexpr bool is_scalar_v = std::is_arithmetic_v<std::remove_cvref_t<S>>;
+
+        // Evalúa e en out (ya dimensionado con e.shape()) en una sola pasada
+        template <typename E, typename T>
+        void evaluate(const E& e, T* out) {
+            constexpr std::size_t Rank = E::rank;
+            const auto& shape = e.shape();
+            std::size_t outer = 1;
+            for (std::size_t i = 0; i + 1 < Rank; ++i) outer *= shape[i];
+            const std::size_t n = shape[Rank-1];
+            if (e.same_shape(shape)) {
+                for (std::size_t i = 0, tot = outer * n; i < tot; ++i) out[i] = e.at(i);
+                return;
+            }
+            E it = e;
+            it.bind(shape);
+            if (outer == 0 || n == 0) return;
+            std::array<std::size_t, Rank> idx{};
+            for (std::size_t r = 0; r < outer; ++r, out += n) {
+                for (std::size_t j = 0; j < n; ++j) out[j] = it.inner(j);
+                for (std::size_t d = Rank - 1; d-- > 0;) {
+                    if (++idx[d] < shape[d]) { it.step(d); break; }
+                    it.rewind(d, shape[d]);
+                    idx[d] = 0;
+                }
+            }
+        }
+
+    }
+
+    // Operadores: al menos un operando es Tensor o expresión; el otro puede ser escalar
+#define UTEC_TENSOR_EXPR_OPERATOR(OP, FUNCTOR)                                                   \
+    template <typename A, typename B,                                                            \
+              typename = std::enable_if_t<expr::is_operand_v<A> && expr::is_operand_v<B>>>       \
+    auto operator OP(A&& a, B&& b) {                                                             \
+        using LA = expr::node_t<A>;                                                              \
+        using LB = expr::node_t<B>;                                                              \
+        return expr::Binary<FUNCTOR, LA, LB>(expr::as_node(std::forward<A>(a)),                  \
+                                             expr::as_node(std::forward<B>(b)));                 \
+    }                                                                                            \
+    template <typename A, typename S,                                                            \
+              typename = std::enable_if_t<expr::is_operand_v<A> && expr::is_scalar_v<S>>,        \
+              typename = void>                                                                   \
+    auto operator OP(A&& a, const S& s) {                                                        \
+        using LA = expr::node_t<A>;                                                              \
+        using V  = typename LA::value_type;                                                      \
+        using LS = expr::Scalar<V, LA::rank>;                                                    \
+        return expr::Binary<FUNCTOR, LA, LS>(expr::as_node(std::forward<A>(a)),                  \
+                                             LS(static_cast<V>(s)));                             \
+    }                                                                                            \
+    template <typename S, typename B,                                                            \
+              typename = std::enable_if_t<expr::is_scalar_v<S> && expr::is_operand_v<B>>,        \
+              typename = void, typename = void>                                                  \
+    auto operator OP(const S& s, B&& b) {                                                        \
+        using LB = expr::node_t<B>;                                                              \
+        using V  = typename LB::value_type;                                                      \
+        using LS = expr::Scalar<V, LB::rank>;                                                    \
+        return expr::Binary<FUNCTOR, LS, LB>(LS(static_cast<V>(s)),                              \
+                                             expr::as_node(std::forward<B>(b)));                 \
+    }
+
+    UTEC_TENSOR_EXPR_OPERATOR(+, std::plus<>)
+    UTEC_TENSOR_EXPR_OPERATOR(-, std::minus<>)
+    UTEC_TENSOR_EXPR_OPERATOR(*, std::multiplies<>)
+    UTEC_TENSOR_EXPR_OPERATOR(/, std::divides<>)
+
+#undef UTEC_TENSOR_EXPR_OPERATOR
+
+    // Visibles por ADL cuando ningún operando es un Tensor (expresión op expresión)
+    namespace expr {
+        using utec::algebra::operator+;
+        using utec::algebra::operator-;
+        using utec::algebra::operator*;
+        using utec::algebra::operator/;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_EXPR_H
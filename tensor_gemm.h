@@ -0,0 +1,267 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_GEMM_H
+#define EPIC1_OFICIAL_TENSOR_GEMM_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "thread_pool.h"
+#include "tensor_simd.h"
+
+// Kernel GEMM empaquetado y por bloques (estilo BLIS/GotoBLAS):
+//   C(MxN) = A(MxK) * B(KxN)   (o C += A*B si accumulate)
+// A y B se leen con strides arbitrarios (fila, columna), asi que una
+// transpuesta no necesita copia; C es row-major con leading dimension ldc.
+
+namespace utec::algebra {
+
+    // Configuracion del modo paralelo de matrix_product
+    struct GemmConfig {
+        bool        parallel          = true;
+        std::size_t min_parallel_flops = std::size_t(1) << 21;  // por debajo: hilo llamador
+    };
+
+    inline GemmConfig& gemm_config() {
+        static GemmConfig cfg;
+        return cfg;
+    }
+
+}
+
+namespace utec::algebra::detail {
+
+    // Parametros de bloqueo y micro-kernel (MR x NR en registros)
+    template <typename T, typename = void>
+    struct gemm_traits {
+        static constexpr std::size_t MR = 4, NR = 8;
+        static constexpr std::size_t MC = 128, KC = 256, NC = 2048;
+
+        static void micro(std::size_t kc, const T* a, const T* b,
+                          T* c, std::size_t ldc, bool accumulate) noexcept {
+            T acc[MR][NR] = {};
+            for (std::size_t k = 0; k < kc; ++k, a += MR, b += NR)
+                for (std::size_t i = 0; i < MR; ++i)
+                    for (std::size_t j = 0; j < NR; ++j)
+                        acc[i][j] += a[i] * b[j];
+            for (std::size_t i = 0; i < MR; ++i)
+                for (std::size_t j = 0; j < NR; ++j)
+                    c[i*ldc + j] = accumulate ? c[i*ldc + j] + acc[i][j] : acc[i][j];
+        }
+    };
+
+    template <typename T>
+    struct gemm_traits<T, std::enable_if_t<(simd<T>::width > 0)>> {
+        using V = simd<T>;
+        static constexpr std::size_t W  = V::width;
+        static constexpr std::size_t MR = (W * sizeof(T) == 64) ? 12 : 6;
+        static constexpr std::size_t NR = 2 * W;
+        static constexpr std::size_t MC = 96, KC = 256, NC = 2048;
+
+        static void micro(std::size_t kc, const T* a, const T* b,
+                          T* c, std::size_t ldc, bool accumulate) noexcept {
+            typename V::reg acc0[MR], acc1[MR];
+#pragma GCC unroll 16
+            for (std::size_t i = 0; i < MR; ++i) { acc0[i] = V::zero(); acc1[i] = V::zero(); }
+            for (std::size_t k = 0; k < kc; ++k, a += MR, b += NR) {
+                auto b0 = V::load(b), b1 = V::load(b + W);
+#pragma GCC unroll 16
+                for (std::size_t i = 0; i < MR; ++i) {
+                    auto ai = V::set1(a[i]);
+                    acc0[i] = V::fmadd(ai, b0, acc0[i]);
+                    acc1[i] = V::fmadd(ai, b1, acc1[i]);
+                }
+            }
+#pragma GCC unroll 16
+            for (std::size_t i = 0; i < MR; ++i) {
+                T* ci = c + i*ldc;
+                if (accumulate) {
+                    acc0[i] = V::add(acc0[i], V::load(ci));
+                    acc1[i] = V::add(acc1[i], V::load(ci + W));
+                }
+                V::store(ci, acc0[i]);
+                V::store(ci + W, acc1[i]);
+            }
+        }
+    };
+
+    // Empaqueta un bloque mc x kc de A en paneles de MR filas (relleno con 0)
+    template <typename T, std::size_t MR>
+    void pack_a(std::size_t mc, std::size_t kc, const T* a,
+                std::size_t rsa, std::size_t csa, T* dst) {
+        for (std::size_t ir = 0; ir < mc; ir += MR) {
+            std::size_t mr = std::min(MR, mc - ir);
+            for (std::size_t k = 0; k < kc; ++k) {
+                const T* src = a + ir*rsa + k*csa;
+                std::size_t i = 0;
+                for (; i < mr; ++i) dst[i] = src[i*rsa];
+                for (; i < MR; ++i) dst[i] = T(0);
+                dst += MR;
+            }
+        }
+    }
+
+    // Empaqueta un bloque kc x nc de B en paneles de NR columnas (relleno con 0)
+    template <typename T, std::size_t NR>
+    void pack_b(std::size_t kc, std::size_t nc, const T* b,
+                std::size_t rsb, std::size_t csb, T* dst) {
+        for (std::size_t jr = 0; jr < nc; jr += NR) {
+            std::size_t nr = std::min(NR, nc - jr);
+            for (std::size_t k = 0; k < kc; ++k) {
+                const T* src = b + k*rsb + jr*csb;
+                std::size_t j = 0;
+                if (csb == 1)
+                    for (; j < nr; ++j) dst[j] = src[j];
+                else
+                    for (; j < nr; ++j) dst[j] = src[j*csb];
+                for (; j < NR; ++j) dst[j] = T(0);
+                dst += NR;
+            }
+        }
+    }
+
+    // Epílogo: se aplica a cada fila de un tile de C recién terminado (todavía
+    // en L1), con sus coordenadas globales: epi(fila, col, ptr, n).
+    struct no_epilogue {
+        template <typename T>
+        void operator()(std::size_t, std::size_t, T*, std::size_t) const noexcept {}
+    };
+
+    template <typename Epi>
+    struct epilogue_enabled : std::true_type {};
+    template <>
+    struct epilogue_enabled<no_epilogue> : std::false_type {};
+
+    // Recorre los paneles empaquetados; los bordes pasan por un tile temporal
+    template <typename T, typename Epi = no_epilogue>
+    void macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc,
+                      const T* ap, const T* bp, T* c, std::size_t ldc, bool accumulate,
+                      std::size_t row0 = 0, std::size_t col0 = 0,
+                      const Epi* epi = nullptr) {
+        using K = gemm_traits<T>;
+        alignas(64) T tmp[K::MR * K::NR];
+        for (std::size_t jr = 0; jr < nc; jr += K::NR) {
+            std::size_t nr = std::min(K::NR, nc - jr);
+            for (std::size_t ir = 0; ir < mc; ir += K::MR) {
+                std::size_t mr = std::min(K::MR, mc - ir);
+                T* cij = c + ir*ldc + jr;
+                const T* a = ap + ir*kc;
+                const T* b = bp + jr*kc;
+                if (mr == K::MR && nr == K::NR) {
+                    K::micro(kc, a, b, cij, ldc, accumulate);
+                } else {
+                    K::micro(kc, a, b, tmp, K::NR, false);
+                    for (std::size_t i = 0; i < mr; ++i)
+                        for (std::size_t j = 0; j < nr; ++j)
+                            cij[i*ldc + j] = accumulate ? cij[i*ldc + j] + tmp[i*K::NR + j]
+                                                        : tmp[i*K::NR + j];
+                }
+                if constexpr (epilogue_enabled<Epi>::value) {
+                    if (epi)
+                        for (std::size_t i = 0; i < mr; ++i)
+                            (*epi)(row0 + ir + i, col0 + jr, cij + i*ldc, nr);
+                }
+            }
+        }
+    }
+
+    template <typename T, typename Epi = no_epilogue>
+    void gemm(std::size_t M, std::size_t N, std::size_t K,
+              const T* a, std::size_t rsa, std::size_t csa,
+              const T* b, std::size_t rsb, std::size_t csb,
+              T* c, std::size_t ldc, bool accumulate = false,
+              const Epi& epi = Epi{}, std::size_t row0 = 0, std::size_t col0 = 0) {
+        using G = gemm_traits<T>;
+        if (M == 0 || N == 0) return;
+        if (K == 0) {
+            for (std::size_t i = 0; i < M; ++i) {
+                if (!accumulate) std::fill(c + i*ldc, c + i*ldc + N, T(0));
+                if constexpr (epilogue_enabled<Epi>::value) epi(row0 + i, col0, c + i*ldc, N);
+            }
+            return;
+        }
+        // Buffers de empaquetado reutilizados entre llamadas (uno por hilo)
+        thread_local std::vector<T> abuf, bbuf;
+        abuf.resize(G::MC * G::KC);
+        bbuf.resize(G::KC * ((std::min(N, G::NC) + G::NR - 1) / G::NR) * G::NR);
+
+        for (std::size_t jc = 0; jc < N; jc += G::NC) {
+            std::size_t nc = std::min(G::NC, N - jc);
+            for (std::size_t pc = 0; pc < K; pc += G::KC) {
+                std::size_t kc = std::min(G::KC, K - pc);
+                bool acc  = accumulate || pc > 0;
+                bool last = pc + kc == K;
+                pack_b<T, G::NR>(kc, nc, b + pc*rsb + jc*csb, rsb, csb, bbuf.data());
+                for (std::size_t ic = 0; ic < M; ic += G::MC) {
+                    std::size_t mc = std::min(G::MC, M - ic);
+                    pack_a<T, G::MR>(mc, kc, a + ic*rsa + pc*csa, rsa, csa, abuf.data());
+                    macro_kernel<T, Epi>(mc, nc, kc, abuf.data(), bbuf.data(),
+                                         c + ic*ldc + jc, ldc, acc,
+                                         row0 + ic, col0 + jc, last ? &epi : nullptr);
+                }
+            }
+        }
+    }
+
+    // Divide C en tiles (multiplos de MC x NR) para repartir entre hilos
+    struct gemm_tiling {
+        std::size_t tm, tn, rows, cols;
+        std::size_t count() const noexcept { return rows * cols; }
+    };
+
+    template <typename T>
+    gemm_tiling make_tiling(std::size_t M, std::size_t N, std::size_t min_tiles) {
+        using G = gemm_traits<T>;
+        gemm_tiling t{};
+        t.tm   = std::min(G::MC, M);
+        t.rows = (M + t.tm - 1) / t.tm;
+        std::size_t want_cols = std::max<std::size_t>(1, (min_tiles + t.rows - 1) / t.rows);
+        std::size_t panels    = (N + G::NR - 1) / G::NR;
+        std::size_t per_col   = std::max<std::size_t>(1, panels / std::min(want_cols, panels));
+        t.tn   = std::min(N, per_col * G::NR);
+        t.cols = (N + t.tn - 1) / t.tn;
+        return t;
+    }
+
+    inline bool use_parallel_gemm(std::size_t batch, std::size_t M, std::size_t N, std::size_t K) {
+        const auto& cfg = gemm_config();
+        return cfg.parallel && default_thread_pool().size() > 1 &&
+               2 * batch * M * N * K >= cfg.min_parallel_flops;
+    }
+
+    // GEMM por lotes (batch >= 1) con strides entre lotes; reparte lote x tiles
+    // El epílogo recibe coordenadas dentro de cada matriz del lote.
+    template <typename T, typename Epi = no_epilogue>
+    void gemm_batched(std::size_t batch, std::size_t M, std::size_t N, std::size_t K,
+                      const T* a, std::size_t bsa, std::size_t rsa, std::size_t csa,
+                      const T* b, std::size_t bsb, std::size_t rsb, std::size_t csb,
+                      T* c, std::size_t bsc, std::size_t ldc, bool accumulate = false,
+                      const Epi& epi = Epi{}) {
+        if (!use_parallel_gemm(batch, M, N, K)) {
+            for (std::size_t p = 0; p < batch; ++p)
+                gemm(M, N, K, a + p*bsa, rsa, csa, b + p*bsb, rsb, csb,
+                     c + p*bsc, ldc, accumulate, epi);
+            return;
+        }
+        auto& pool = default_thread_pool();
+        std::size_t min_tiles = (2 * pool.size() + batch - 1) / batch;
+        auto tiling = make_tiling<T>(M, N, min_tiles);
+        pool.parallel_for(batch * tiling.count(), [&](std::size_t task) {
+            std::size_t p    = task / tiling.count();
+            std::size_t tile = task % tiling.count();
+            std::size_t i0 = (tile / tiling.cols) * tiling.tm;
+            std::size_t j0 = (tile % tiling.cols) * tiling.tn;
+            std::size_t mi = std::min(tiling.tm, M - i0);
+            std::size_t nj = std::min(tiling.tn, N - j0);
+            gemm(mi, nj, K, a + p*bsa + i0*rsa, rsa, csa,
+                 b + p*bsb + j0*csb, rsb, csb,
+                 c + p*bsc + i0*ldc + j0, ldc, accumulate, epi, i0, j0);
+        });
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_GEMM_H
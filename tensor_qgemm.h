@@ -0,0 +1,315 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_QGEMM_H
+#define EPIC1_OFICIAL_TENSOR_QGEMM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "thread_pool.h"
+#include "tensor_gemm.h"
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// GEMM entero int8 x int8 -> int32 para inferencia cuantizada:
+//   C(MxN) = epi(A(MxK) * B(KxN))
+// K se recorre de a pares: A se guarda como int16 row-major (K rellenado a par,
+// así cada int32 es un par (a[k], a[k+1])) y B como pares intercalados por
+// columna, de modo que madd_epi16 (o vpdpwssd con VNNI) hace dos MACs por
+// carril. B se empaqueta una sola vez en int8 (los pesos no cambian) y se
+// ensancha en el micro-kernel.
+
+namespace utec::algebra::detail {
+
+    // Par (a[0], a[1]) de int16 leído como un int32 (carril de madd_epi16)
+    inline std::int32_t pair(const std::int16_t* a) noexcept {
+        std::int32_t v;
+        std::memcpy(&v, a, sizeof(v));
+        return v;
+    }
+
+#if defined(__AVX512BW__)
+    struct qgemm_kernel {
+        static constexpr std::size_t MR = 8, NR = 32, MC = 96;
+
+        static __m512i dot(__m512i acc, __m512i a, __m512i b) noexcept {
+#if defined(__AVX512VNNI__)
+            return _mm512_dpwssd_epi32(acc, a, b);
+#else
+            return _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+#endif
+        }
+
+        // kp pares de K; la fila i de A empieza en a + i*lda (int16); c es un
+        // tile MR x NR contiguo de int32
+        static void micro(std::size_t kp, const std::int16_t* a, std::size_t lda,
+                          const std::int8_t* b, std::int32_t* c) noexcept {
+            __m512i acc0[MR], acc1[MR];
+#pragma GCC unroll 8
+            for (std::size_t i = 0; i < MR; ++i) { acc0[i] = _mm512_setzero_si512(); acc1[i] = _mm512_setzero_si512(); }
+            for (std::size_t k = 0; k < kp; ++k, b += 2 * NR) {
+                __m512i b0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+                __m512i b1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + NR)));
+#pragma GCC unroll 8
+                for (std::size_t i = 0; i < MR; ++i) {
+                    __m512i ai = _mm512_set1_epi32(pair(a + i*lda + 2*k));
+                    acc0[i] = dot(acc0[i], ai, b0);
+                    acc1[i] = dot(acc1[i], ai, b1);
+                }
+            }
+#pragma GCC unroll 8
+            for (std::size_t i = 0; i < MR; ++i) {
+                _mm512_storeu_si512(c + i*NR, acc0[i]);
+                _mm512_storeu_si512(c + i*NR + NR/2, acc1[i]);
+            }
+        }
+    };
+#elif defined(__AVX2__)
+    struct qgemm_kernel {
+        static constexpr std::size_t MR = 6, NR = 16, MC = 96;
+
+        static void micro(std::size_t kp, const std::int16_t* a, std::size_t lda,
+                          const std::int8_t* b, std::int32_t* c) noexcept {
+            __m256i acc0[MR], acc1[MR];
+#pragma GCC unroll 6
+            for (std::size_t i = 0; i < MR; ++i) { acc0[i] = _mm256_setzero_si256(); acc1[i] = _mm256_setzero_si256(); }
+            for (std::size_t k = 0; k < kp; ++k, b += 2 * NR) {
+                __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+                __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + NR)));
+#pragma GCC unroll 6
+                for (std::size_t i = 0; i < MR; ++i) {
+                    __m256i ai = _mm256_set1_epi32(pair(a + i*lda + 2*k));
+                    acc0[i] = _mm256_add_epi32(acc0[i], _mm256_madd_epi16(ai, b0));
+                    acc1[i] = _mm256_add_epi32(acc1[i], _mm256_madd_epi16(ai, b1));
+                }
+            }
+#pragma GCC unroll 6
+            for (std::size_t i = 0; i < MR; ++i) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i*NR), acc0[i]);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i*NR + NR/2), acc1[i]);
+            }
+        }
+    };
+#elif defined(__SSE2__)
+    // x86-64 base: madd_epi16 existe desde SSE2; el ensanchado int8 -> int16
+    // con signo se hace con unpack + shift aritmético (cvtepi8 es SSE4.1)
+    struct qgemm_kernel {
+        static constexpr std::size_t MR = 6, NR = 8, MC = 96;
+
+        static __m128i widen(const std::int8_t* b) noexcept {
+            __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b));
+            return _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        }
+
+        static void micro(std::size_t kp, const std::int16_t* a, std::size_t lda,
+                          const std::int8_t* b, std::int32_t* c) noexcept {
+            __m128i acc0[MR], acc1[MR];
+#pragma GCC unroll 6
+            for (std::size_t i = 0; i < MR; ++i) { acc0[i] = _mm_setzero_si128(); acc1[i] = _mm_setzero_si128(); }
+            for (std::size_t k = 0; k < kp; ++k, b += 2 * NR) {
+                __m128i b0 = widen(b), b1 = widen(b + NR);
+#pragma GCC unroll 6
+                for (std::size_t i = 0; i < MR; ++i) {
+                    __m128i ai = _mm_set1_epi32(pair(a + i*lda + 2*k));
+                    acc0[i] = _mm_add_epi32(acc0[i], _mm_madd_epi16(ai, b0));
+                    acc1[i] = _mm_add_epi32(acc1[i], _mm_madd_epi16(ai, b1));
+                }
+            }
+#pragma GCC unroll 6
+            for (std::size_t i = 0; i < MR; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(c + i*NR), acc0[i]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(c + i*NR + NR/2), acc1[i]);
+            }
+        }
+    };
+#else
+    struct qgemm_kernel {
+        static constexpr std::size_t MR = 4, NR = 8, MC = 96;
+
+        static void micro(std::size_t kp, const std::int16_t* a, std::size_t lda,
+                          const std::int8_t* b, std::int32_t* c) noexcept {
+            std::int32_t acc[MR][NR] = {};
+            for (std::size_t k = 0; k < kp; ++k, b += 2 * NR)
+                for (std::size_t i = 0; i < MR; ++i) {
+                    const std::int16_t a0 = a[i*lda + 2*k], a1 = a[i*lda + 2*k + 1];
+                    for (std::size_t j = 0; j < NR; ++j)
+                        acc[i][j] += a0 * b[2*j] + a1 * b[2*j + 1];
+                }
+            for (std::size_t i = 0; i < MR; ++i)
+                for (std::size_t j = 0; j < NR; ++j) c[i*NR + j] = acc[i][j];
+        }
+    };
+#endif
+
+    // Layout del B empaquetado: paneles de NR columnas; en cada panel, para
+    // cada par de K, NR/2 columnas x 2 (bajo SIMD: carril j = (b[2k][j], b[2k+1][j]))
+    // repetido para las dos mitades del panel.
+    inline std::size_t qgemm_pairs(std::size_t K) noexcept { return (K + 1) / 2; }
+
+    inline std::size_t qgemm_packed_b_size(std::size_t K, std::size_t N) noexcept {
+        using Q = qgemm_kernel;
+        return (N + Q::NR - 1) / Q::NR * qgemm_pairs(K) * 2 * Q::NR;
+    }
+
+    // Elementos int16 del A cuantizado (filas hasta múltiplo de MR, K par)
+    inline std::size_t qgemm_packed_a_size(std::size_t M, std::size_t K) noexcept {
+        using Q = qgemm_kernel;
+        return (M + Q::MR - 1) / Q::MR * Q::MR * 2 * qgemm_pairs(K);
+    }
+
+}
+
+namespace utec::algebra {
+
+    // Empaqueta B (K x N, int8 row-major con leading dimension ldb) para qgemm
+    inline std::vector<std::int8_t> qgemm_pack_b(std::size_t K, std::size_t N,
+                                                 const std::int8_t* b, std::size_t ldb) {
+        using Q = detail::qgemm_kernel;
+        const std::size_t kp = detail::qgemm_pairs(K);
+        std::vector<std::int8_t> out(detail::qgemm_packed_b_size(K, N), 0);
+        std::int8_t* p = out.data();
+        for (std::size_t jr = 0; jr < N; jr += Q::NR)
+            for (std::size_t k2 = 0; k2 < kp; ++k2, p += 2 * Q::NR)
+                for (std::size_t j = 0; j < Q::NR; ++j) {
+                    const std::size_t col = jr + j;
+                    if (col >= N) continue;
+                    // mitad h del panel: columnas [h*NR/2, (h+1)*NR/2)
+                    const std::size_t h = j / (Q::NR / 2), jj = j % (Q::NR / 2);
+                    std::int8_t* dst = p + h * Q::NR + 2 * jj;
+                    dst[0] = b[(2*k2) * ldb + col];
+                    dst[1] = 2*k2 + 1 < K ? b[(2*k2 + 1) * ldb + col] : std::int8_t(0);
+                }
+        return out;
+    }
+
+    namespace detail {
+        // round-half-even sin llamadas a libm (igual que cvtps_epi32); |v| <= 127
+        template <typename T>
+        std::int16_t quantize_one(T v, T inv_scale) noexcept {
+            constexpr T magic = T(1.5) * T(std::size_t(1) << (std::numeric_limits<T>::digits - 1));
+            T s = std::min(std::max(v * inv_scale, T(-127)), T(127));
+            return static_cast<std::int16_t>((s + magic) - magic);
+        }
+
+        template <typename T>
+        std::size_t quantize_row_simd(std::size_t, const T*, T, std::int16_t*) noexcept { return 0; }
+#if defined(__AVX512BW__)
+        inline std::size_t quantize_row_simd(std::size_t K, const float* x, float inv_scale,
+                                             std::int16_t* out) noexcept {
+            const __m512 s = _mm512_set1_ps(inv_scale), lo = _mm512_set1_ps(-127.f), hi = _mm512_set1_ps(127.f);
+            std::size_t k = 0;
+            for (; k + 16 <= K; k += 16) {
+                __m512 v = _mm512_min_ps(_mm512_max_ps(_mm512_mul_ps(_mm512_loadu_ps(x + k), s), lo), hi);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k),
+                                    _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v)));
+            }
+            return k;
+        }
+#elif defined(__AVX2__)
+        inline std::size_t quantize_row_simd(std::size_t K, const float* x, float inv_scale,
+                                             std::int16_t* out) noexcept {
+            const __m256 s = _mm256_set1_ps(inv_scale), lo = _mm256_set1_ps(-127.f), hi = _mm256_set1_ps(127.f);
+            std::size_t k = 0;
+            for (; k + 16 <= K; k += 16) {
+                __m256 v0 = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x + k), s), lo), hi);
+                __m256 v1 = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x + k + 8), s), lo), hi);
+                // packs intercala carriles de 128 bits: se reordena con permute4x64
+                __m256i p = _mm256_packs_epi32(_mm256_cvtps_epi32(v0), _mm256_cvtps_epi32(v1));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), _mm256_permute4x64_epi64(p, 0xD8));
+            }
+            return k;
+        }
+#elif defined(__SSE2__)
+        inline std::size_t quantize_row_simd(std::size_t K, const float* x, float inv_scale,
+                                             std::int16_t* out) noexcept {
+            const __m128 s = _mm_set1_ps(inv_scale), lo = _mm_set1_ps(-127.f), hi = _mm_set1_ps(127.f);
+            std::size_t k = 0;
+            for (; k + 8 <= K; k += 8) {
+                __m128 v0 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(x + k), s), lo), hi);
+                __m128 v1 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(x + k + 4), s), lo), hi);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k),
+                                 _mm_packs_epi32(_mm_cvtps_epi32(v0), _mm_cvtps_epi32(v1)));
+            }
+            return k;
+        }
+#endif
+    }
+
+    // Cuantiza A (M x K, flotante) con q = clamp(round(x * inv_scale), -127, 127)
+    // y la escribe en el layout de qgemm: int16 row-major, K rellenado a par y
+    // filas rellenadas con ceros hasta múltiplo de MR
+    template <typename T>
+    void quantize_pack_a(std::size_t M, std::size_t K, const T* a, std::size_t lda,
+                         T inv_scale, std::int16_t* out) noexcept {
+        using Q = detail::qgemm_kernel;
+        const std::size_t ld16 = 2 * detail::qgemm_pairs(K);
+        const std::size_t rows = (M + Q::MR - 1) / Q::MR * Q::MR;
+        std::int16_t* o16 = out;
+        for (std::size_t r = 0; r < rows; ++r, o16 += ld16) {
+            if (r >= M) {
+                std::fill(o16, o16 + ld16, std::int16_t(0));
+                continue;
+            }
+            const T* src = a + r * lda;
+            std::size_t k = detail::quantize_row_simd(K, src, inv_scale, o16);
+            for (; k < K; ++k) o16[k] = detail::quantize_one(src[k], inv_scale);
+            if (K < ld16) o16[K] = 0;
+        }
+    }
+
+    // C = epi(A·B): ap/bp vienen de quantize_pack_a / qgemm_pack_b.
+    // epi(row, col, const int32_t* acc, T* out, n) escribe n valores de C.
+    template <typename T, typename Epi>
+    void qgemm(std::size_t M, std::size_t N, std::size_t K,
+               const std::int16_t* ap, const std::int8_t* bp,
+               T* c, std::size_t ldc, const Epi& epi) {
+        using Q = detail::qgemm_kernel;
+        if (M == 0 || N == 0) return;
+        const std::size_t kp = detail::qgemm_pairs(K);
+        const std::size_t row_blocks = (M + Q::MC - 1) / Q::MC;
+        const std::size_t col_panels = (N + Q::NR - 1) / Q::NR;
+
+        // Bloque de MC filas x [p0, p1) paneles de columnas
+        auto block = [&](std::size_t ic, std::size_t p0, std::size_t p1) {
+            alignas(64) std::int32_t tile[Q::MR * Q::NR];
+            const std::size_t mc = std::min(Q::MC, M - ic);
+            for (std::size_t p = p0; p < p1; ++p) {
+                const std::size_t jr = p * Q::NR, nr = std::min(Q::NR, N - jr);
+                const std::int8_t* b = bp + p * kp * 2 * Q::NR;
+                for (std::size_t ir = 0; ir < mc; ir += Q::MR) {
+                    const std::size_t row = ic + ir, mr = std::min(Q::MR, mc - ir);
+                    Q::micro(kp, ap + row * 2 * kp, 2 * kp, b, tile);
+                    for (std::size_t i = 0; i < mr; ++i)
+                        epi(row + i, jr, tile + i * Q::NR, c + (row + i) * ldc + jr, nr);
+                }
+            }
+        };
+
+        if (!detail::use_parallel_gemm(1, M, N, K)) {
+            for (std::size_t rb = 0; rb < row_blocks; ++rb) block(rb * Q::MC, 0, col_panels);
+            return;
+        }
+        auto& pool = default_thread_pool();
+        const std::size_t want   = 2 * pool.size();
+        const std::size_t chunks = std::min(col_panels, std::max<std::size_t>(1, (want + row_blocks - 1) / row_blocks));
+        const std::size_t per    = (col_panels + chunks - 1) / chunks;
+        pool.parallel_for(row_blocks * chunks, [&](std::size_t task) {
+            const std::size_t rb = task / chunks, ch = task % chunks;
+            const std::size_t p0 = ch * per, p1 = std::min(col_panels, p0 + per);
+            if (p0 < p1) block(rb * Q::MC, p0, p1);
+        });
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_QGEMM_H
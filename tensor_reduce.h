@@ -0,0 +1,423 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_REDUCE_H
+#define EPIC1_OFICIAL_TENSOR_REDUCE_H
+
+#include "tensor (8).h"
+#include "tensor_simd.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Reducciones por eje (suma, media, máximo, argmax) de un Tensor de
+// cualquier rango o de una vista 2D con strides. El eje reducido se
+// conserva con tamaño 1: en 2D, el eje 0 da 1 x cols (como un bias) y el
+// eje 1 da rows x 1. Los kernels vectorizan sobre la dimensión contigua
+// (la reducida o la conservada); las vistas sin ninguna dimensión contigua
+// usan un bucle con strides. Se reparten entre hebras solo cuando hay
+// trabajo de sobra, y el orden de las sumas no depende del número de hebras.
+
+namespace utec::algebra {
+
+    namespace detail {
+        // Elementos por bloque en las reducciones paralelas
+        inline constexpr std::size_t reduce_grain = 1 << 15;
+
+        // out[j] += Σ_i x[i][j] sobre `rows` filas de `cols` elementos
+        // separadas `ld`; fila a fila, en orden
+        template<typename T>
+        void accumulate_rows(const T* x, std::size_t rows, std::size_t cols, std::size_t ld, T* out) noexcept {
+            for (std::size_t i = 0; i < rows; ++i, x += ld)
+                simd_for<T>(cols, [&](auto v, std::size_t j) {
+                    using V = decltype(v);
+                    V::store(out + j, V::add(V::load(out + j), V::load(x + j)));
+                });
+        }
+
+        // Reparte las columnas en bloques de unos reduce_grain elementos; cada
+        // columna la recorre una sola tarea, en el mismo orden que en secuencial
+        template<typename T, typename F>
+        void for_column_blocks(std::size_t rows, std::size_t cols, F&& fn) {
+            const std::size_t block = rows * cols > reduce_grain
+                                      ? std::max<std::size_t>(simd<T>::width ? simd<T>::width : 1,
+                                                              reduce_grain / std::max<std::size_t>(rows, 1))
+                                      : cols;
+            parallel_for_blocks(cols, block, fn);
+        }
+
+        // Una tarea por bloque de filas con unos reduce_grain elementos
+        template<typename F>
+        void for_row_blocks(std::size_t rows, std::size_t cols, F&& fn) {
+            parallel_for_blocks(rows, std::max<std::size_t>(1, reduce_grain / std::max<std::size_t>(cols, 1)), fn);
+        }
+
+        // --- Kernels por columnas: reducen `rows` filas separadas `ld` ---
+
+        // out[j] = Σ_i x[i][j]
+        template<typename T>
+        void column_sums(const T* x, std::size_t rows, std::size_t cols, std::size_t ld, T* out) {
+            for_column_blocks<T>(rows, cols, [&](std::size_t b, std::size_t e) {
+                std::fill(out + b, out + e, T(0));
+                accumulate_rows(x + b, rows, e - b, ld, out + b);
+            });
+        }
+
+        template<typename T>
+        void column_max(const T* x, std::size_t rows, std::size_t cols, std::size_t ld, T* out) {
+            for_column_blocks<T>(rows, cols, [&](std::size_t b, std::size_t e) {
+                std::copy(x + b, x + e, out + b);
+                for (std::size_t i = 1; i < rows; ++i) {
+                    const T* r = x + i * ld + b;
+                    simd_for<T>(e - b, [&](auto v, std::size_t j) {
+                        using V = decltype(v);
+                        V::store(out + b + j, V::max(V::load(out + b + j), V::load(r + j)));
+                    });
+                }
+            });
+        }
+
+        // Índice de fila del primer máximo de cada columna. El índice viaja
+        // como T junto al máximo (exacto mientras quepa en la mantisa) y se
+        // actualiza con x - best > 0, que mantiene el primero en los empates
+        template<typename T>
+        void column_argmax(const T* x, std::size_t rows, std::size_t cols, std::size_t ld, std::size_t* out) {
+            constexpr std::size_t exact = std::size_t(1) << std::numeric_limits<T>::digits;
+            for_column_blocks<T>(rows, cols, [&](std::size_t b, std::size_t e) {
+                const std::size_t n = e - b;
+                std::vector<T> best(x + b, x + e);
+                if (rows > exact) {
+                    std::fill(out + b, out + e, std::size_t(0));
+                    for (std::size_t i = 1; i < rows; ++i)
+                        for (std::size_t j = 0; j < n; ++j)
+                            if (x[i * ld + b + j] > best[j]) { best[j] = x[i * ld + b + j]; out[b + j] = i; }
+                    return;
+                }
+                std::vector<T> idx(n, T(0));
+                for (std::size_t i = 1; i < rows; ++i) {
+                    const T* r = x + i * ld + b;
+                    const T fi = static_cast<T>(i);
+                    simd_for<T>(n, [&](auto v, std::size_t j) {
+                        using V = decltype(v);
+                        auto xv = V::load(r + j), bv = V::load(best.data() + j);
+                        auto gt = V::sub(xv, bv);
+                        V::store(idx.data() + j, V::select_gt0(gt, V::set1(fi), V::load(idx.data() + j)));
+                        V::store(best.data() + j, V::select_gt0(gt, xv, bv));
+                    });
+                }
+                for (std::size_t j = 0; j < n; ++j) out[b + j] = static_cast<std::size_t>(idx[j]);
+            });
+        }
+
+        // --- Kernels por fila: reducen n elementos contiguos ---
+
+        template<typename T>
+        T row_sum(const T* x, std::size_t n) noexcept {
+            return simd_reduce<T>(n, [&](auto v, std::size_t i) { return decltype(v)::load(x + i); });
+        }
+
+        template<typename T>
+        T row_max(const T* x, std::size_t n) noexcept {
+            T best = -std::numeric_limits<T>::infinity();
+            std::size_t i = 0;
+            if constexpr (simd<T>::width > 0) {
+                using V = simd<T>;
+                if (n >= V::width) {
+                    auto acc = V::load(x);
+                    for (i = V::width; i + V::width <= n; i += V::width) acc = V::max(acc, V::load(x + i));
+                    alignas(64) T lanes[V::width];
+                    V::store(lanes, acc);
+                    for (T l : lanes) best = l > best ? l : best;
+                }
+            }
+            for (; i < n; ++i) best = x[i] > best ? x[i] : best;
+            return best;
+        }
+
+        // Primer índice del máximo: cada carril lleva su máximo y su índice
+        // (como en column_argmax) y al final gana el mayor, el de menor
+        // índice en los empates
+        template<typename T>
+        std::size_t row_argmax(const T* x, std::size_t n) noexcept {
+            if (n == 0) return 0;
+            T best = x[0];
+            std::size_t arg = 0, i = 1;
+            if constexpr (simd<T>::width > 0) {
+                using V = simd<T>;
+                constexpr std::size_t W = V::width;
+                if (n >= 2 * W && n <= (std::size_t(1) << std::numeric_limits<T>::digits)) {
+                    alignas(64) T vals[W], lane[W];
+                    for (std::size_t k = 0; k < W; ++k) lane[k] = static_cast<T>(k);
+                    auto bv = V::load(x), iv = V::load(lane), cur = iv;
+                    const auto step = V::set1(static_cast<T>(W));
+                    for (i = W; i + W <= n; i += W) {
+                        cur = V::add(cur, step);
+                        auto xv = V::load(x + i);
+                        auto gt = V::sub(xv, bv);
+                        iv = V::select_gt0(gt, cur, iv);
+                        bv = V::select_gt0(gt, xv, bv);
+                    }
+                    V::store(vals, bv);
+                    V::store(lane, iv);
+                    best = vals[0];
+                    arg = static_cast<std::size_t>(lane[0]);
+                    for (std::size_t k = 1; k < W; ++k) {
+                        const auto idx = static_cast<std::size_t>(lane[k]);
+                        if (vals[k] > best || (vals[k] == best && idx < arg)) { best = vals[k]; arg = idx; }
+                    }
+                }
+            }
+            for (; i < n; ++i)
+                if (x[i] > best) { best = x[i]; arg = i; }
+            return arg;
+        }
+
+        // --- Sin dimensión contigua: n elementos separados s ---
+
+        template<typename T>
+        T strided_sum(const T* x, std::size_t n, std::size_t s) noexcept {
+            T acc = T(0);
+            for (std::size_t i = 0; i < n; ++i) acc += x[i * s];
+            return acc;
+        }
+
+        template<typename T>
+        T strided_max(const T* x, std::size_t n, std::size_t s) noexcept {
+            T best = -std::numeric_limits<T>::infinity();
+            for (std::size_t i = 0; i < n; ++i) best = x[i * s] > best ? x[i * s] : best;
+            return best;
+        }
+
+        template<typename T>
+        std::size_t strided_argmax(const T* x, std::size_t n, std::size_t s) noexcept {
+            std::size_t arg = 0;
+            for (std::size_t i = 1; i < n; ++i)
+                if (x[i * s] > x[arg * s]) arg = i;
+            return arg;
+        }
+
+        // Reducción de x[o·os + i·ns + k·is] sobre i < n, con salida
+        // out[o·inner + k]: cubre cualquier eje de un tensor contiguo
+        // (outer, n, inner) y los dos ejes de una vista 2D con strides
+        template<typename T>
+        struct ReduceShape {
+            const T*    data = nullptr;
+            std::size_t outer = 1, os = 0, n = 0, ns = 0, inner = 1, is = 1;
+        };
+
+        // Elige el kernel: por columnas si lo conservado es contiguo, por
+        // fila si lo reducido es contiguo, y con strides si no hay ninguno
+        template<typename T, typename O, typename Col, typename Row, typename Strided>
+        void reduce_dispatch(ReduceShape<T> s, O* out, Col&& col, Row&& row, Strided&& strided) {
+            // Un solo elemento conservado por bloque pero bloques contiguos
+            // (eje 1 de una transpuesta): es una reducción por columnas
+            if (s.inner == 1 && s.outer > 1 && s.os == 1 && s.ns != 1) {
+                s.inner = s.outer;
+                s.outer = 1;
+                s.os = 0;
+            }
+            if (s.outer == 0 || s.inner == 0) return;
+            if (s.inner > 1 && s.is == 1) {
+                if (s.outer == 1) {
+                    col(s.data, s.n, s.inner, s.ns, out);
+                    return;
+                }
+                for_row_blocks(s.outer, s.n * s.inner, [&](std::size_t b, std::size_t e) {
+                    for (std::size_t o = b; o < e; ++o) col(s.data + o * s.os, s.n, s.inner, s.ns, out + o * s.inner);
+                });
+                return;
+            }
+            for_row_blocks(s.outer * s.inner, s.n, [&](std::size_t b, std::size_t e) {
+                for (std::size_t t = b; t < e; ++t) {
+                    const T* p = s.data + (t / s.inner) * s.os + (t % s.inner) * s.is;
+                    out[t] = s.ns == 1 ? row(p, s.n) : strided(p, s.n, s.ns);
+                }
+            });
+        }
+
+        template<typename T>
+        ReduceShape<T> view_reduce_shape(const TensorView<const T,2>& x, std::size_t axis) {
+            if (axis > 1) throw std::invalid_argument("Reduction axis must be 0 or 1");
+            const auto& sh = x.shape();
+            const auto& st = x.strides();
+            if (axis == 0) return { x.data(), 1, 0, sh[0], st[0], sh[1], st[1] };
+            return { x.data(), sh[0], st[0], sh[1], st[1], 1, 1 };
+        }
+
+        template<typename T, std::size_t Rank>
+        ReduceShape<T> tensor_reduce_shape(const Tensor<T,Rank>& x, std::size_t axis) {
+            if (axis >= Rank) throw std::invalid_argument("Reduction axis out of range");
+            const auto& sh = x.shape();
+            ReduceShape<T> s;
+            s.data = x.data();
+            for (std::size_t i = 0; i < axis; ++i) s.outer *= sh[i];
+            for (std::size_t i = axis + 1; i < Rank; ++i) s.inner *= sh[i];
+            s.n = sh[axis];
+            s.ns = s.inner;
+            s.os = s.n * s.inner;
+            return s;
+        }
+
+        template<typename T, typename O>
+        void reduce_sum(const ReduceShape<T>& s, O* out) {
+            reduce_dispatch(s, out,
+                            [](const T* x, std::size_t r, std::size_t c, std::size_t ld, T* o) { column_sums(x, r, c, ld, o); },
+                            [](const T* x, std::size_t n) { return row_sum(x, n); },
+                            [](const T* x, std::size_t n, std::size_t st) { return strided_sum(x, n, st); });
+        }
+
+        template<typename T>
+        void reduce_max(const ReduceShape<T>& s, T* out) {
+            if (s.n == 0) throw std::invalid_argument("max over an empty axis");
+            reduce_dispatch(s, out,
+                            [](const T* x, std::size_t r, std::size_t c, std::size_t ld, T* o) { column_max(x, r, c, ld, o); },
+                            [](const T* x, std::size_t n) { return row_max(x, n); },
+                            [](const T* x, std::size_t n, std::size_t st) { return strided_max(x, n, st); });
+        }
+
+        template<typename T>
+        void reduce_argmax(const ReduceShape<T>& s, std::size_t* out) {
+            if (s.n == 0) throw std::invalid_argument("argmax over an empty axis");
+            reduce_dispatch(s, out,
+                            [](const T* x, std::size_t r, std::size_t c, std::size_t ld, std::size_t* o) { column_argmax(x, r, c, ld, o); },
+                            [](const T* x, std::size_t n) { return row_argmax(x, n); },
+                            [](const T* x, std::size_t n, std::size_t st) { return strided_argmax(x, n, st); });
+        }
+
+        template<typename T>
+        void scale_in_place(T* p, std::size_t n, T factor) noexcept {
+            simd_for<T>(n, [&](auto v, std::size_t i) {
+                using V = decltype(v);
+                V::store(p + i, V::mul(V::load(p + i), V::set1(factor)));
+            });
+        }
+
+        template<typename T, std::size_t Rank>
+        std::array<std::size_t, Rank> keep_axis(std::array<std::size_t, Rank> shape, std::size_t axis) {
+            shape[axis] = 1;
+            return shape;
+        }
+    }
+
+    // --- Vistas 2D (cualquier stride, p. ej. transpose_2d()) ---
+
+    // out = suma de x sobre el eje dado (1 x cols o rows x 1)
+    template<typename T>
+    void sum_axis_into(const std::type_identity_t<TensorView<const T,2>>& x, std::size_t axis, Tensor<T,2>& out) {
+        auto s = detail::view_reduce_shape(x, axis);
+        out.reshape(detail::keep_axis<T,2>(x.shape(), axis));
+        detail::reduce_sum(s, out.data());
+    }
+
+    template<typename T>
+    void mean_axis_into(const std::type_identity_t<TensorView<const T,2>>& x, std::size_t axis, Tensor<T,2>& out) {
+        sum_axis_into<T>(x, axis, out);
+        if (const std::size_t n = x.shape()[axis]) detail::scale_in_place(out.data(), out.size(), T(1) / static_cast<T>(n));
+    }
+
+    template<typename T>
+    void max_axis_into(const std::type_identity_t<TensorView<const T,2>>& x, std::size_t axis, Tensor<T,2>& out) {
+        auto s = detail::view_reduce_shape(x, axis);
+        out.reshape(detail::keep_axis<T,2>(x.shape(), axis));
+        detail::reduce_max(s, out.data());
+    }
+
+    // Índice del primer máximo de cada columna (eje 0) o fila (eje 1),
+    // p. ej. la clase predicha por fila con argmax_axis(pred, 1)
+    template<typename T>
+    void argmax_axis_into(const std::type_identity_t<TensorView<const T,2>>& x, std::size_t axis,
+                          std::vector<std::size_t>& out) {
+        auto s = detail::view_reduce_shape(x, axis);
+        out.resize(x.shape()[1 - axis]);
+        detail::reduce_argmax(s, out.data());
+    }
+
+    // --- Tensores de cualquier rango: el eje reducido queda con tamaño 1 ---
+
+    template<typename T, std::size_t Rank>
+    void sum_axis_into(const Tensor<T,Rank>& x, std::size_t axis, Tensor<T,Rank>& out) {
+        auto s = detail::tensor_reduce_shape(x, axis);
+        out.reshape(detail::keep_axis<T,Rank>(x.shape(), axis));
+        detail::reduce_sum(s, out.data());
+    }
+
+    template<typename T, std::size_t Rank>
+    void mean_axis_into(const Tensor<T,Rank>& x, std::size_t axis, Tensor<T,Rank>& out) {
+        sum_axis_into(x, axis, out);
+        if (const std::size_t n = x.shape()[axis]) detail::scale_in_place(out.data(), out.size(), T(1) / static_cast<T>(n));
+    }
+
+    template<typename T, std::size_t Rank>
+    void max_axis_into(const Tensor<T,Rank>& x, std::size_t axis, Tensor<T,Rank>& out) {
+        auto s = detail::tensor_reduce_shape(x, axis);
+        out.reshape(detail::keep_axis<T,Rank>(x.shape(), axis));
+        detail::reduce_max(s, out.data());
+    }
+
+    // Índices en orden row-major sobre los ejes conservados
+    template<typename T, std::size_t Rank>
+    void argmax_axis_into(const Tensor<T,Rank>& x, std::size_t axis, std::vector<std::size_t>& out) {
+        auto s = detail::tensor_reduce_shape(x, axis);
+        out.resize(s.outer * s.inner);
+        detail::reduce_argmax(s, out.data());
+    }
+
+    // Variantes por valor
+    template<typename T>
+    Tensor<T,2> sum_axis(const TensorView<const T,2>& x, std::size_t axis) {
+        Tensor<T,2> out;
+        sum_axis_into<T>(x, axis, out);
+        return out;
+    }
+    template<typename T>
+    Tensor<T,2> mean_axis(const TensorView<const T,2>& x, std::size_t axis) {
+        Tensor<T,2> out;
+        mean_axis_into<T>(x, axis, out);
+        return out;
+    }
+    template<typename T>
+    Tensor<T,2> max_axis(const TensorView<const T,2>& x, std::size_t axis) {
+        Tensor<T,2> out;
+        max_axis_into<T>(x, axis, out);
+        return out;
+    }
+    template<typename T>
+    std::vector<std::size_t> argmax_axis(const TensorView<const T,2>& x, std::size_t axis) {
+        std::vector<std::size_t> out;
+        argmax_axis_into<T>(x, axis, out);
+        return out;
+    }
+
+    template<typename T, std::size_t Rank>
+    Tensor<T,Rank> sum_axis(const Tensor<T,Rank>& x, std::size_t axis) {
+        Tensor<T,Rank> out;
+        sum_axis_into(x, axis, out);
+        return out;
+    }
+    template<typename T, std::size_t Rank>
+    Tensor<T,Rank> mean_axis(const Tensor<T,Rank>& x, std::size_t axis) {
+        Tensor<T,Rank> out;
+        mean_axis_into(x, axis, out);
+        return out;
+    }
+    template<typename T, std::size_t Rank>
+    Tensor<T,Rank> max_axis(const Tensor<T,Rank>& x, std::size_t axis) {
+        Tensor<T,Rank> out;
+        max_axis_into(x, axis, out);
+        return out;
+    }
+    template<typename T, std::size_t Rank>
+    std::vector<std::size_t> argmax_axis(const Tensor<T,Rank>& x, std::size_t axis) {
+        std::vector<std::size_t> out;
+        argmax_axis_into(x, axis, out);
+        return out;
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_REDUCE_H
@@ -0,0 +1,352 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_SIMD_H
+#define EPIC1_OFICIAL_TENSOR_SIMD_H
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace utec::algebra::detail {
+
+    // Envoltorio SIMD minimo: width == 0 significa "sin SIMD" (fallback escalar).
+    // select_gt0(c, a, b) = c > 0 ? a : b por carril; scale2(p, n) = p * 2^n
+    // con n entero representado en punto flotante.
+    template <typename T>
+    struct simd { static constexpr std::size_t width = 0; };
+
+#if defined(__AVX512F__)
+    template <>
+    struct simd<float> {
+        using reg = __m512;
+        static constexpr std::size_t width = 16;
+        static reg zero() noexcept                    { return _mm512_setzero_ps(); }
+        static reg set1(float v) noexcept             { return _mm512_set1_ps(v); }
+        static reg load(const float* p) noexcept      { return _mm512_loadu_ps(p); }
+        static void store(float* p, reg v) noexcept   { _mm512_storeu_ps(p, v); }
+        static reg add(reg a, reg b) noexcept         { return _mm512_add_ps(a, b); }
+        static reg sub(reg a, reg b) noexcept         { return _mm512_sub_ps(a, b); }
+        static reg mul(reg a, reg b) noexcept         { return _mm512_mul_ps(a, b); }
+        static reg div(reg a, reg b) noexcept         { return _mm512_div_ps(a, b); }
+        static reg max(reg a, reg b) noexcept         { return _mm512_max_ps(a, b); }
+        static reg min(reg a, reg b) noexcept         { return _mm512_min_ps(a, b); }
+        static reg fmadd(reg a, reg b, reg c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+        static reg round(reg a) noexcept {
+            return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static reg scale2(reg p, reg n) noexcept      { return _mm512_scalef_ps(p, n); }
+        static reg select_gt0(reg c, reg a, reg b) noexcept {
+            return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(c, zero(), _CMP_GT_OQ), b, a);
+        }
+        static float hsum(reg a) noexcept             { return _mm512_reduce_add_ps(a); }
+        static reg exponent(reg a) noexcept           { return _mm512_getexp_ps(a); }
+        static reg mantissa(reg a) noexcept {
+            return _mm512_getmant_ps(a, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+        }
+    };
+    template <>
+    struct simd<double> {
+        using reg = __m512d;
+        static constexpr std::size_t width = 8;
+        static reg zero() noexcept                    { return _mm512_setzero_pd(); }
+        static reg set1(double v) noexcept            { return _mm512_set1_pd(v); }
+        static reg load(const double* p) noexcept     { return _mm512_loadu_pd(p); }
+        static void store(double* p, reg v) noexcept  { _mm512_storeu_pd(p, v); }
+        static reg add(reg a, reg b) noexcept         { return _mm512_add_pd(a, b); }
+        static reg sub(reg a, reg b) noexcept         { return _mm512_sub_pd(a, b); }
+        static reg mul(reg a, reg b) noexcept         { return _mm512_mul_pd(a, b); }
+        static reg div(reg a, reg b) noexcept         { return _mm512_div_pd(a, b); }
+        static reg max(reg a, reg b) noexcept         { return _mm512_max_pd(a, b); }
+        static reg min(reg a, reg b) noexcept         { return _mm512_min_pd(a, b); }
+        static reg fmadd(reg a, reg b, reg c) noexcept { return _mm512_fmadd_pd(a, b, c); }
+        static reg round(reg a) noexcept {
+            return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static reg scale2(reg p, reg n) noexcept      { return _mm512_scalef_pd(p, n); }
+        static reg select_gt0(reg c, reg a, reg b) noexcept {
+            return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(c, zero(), _CMP_GT_OQ), b, a);
+        }
+        static double hsum(reg a) noexcept            { return _mm512_reduce_add_pd(a); }
+        static reg exponent(reg a) noexcept           { return _mm512_getexp_pd(a); }
+        static reg mantissa(reg a) noexcept {
+            return _mm512_getmant_pd(a, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+        }
+    };
+#elif defined(__AVX2__) && defined(__FMA__)
+    template <>
+    struct simd<float> {
+        using reg = __m256;
+        static constexpr std::size_t width = 8;
+        static reg zero() noexcept                    { return _mm256_setzero_ps(); }
+        static reg set1(float v) noexcept             { return _mm256_set1_ps(v); }
+        static reg load(const float* p) noexcept      { return _mm256_loadu_ps(p); }
+        static void store(float* p, reg v) noexcept   { _mm256_storeu_ps(p, v); }
+        static reg add(reg a, reg b) noexcept         { return _mm256_add_ps(a, b); }
+        static reg sub(reg a, reg b) noexcept         { return _mm256_sub_ps(a, b); }
+        static reg mul(reg a, reg b) noexcept         { return _mm256_mul_ps(a, b); }
+        static reg div(reg a, reg b) noexcept         { return _mm256_div_ps(a, b); }
+        static reg max(reg a, reg b) noexcept         { return _mm256_max_ps(a, b); }
+        static reg min(reg a, reg b) noexcept         { return _mm256_min_ps(a, b); }
+        static reg fmadd(reg a, reg b, reg c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+        static reg round(reg a) noexcept {
+            return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        // Construye 2^n directamente en el campo exponente
+        static reg scale2(reg p, reg n) noexcept {
+            __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                                           _mm256_set1_epi32(127)), 23);
+            return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+        }
+        static reg select_gt0(reg c, reg a, reg b) noexcept {
+            return _mm256_blendv_ps(b, a, _mm256_cmp_ps(c, zero(), _CMP_GT_OQ));
+        }
+        static float hsum(reg a) noexcept {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+            s = _mm_hadd_ps(s, s);
+            return _mm_cvtss_f32(_mm_hadd_ps(s, s));
+        }
+        // Campos del formato IEEE (solo para x > 0 normal)
+        static reg exponent(reg a) noexcept {
+            __m256i e = _mm256_srli_epi32(_mm256_castps_si256(a), 23);
+            return _mm256_cvtepi32_ps(_mm256_sub_epi32(e, _mm256_set1_epi32(127)));
+        }
+        static reg mantissa(reg a) noexcept {
+            __m256i m = _mm256_and_si256(_mm256_castps_si256(a), _mm256_set1_epi32(0x007fffff));
+            return _mm256_castsi256_ps(_mm256_or_si256(m, _mm256_set1_epi32(0x3f800000)));
+        }
+    };
+    template <>
+    struct simd<double> {
+        using reg = __m256d;
+        static constexpr std::size_t width = 4;
+        static reg zero() noexcept                    { return _mm256_setzero_pd(); }
+        static reg set1(double v) noexcept            { return _mm256_set1_pd(v); }
+        static reg load(const double* p) noexcept     { return _mm256_loadu_pd(p); }
+        static void store(double* p, reg v) noexcept  { _mm256_storeu_pd(p, v); }
+        static reg add(reg a, reg b) noexcept         { return _mm256_add_pd(a, b); }
+        static reg sub(reg a, reg b) noexcept         { return _mm256_sub_pd(a, b); }
+        static reg mul(reg a, reg b) noexcept         { return _mm256_mul_pd(a, b); }
+        static reg div(reg a, reg b) noexcept         { return _mm256_div_pd(a, b); }
+        static reg max(reg a, reg b) noexcept         { return _mm256_max_pd(a, b); }
+        static reg min(reg a, reg b) noexcept         { return _mm256_min_pd(a, b); }
+        static reg fmadd(reg a, reg b, reg c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+        static reg round(reg a) noexcept {
+            return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static reg scale2(reg p, reg n) noexcept {
+            __m256i e = _mm256_slli_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)),
+                                                           _mm256_set1_epi64x(1023)), 52);
+            return _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+        }
+        static reg select_gt0(reg c, reg a, reg b) noexcept {
+            return _mm256_blendv_pd(b, a, _mm256_cmp_pd(c, zero(), _CMP_GT_OQ));
+        }
+        static double hsum(reg a) noexcept {
+            __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+            return _mm_cvtsd_f64(_mm_hadd_pd(s, s));
+        }
+        // Sin AVX-512DQ no hay int64 -> double: el exponente sesgado se pega a
+        // la mantisa de 2^52 y se resta
+        static reg exponent(reg a) noexcept {
+            __m256i e = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+            __m256d d = _mm256_castsi256_pd(_mm256_or_si256(e, _mm256_set1_epi64x(0x4330000000000000LL)));
+            return _mm256_sub_pd(d, _mm256_set1_pd(4503599627370496.0 + 1023.0));
+        }
+        static reg mantissa(reg a) noexcept {
+            __m256i m = _mm256_and_si256(_mm256_castpd_si256(a), _mm256_set1_epi64x(0x000fffffffffffffLL));
+            return _mm256_castsi256_pd(_mm256_or_si256(m, _mm256_set1_epi64x(0x3ff0000000000000LL)));
+        }
+    };
+#endif
+
+    // Mismo interfaz con un solo carril: colas de los bucles y fallback sin SIMD
+    template <typename T>
+    struct scalar_simd {
+        using reg = T;
+        static constexpr std::size_t width = 1;
+        static reg zero() noexcept                    { return T(0); }
+        static reg set1(T v) noexcept                 { return v; }
+        static reg load(const T* p) noexcept          { return *p; }
+        static void store(T* p, reg v) noexcept       { *p = v; }
+        static reg add(reg a, reg b) noexcept         { return a + b; }
+        static reg sub(reg a, reg b) noexcept         { return a - b; }
+        static reg mul(reg a, reg b) noexcept         { return a * b; }
+        static reg div(reg a, reg b) noexcept         { return a / b; }
+        static reg max(reg a, reg b) noexcept         { return a > b ? a : b; }
+        static reg min(reg a, reg b) noexcept         { return a < b ? a : b; }
+        // Es la cola de simd_for: con FMA/SSE4.1 redondea como los carriles
+        // SIMD (FMA exacta, empates al par) para dar los mismos bits. Sin
+        // ellas, std::fma, std::nearbyint y std::ldexp son llamadas a libm
+#if defined(__FMA__) || defined(__AVX512F__)
+        static reg fmadd(reg a, reg b, reg c) noexcept { return std::fma(a, b, c); }
+#else
+        static reg fmadd(reg a, reg b, reg c) noexcept { return a * b + c; }
+#endif
+#if defined(__SSE4_1__)
+        static reg round(reg a) noexcept { return std::nearbyint(a); }
+#else
+        static reg round(reg a) noexcept {
+            return static_cast<T>(static_cast<long long>(a + (a < T(0) ? T(-0.5) : T(0.5))));
+        }
+#endif
+        // Requiere 2^n normal (vexp lo garantiza al acotar x)
+        static reg scale2(reg p, reg n) noexcept {
+            auto e = static_cast<bits_t>(static_cast<long long>(n) + bias) << mant;
+            return p * std::bit_cast<T>(e);
+        }
+        static reg select_gt0(reg c, reg a, reg b) noexcept { return c > T(0) ? a : b; }
+        static T hsum(reg a) noexcept                 { return a; }
+        static reg exponent(reg a) noexcept {
+            auto bits = std::bit_cast<bits_t>(a) >> mant;
+            return static_cast<T>(static_cast<long long>(bits) - bias);
+        }
+        static reg mantissa(reg a) noexcept {
+            constexpr bits_t frac = (bits_t(1) << mant) - 1;
+            return std::bit_cast<T>((std::bit_cast<bits_t>(a) & frac) | (bits_t(bias) << mant));
+        }
+    private:
+        using bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        static constexpr int mant = std::numeric_limits<T>::digits - 1;
+        static constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+    };
+
+    // Recorre [0, n): fn(V{}, i) con el ancho SIMD nativo y la cola con scalar_simd
+    template <typename T, typename F>
+    void simd_for(std::size_t n, F&& fn) {
+        std::size_t i = 0;
+        if constexpr (simd<T>::width > 0)
+            for (; i + simd<T>::width <= n; i += simd<T>::width) fn(simd<T>{}, i);
+        for (; i < n; ++i) fn(scalar_simd<T>{}, i);
+    }
+
+    // Suma de fn(V{}, i) sobre [0, n): acumulador vectorial y una sola
+    // reducción horizontal al final; la cola se suma en escalar
+    template <typename T, typename F>
+    T simd_reduce(std::size_t n, F&& fn) {
+        T total = T(0);
+        std::size_t i = 0;
+        if constexpr (simd<T>::width > 0) {
+            using V = simd<T>;
+            auto acc = V::zero();
+            for (; i + V::width <= n; i += V::width) acc = V::add(acc, fn(V{}, i));
+            total = V::hsum(acc);
+        }
+        for (; i < n; ++i) total += fn(scalar_simd<T>{}, i);
+        return total;
+    }
+
+    // Constantes de exp: rango sin desbordar 2^n, ln2 partido en dos (Cody-Waite)
+    // y grado del polinomio de Taylor para e^r con |r| <= ln2/2.
+    template <typename T>
+    struct exp_consts;
+    template <>
+    struct exp_consts<float> {
+        static constexpr float lo = -87.0f, hi = 88.0f;
+        static constexpr float ln2_hi = 0.693359375f, ln2_lo = -2.12194440e-4f;
+        static constexpr int degree = 7;      // resto de Taylor <= 1.1e-8 relativo
+    };
+    template <>
+    struct exp_consts<double> {
+        static constexpr double lo = -708.0, hi = 709.0;
+        static constexpr double ln2_hi = 6.93145751953125e-1, ln2_lo = 1.42860682030941723212e-6;
+        static constexpr int degree = 12;     // resto de Taylor <= 3.4e-16 relativo
+    };
+
+    template <typename T, int D>
+    constexpr std::array<T, D + 1> taylor_coefs() {
+        std::array<T, D + 1> c{};
+        c[0] = T(1);
+        for (int k = 1; k <= D; ++k) c[k] = c[k - 1] / T(k);
+        return c;
+    }
+
+    // e^x = 2^n · e^r, n = round(x / ln2). Satura fuera de [lo, hi] en vez de
+    // devolver 0/inf; el error viene solo del polinomio (cota en exp_consts).
+    template <typename V, typename T>
+    typename V::reg vexp(typename V::reg x) noexcept {
+        using C = exp_consts<T>;
+        x = V::min(V::max(x, V::set1(C::lo)), V::set1(C::hi));
+        auto n = V::round(V::mul(x, V::set1(T(1.4426950408889634))));
+        auto r = V::fmadd(n, V::set1(-C::ln2_hi), x);
+        r = V::fmadd(n, V::set1(-C::ln2_lo), r);
+        // Horner con coeficientes 1/k!
+        constexpr auto c = taylor_coefs<T, C::degree>();
+        auto p = V::set1(c[C::degree]);
+        for (int k = C::degree - 1; k >= 0; --k) p = V::fmadd(p, r, V::set1(c[k]));
+        return V::scale2(p, n);
+    }
+
+    // ln x = e·ln2 + ln m, m en [sqrt(1/2), sqrt(2)); ln m = 2·atanh(s) con
+    // s = (m-1)/(m+1), |s| <= 0.1716, por su serie impar. Solo para x > 0 normal.
+    template <typename T>
+    struct log_consts;
+    template <>
+    struct log_consts<float> {
+        static constexpr int terms = 5;       // resto <= 2e-9 relativo
+    };
+    template <>
+    struct log_consts<double> {
+        static constexpr int terms = 10;      // resto <= 3e-17 relativo
+    };
+
+    template <typename T, int N>
+    constexpr std::array<T, N> atanh_coefs() {
+        std::array<T, N> c{};
+        for (int j = 0; j < N; ++j) c[j] = T(1) / T(2 * j + 1);
+        return c;
+    }
+
+    template <typename V, typename T>
+    typename V::reg vlog(typename V::reg x) noexcept {
+        constexpr int N = log_consts<T>::terms;
+        constexpr auto c = atanh_coefs<T, N>();
+        auto m = V::mantissa(x);
+        auto e = V::exponent(x);
+        auto over = V::sub(m, V::set1(T(1.4142135623730951)));
+        m = V::select_gt0(over, V::mul(m, V::set1(T(0.5))), m);
+        e = V::select_gt0(over, V::add(e, V::set1(T(1))), e);
+        auto s = V::div(V::sub(m, V::set1(T(1))), V::add(m, V::set1(T(1))));
+        auto z = V::mul(s, s);
+        auto p = V::set1(c[N - 1]);
+        for (int j = N - 2; j >= 0; --j) p = V::fmadd(p, z, V::set1(c[j]));
+        return V::fmadd(e, V::set1(T(0.6931471805599453)), V::mul(V::add(s, s), p));
+    }
+
+}
+
+namespace utec::algebra {
+
+    // Precisión de las funciones trascendentes de activaciones y pérdidas: fast
+    // usa vexp/vlog vectorizados (si hay SIMD); accurate, las funciones de libm.
+    enum class MathMode { fast, accurate };
+
+    struct VMathConfig {
+        MathMode mode = MathMode::fast;
+    };
+
+    inline VMathConfig& vmath_config() {
+        static VMathConfig cfg;
+        return cfg;
+    }
+
+    namespace detail {
+        // Sin SIMD el polinomio escalar no gana a libm: se usa libm también en modo fast
+        template <typename T>
+        bool use_libm() noexcept {
+            return simd<T>::width == 0 || vmath_config().mode == MathMode::accurate;
+        }
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_SIMD_H
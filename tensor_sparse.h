@@ -0,0 +1,203 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_TENSOR_SPARSE_H
+#define EPIC1_OFICIAL_TENSOR_SPARSE_H
+
+#include "tensor (8).h"
+#include "tensor_simd.h"
+#include "thread_pool.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Matrices dispersas en formato CSR para entradas one-hot / bag-of-features:
+// coste y memoria proporcionales al número de no-ceros, no a las columnas.
+
+namespace utec::algebra {
+
+    template<typename T>
+    class CsrMatrix {
+    public:
+        using index_type = std::uint32_t;
+        using Shape      = std::array<std::size_t, 2>;
+
+        CsrMatrix() = default;
+
+        // Matriz vacía de `cols` columnas; las filas se añaden con push_row
+        explicit CsrMatrix(std::size_t cols) : cols_(cols) { check_cols(cols); }
+
+        CsrMatrix(std::size_t rows, std::size_t cols, std::vector<std::size_t> row_ptr,
+                  std::vector<index_type> col_idx, std::vector<T> values)
+                : rows_(rows), cols_(cols), row_ptr_(std::move(row_ptr)),
+                  col_idx_(std::move(col_idx)), values_(std::move(values)) {
+            check_cols(cols);
+            if (row_ptr_.size() != rows + 1 || row_ptr_.front() != 0)
+                throw std::invalid_argument("CSR row pointer must have rows + 1 entries starting at 0");
+            if (col_idx_.size() != values_.size() || row_ptr_.back() != values_.size())
+                throw std::invalid_argument("CSR row pointer does not match the number of non-zeros");
+            for (std::size_t r = 0; r < rows; ++r)
+                if (row_ptr_[r] > row_ptr_[r + 1])
+                    throw std::invalid_argument("CSR row pointer must be non-decreasing");
+            for (index_type c : col_idx_)
+                if (c >= cols)
+                    throw std::out_of_range("CSR column index out of range");
+        }
+
+        // Conserva solo los elementos distintos de cero
+        static CsrMatrix from_dense(const Tensor<T,2>& dense) {
+            const std::size_t rows = dense.shape()[0], cols = dense.shape()[1];
+            CsrMatrix m(cols);
+            m.row_ptr_.reserve(rows + 1);
+            const T* p = dense.data();
+            for (std::size_t r = 0; r < rows; ++r, p += cols) {
+                for (std::size_t c = 0; c < cols; ++c)
+                    if (p[c] != T(0)) {
+                        m.col_idx_.push_back(static_cast<index_type>(c));
+                        m.values_.push_back(p[c]);
+                    }
+                m.row_ptr_.push_back(m.values_.size());
+            }
+            m.rows_ = rows;
+            return m;
+        }
+
+        Tensor<T,2> to_dense() const {
+            Tensor<T,2> out(rows_, cols_);
+            out.fill(T(0));
+            for (std::size_t r = 0; r < rows_; ++r)
+                for (std::size_t k = row_ptr_[r]; k < row_ptr_[r + 1]; ++k)
+                    out.data()[r * cols_ + col_idx_[k]] = values_[k];
+            return out;
+        }
+
+        // Añade una fila con n pares (columna, valor)
+        void push_row(const index_type* cols, const T* vals, std::size_t n) {
+            for (std::size_t k = 0; k < n; ++k) {
+                if (cols[k] >= cols_) throw std::out_of_range("CSR column index out of range");
+                col_idx_.push_back(cols[k]);
+                values_.push_back(vals[k]);
+            }
+            row_ptr_.push_back(values_.size());
+            ++rows_;
+        }
+
+        void reserve(std::size_t rows, std::size_t nnz) {
+            row_ptr_.reserve(rows + 1);
+            col_idx_.reserve(nnz);
+            values_.reserve(nnz);
+        }
+
+        // *this = filas idx[0..count) de src (reutiliza la capacidad reservada)
+        void gather_rows(const CsrMatrix& src, const std::size_t* idx, std::size_t count) {
+            cols_ = src.cols_;
+            rows_ = count;
+            row_ptr_.resize(count + 1);
+            std::size_t nnz = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                nnz += src.row_nnz(idx[r]);
+                row_ptr_[r + 1] = nnz;
+            }
+            col_idx_.resize(nnz);
+            values_.resize(nnz);
+            for (std::size_t r = 0; r < count; ++r) {
+                const std::size_t b = src.row_ptr_[idx[r]], n = src.row_nnz(idx[r]);
+                std::copy_n(src.col_idx_.data() + b, n, col_idx_.data() + row_ptr_[r]);
+                std::copy_n(src.values_.data() + b, n, values_.data() + row_ptr_[r]);
+            }
+        }
+
+        Shape shape() const noexcept { return {rows_, cols_}; }
+        std::size_t rows() const noexcept { return rows_; }
+        std::size_t cols() const noexcept { return cols_; }
+        std::size_t nnz() const noexcept { return values_.size(); }
+        std::size_t row_nnz(std::size_t r) const noexcept { return row_ptr_[r + 1] - row_ptr_[r]; }
+        // Bytes de los tres arreglos (lo que recorre un producto)
+        std::size_t bytes() const noexcept {
+            return (rows_ ? row_ptr_.size() * sizeof(std::size_t) : 0) + nnz() * (sizeof(index_type) + sizeof(T));
+        }
+
+        const std::vector<std::size_t>& row_ptr() const noexcept { return row_ptr_; }
+        const std::vector<index_type>& col_idx() const noexcept { return col_idx_; }
+        const std::vector<T>& values() const noexcept { return values_; }
+
+    private:
+        std::size_t             rows_ = 0, cols_ = 0;
+        std::vector<std::size_t> row_ptr_{0};
+        std::vector<index_type> col_idx_;
+        std::vector<T>          values_;
+
+        static void check_cols(std::size_t cols) {
+            if (cols > std::numeric_limits<index_type>::max())
+                throw std::invalid_argument("CSR matrices support at most 2^32 - 1 columns");
+        }
+    };
+
+    namespace detail {
+        // Filas de A por bloque en el SpMM paralelo
+        inline constexpr std::size_t spmm_grain_rows = 64;
+
+        // y += a · x sobre n elementos
+        template<typename T>
+        void axpy(std::size_t n, T a, const T* x, T* y) noexcept {
+            simd_for<T>(n, [&](auto v, std::size_t i) {
+                using V = decltype(v);
+                V::store(y + i, V::fmadd(V::set1(a), V::load(x + i), V::load(y + i)));
+            });
+        }
+    }
+
+    // C = A · B con A dispersa (m x k) y B densa (k x n), más el epílogo por
+    // fila epi(fila, 0, ptr, n) como en matrix_product_into. Cada fila de C
+    // suma solo las filas de B que indican los no-ceros de A.
+    template<typename T, typename Epi = detail::no_epilogue>
+    void spmm_into(const CsrMatrix<T>& a, const std::type_identity_t<TensorView<const T,2>>& b,
+                   Tensor<T,2>& c, Epi epi = {}) {
+        if (a.cols() != b.shape()[0])
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        if (b.strides()[1] != 1)
+            throw std::invalid_argument("spmm_into requires a row-contiguous dense operand");
+        const std::size_t m = a.rows(), n = b.shape()[1], ldb = b.strides()[0];
+        c.reshape(m, n);
+        const std::size_t* rp = a.row_ptr().data();
+        const auto* ci = a.col_idx().data();
+        const T* av = a.values().data();
+        const T* bp = b.data();
+        T* cp = c.data();
+        parallel_for_blocks(m, detail::spmm_grain_rows, [&](std::size_t r0, std::size_t r1) {
+            for (std::size_t r = r0; r < r1; ++r) {
+                T* row = cp + r * n;
+                std::fill(row, row + n, T(0));
+                for (std::size_t k = rp[r]; k < rp[r + 1]; ++k)
+                    detail::axpy(n, av[k], bp + ci[k] * ldb, row);
+                if constexpr (detail::epilogue_enabled<Epi>::value) epi(r, 0, row, n);
+            }
+        });
+    }
+
+    // out += Aᵀ · G con A dispersa (m x k), G densa (m x n) y out k x n
+    // contigua: solo se escriben las filas de out cuyas columnas de A tienen
+    // algún no-cero. Secuencial (varias filas de A pueden tocar la misma fila)
+    template<typename T>
+    void spmm_tn_accumulate(const CsrMatrix<T>& a, const std::type_identity_t<TensorView<const T,2>>& g, T* out) {
+        if (a.rows() != g.shape()[0])
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        if (g.strides()[1] != 1)
+            throw std::invalid_argument("spmm_tn_accumulate requires a row-contiguous dense operand");
+        const std::size_t n = g.shape()[1], ldg = g.strides()[0];
+        const std::size_t* rp = a.row_ptr().data();
+        const auto* ci = a.col_idx().data();
+        const T* av = a.values().data();
+        for (std::size_t r = 0; r < a.rows(); ++r)
+            for (std::size_t k = rp[r]; k < rp[r + 1]; ++k)
+                detail::axpy(n, av[k], g.data() + r * ldg, out + ci[k] * n);
+    }
+
+}
+
+#endif //EPIC1_OFICIAL_TENSOR_SPARSE_H
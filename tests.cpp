@@ -0,0 +1,1384 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+// Pruebas de regresión: cada caso compara una ruta optimizada con la ruta
+// de referencia (bit a bit cuando deben coincidir exactamente).
+//
+//   neural_net_tests [caso]    sin argumento corre todos
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tensor (8).h"
+#include "tensor_reduce.h"
+#include "nn_dense (5).h"
+#include "nn_activation (3).h"
+#include "nn_loss (5).h"
+#include "nn_optimizer (5).h"
+#include "neural_network (4).h"
+#include "nn_batching.h"
+#include "nn_quantization.h"
+#include "nn_serialization.h"
+#include "nn_dataset.h"
+#include "nn_data_parallel.h"
+#include "nn_static.h"
+#include "nn_pipeline_parallel.h"
+
+namespace {
+
+    using namespace utec::neural_network;
+
+#define CHECK(cond)                                                                            \
+    do {                                                                                       \
+        if (!(cond))                                                                           \
+            throw std::runtime_error(std::string(__FILE__) + ":" + std::to_string(__LINE__) + \
+                                     ": CHECK(" #cond ") failed");                             \
+    } while (0)
+
+    template<typename T, std::size_t R>
+    bool same_bits(const utec::algebra::Tensor<T,R>& a, const utec::algebra::Tensor<T,R>& b) {
+        return a.shape() == b.shape() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+    }
+
+    template<typename T, std::size_t R>
+    void fill_random(utec::algebra::Tensor<T,R>& t, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (auto& v : t) v = static_cast<T>(dist(rng));
+    }
+
+    // C = A·B con acumulación en double; `bound` recibe Σ|a||b| para la
+    // tolerancia del redondeo
+    template<typename T>
+    void naive_product(const T* a, const T* b, std::size_t M, std::size_t K, std::size_t N,
+                       std::vector<double>& c, std::vector<double>& bound) {
+        c.assign(M * N, 0.0);
+        bound.assign(M * N, 0.0);
+        for (std::size_t i = 0; i < M; ++i)
+            for (std::size_t k = 0; k < K; ++k)
+                for (std::size_t j = 0; j < N; ++j) {
+                    c[i * N + j] += double(a[i * K + k]) * double(b[k * N + j]);
+                    bound[i * N + j] += std::abs(double(a[i * K + k]) * double(b[k * N + j]));
+                }
+    }
+
+    template<typename T>
+    bool matches_naive(const T* a, const T* b, const T* c, std::size_t M, std::size_t K, std::size_t N) {
+        std::vector<double> ref, bound;
+        naive_product(a, b, M, K, N, ref, bound);
+        const double eps = std::numeric_limits<T>::epsilon();
+        for (std::size_t i = 0; i < M * N; ++i)
+            if (std::abs(double(c[i]) - ref[i]) > 2.0 * double(K) * eps * bound[i] + 1e-30) return false;
+        return true;
+    }
+
+    // Formas impares alrededor de los bloques del micro-kernel y de las
+    // tiras MC/KC/NC
+    const std::vector<std::array<std::size_t, 3>> odd_shapes = {
+        {1, 1, 1}, {1, 7, 1}, {3, 5, 7}, {17, 31, 13}, {7, 300, 9}, {67, 129, 65}, {131, 257, 301},
+    };
+
+    // Datos de regresión deterministas: y = tanh(Σ w_j x_j)
+    struct Dataset {
+        utec::algebra::Tensor<float,2> X, Y;
+    };
+
+    Dataset make_data(std::size_t n, std::size_t features, unsigned seed = 1) {
+        Dataset d{utec::algebra::Tensor<float,2>(n, features), utec::algebra::Tensor<float,2>(n, 1)};
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> dist;
+        for (std::size_t i = 0; i < n; ++i) {
+            float s = 0;
+            for (std::size_t j = 0; j < features; ++j) {
+                d.X(i, j) = dist(rng);
+                s += d.X(i, j) * (j % 3 ? 0.1f : -0.2f);
+            }
+            d.Y(i, 0) = std::tanh(s);
+        }
+        return d;
+    }
+
+    // MLP de Dense sueltas con activaciones (fusionables con fuse_layers);
+    // pesos deterministas
+    NeuralNetwork<float> make_net(std::size_t in, std::size_t width, std::size_t depth, bool fuse = false) {
+        std::mt19937 rng(7);
+        auto init_w = [&](utec::algebra::Tensor<float,2>& w) {
+            std::normal_distribution<float> dist(0.f, 0.1f);
+            for (auto& v : w) v = dist(rng);
+        };
+        auto init_b = [](utec::algebra::Tensor<float,2>& b) { b.fill(0.01f); };
+        NeuralNetwork<float> net;
+        net.add_layer(std::make_unique<Dense<float>>(in, width, init_w, init_b));
+        net.add_layer(std::make_unique<ReLU<float>>());
+        for (std::size_t i = 0; i < depth; ++i) {
+            net.add_layer(std::make_unique<Dense<float>>(width, width, init_w, init_b));
+            net.add_layer(std::make_unique<Sigmoid<float>>());
+        }
+        net.add_layer(std::make_unique<Dense<float>>(width, 1, init_w, init_b));
+        if (fuse) net.fuse_layers();
+        return net;
+    }
+
+    bool close_to(const utec::algebra::Tensor<float,2>& a, const utec::algebra::Tensor<float,2>& b,
+                  float tol = 1e-5f) {
+        if (a.shape() != b.shape()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (std::abs(a.data()[i] - b.data()[i]) > tol * (1 + std::abs(b.data()[i]))) return false;
+        return true;
+    }
+
+    // --- Casos ---
+
+    // matrix_product 2D y 3D contra el triple bucle, en float, double e int
+    // (kernel escalar)
+    template<typename T>
+    void gemm_case() {
+        unsigned seed = 1;
+        for (auto [M, K, N] : odd_shapes) {
+            utec::algebra::Tensor<T,2> a(M, K), b(K, N);
+            fill_random(a, seed++);
+            fill_random(b, seed++);
+            const auto c = utec::algebra::matrix_product(a, b);
+            CHECK((c.shape() == std::array<std::size_t, 2>{M, N}));
+            CHECK(matches_naive(a.data(), b.data(), c.data(), M, K, N));
+        }
+        for (auto [M, K, N] : odd_shapes) {
+            const std::size_t B = 3;
+            utec::algebra::Tensor<T,3> a(B, M, K), b(B, K, N);
+            fill_random(a, seed++);
+            fill_random(b, seed++);
+            const auto c = utec::algebra::matrix_product(a, b);
+            for (std::size_t s = 0; s < B; ++s)
+                CHECK(matches_naive(a.data() + s * M * K, b.data() + s * K * N, c.data() + s * M * N, M, K, N));
+        }
+    }
+
+    void gemm_matches_reference() {
+        gemm_case<float>();
+        gemm_case<double>();
+
+        utec::algebra::Tensor<int,2> a(5, 3), b(3, 4);
+        for (std::size_t i = 0; i < a.size(); ++i) a.data()[i] = int(i % 7) - 3;
+        for (std::size_t i = 0; i < b.size(); ++i) b.data()[i] = int(i % 5) - 2;
+        const auto c = utec::algebra::matrix_product(a, b);
+        for (std::size_t i = 0; i < 5; ++i)
+            for (std::size_t j = 0; j < 4; ++j) {
+                int s = 0;
+                for (std::size_t k = 0; k < 3; ++k) s += a(i, k) * b(k, j);
+                CHECK(c(i, j) == s);
+            }
+
+        utec::algebra::Tensor<float,2> x(2, 3), y(4, 2);
+        bool threw = false;
+        try {
+            utec::algebra::matrix_product(x, y);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Con el pool (y el umbral a 0 para que las formas pequeñas también se
+    // repartan) el resultado es bit a bit el de una sola hebra: cada tile
+    // recorre K en el mismo orden
+    void parallel_matrix_product() {
+        auto& cfg = utec::algebra::gemm_config();
+        const auto saved = cfg;
+        const std::size_t threads = utec::algebra::num_threads();
+        unsigned seed = 100;
+        for (auto [M, K, N] : odd_shapes) {
+            utec::algebra::Tensor<float,2> a(M, K), b(K, N);
+            utec::algebra::Tensor<double,3> a3(4, M, K), b3(4, K, N);
+            fill_random(a, seed++);
+            fill_random(b, seed++);
+            fill_random(a3, seed++);
+            fill_random(b3, seed++);
+            utec::algebra::set_num_threads(1);
+            const auto c = utec::algebra::matrix_product(a, b);
+            const auto c3 = utec::algebra::matrix_product(a3, b3);
+            utec::algebra::set_num_threads(4);
+            cfg.min_parallel_flops = 0;
+            CHECK(same_bits(c, utec::algebra::matrix_product(a, b)));
+            CHECK(same_bits(c3, utec::algebra::matrix_product(a3, b3)));
+            cfg = saved;
+        }
+        utec::algebra::set_num_threads(threads);
+    }
+
+    // Una tarea que lanza en el pool llega al llamador y el pool sigue útil
+    void thread_pool_exceptions() {
+        utec::algebra::ThreadPool pool(4);
+        for (int round = 0; round < 20; ++round) {
+            bool threw = false;
+            try {
+                pool.parallel_for(64, [](std::size_t i) {
+                    if (i % 7 == 3) throw std::runtime_error("task failed");
+                });
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            CHECK(threw);
+        }
+        std::atomic<std::size_t> done{0};
+        pool.parallel_for(100, [&](std::size_t) { ++done; });
+        CHECK(done == 100);
+    }
+
+    // train() con mini-batches equivale a un train de un solo lote por
+    // mini-batch con el mismo barajado; batch_size 0, n o mayor que n son
+    // un único lote, y la semilla fija el orden
+    void minibatch_training() {
+        const std::size_t n = 100, bs = 16;
+        auto data = make_data(n, 8);
+        auto net = make_net(8, 16, 1);
+        net.set_seed(11);
+        net.train<MSELoss>(data.X, data.Y, 2, bs, 0.05f);
+
+        auto ref = make_net(8, 16, 1);
+        std::mt19937 rng(11);
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        for (int e = 0; e < 2; ++e) {
+            std::shuffle(order.begin(), order.end(), rng);
+            for (std::size_t first = 0; first < n; first += bs) {
+                const std::size_t count = std::min(bs, n - first);
+                utec::algebra::Tensor<float,2> xb(count, 8), yb(count, 1);
+                for (std::size_t r = 0; r < count; ++r) {
+                    for (std::size_t j = 0; j < 8; ++j) xb(r, j) = data.X(order[first + r], j);
+                    yb(r, 0) = data.Y(order[first + r], 0);
+                }
+                ref.train<MSELoss>(xb, yb, 1, 0, 0.05f);
+            }
+        }
+        CHECK(close_to(net.predict(data.X), ref.predict(data.X)));
+
+        utec::algebra::Tensor<float,2> full[3];
+        const std::size_t sizes[3] = {0, n, 10 * n};
+        for (std::size_t k = 0; k < 3; ++k) {
+            auto m = make_net(8, 16, 1);
+            m.train<MSELoss>(data.X, data.Y, 3, sizes[k], 0.05f);
+            full[k] = m.predict(data.X);
+        }
+        CHECK(same_bits(full[0], full[1]) && same_bits(full[0], full[2]));
+
+        auto again = make_net(8, 16, 1);
+        again.set_seed(11);
+        again.train<MSELoss>(data.X, data.Y, 2, bs, 0.05f);
+        CHECK(same_bits(net.predict(data.X), again.predict(data.X)));
+        auto other = make_net(8, 16, 1);
+        other.set_seed(12);
+        other.train<MSELoss>(data.X, data.Y, 2, bs, 0.05f);
+        CHECK(!same_bits(net.predict(data.X), other.predict(data.X)));
+
+        utec::algebra::Tensor<float,2> wrong(n + 1, 1);
+        bool threw = false;
+        try {
+            net.train<MSELoss>(data.X, wrong, 1, bs, 0.05f);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Las vistas (transpuesta, rebanada, reshape) comparten el buffer y dan
+    // los mismos productos y operaciones que sus copias materializadas
+    void tensor_views() {
+        utec::algebra::Tensor<float,2> a(37, 23), b(37, 19);
+        fill_random(a, 21);
+        fill_random(b, 22);
+        const auto at = a.view().transpose_2d();
+        const utec::algebra::Tensor<float,2> at_copy(at);
+        CHECK(same_bits(at_copy, a.transpose_2d()));
+        CHECK(!at.is_contiguous() && at_copy.view().is_contiguous());
+        for (std::size_t i = 0; i < 23; ++i)
+            for (std::size_t j = 0; j < 37; ++j) CHECK(at(i, j) == a(j, i));
+
+        // Aᵀ·B y (A[5:30])ᵀ·B[5:30] sin copias, contra las copias contiguas
+        CHECK(same_bits(utec::algebra::matrix_product(at, b.view()),
+                        utec::algebra::matrix_product(at_copy, b)));
+        const auto as = a.view().slice(5, 25), bs = b.view().slice(5, 25);
+        CHECK(same_bits(utec::algebra::matrix_product(as.transpose_2d(), bs),
+                        utec::algebra::matrix_product(utec::algebra::Tensor<float,2>(as).transpose_2d(),
+                                                      utec::algebra::Tensor<float,2>(bs))));
+
+        // La rebanada escribe en el tensor original
+        auto rows = a.view().slice(3, 2);
+        rows(1, 4) = 42.f;
+        CHECK(a(4, 4) == 42.f);
+        CHECK(rows.data() == a.data() + 3 * 23);
+
+        const auto flat = a.view().reshape(std::array<std::size_t, 2>{23, 37});
+        CHECK(flat.data() == a.data() && flat(0, 23) == a(1, 0) && flat(1, 0) == a(1, 14));
+        bool threw = false;
+        try {
+            at.reshape(std::array<std::size_t, 2>{37, 23});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+
+        // elementwise_op sobre vistas: contiguas y con strides
+        utec::algebra::Tensor<float,2> c(23, 37);
+        fill_random(c, 23);
+        const auto sum = utec::algebra::elementwise_op(at, c.view(), std::plus<>());
+        for (std::size_t i = 0; i < 23; ++i)
+            for (std::size_t j = 0; j < 37; ++j) CHECK(sum(i, j) == a(j, i) + c(i, j));
+        const utec::algebra::Tensor<float,2> diff = c - c;
+        CHECK(same_bits(utec::algebra::elementwise_op(c.view(), c.view(), std::minus<>()), diff));
+    }
+
+    // elementwise_op con broadcasting en cualquier eje (y en ambos
+    // operandos) contra índices explícitos; también sobre una transpuesta
+    void elementwise_broadcast() {
+        using Shape3 = std::array<std::size_t, 3>;
+        const std::vector<Shape3> shapes = {
+            {4, 5, 7}, {1, 5, 7}, {4, 1, 7}, {4, 5, 1}, {1, 1, 7}, {1, 5, 1}, {4, 1, 1}, {1, 1, 1},
+        };
+        auto at = [](const utec::algebra::Tensor<double,3>& t, std::size_t i, std::size_t j, std::size_t k) {
+            const auto& s = t.shape();
+            return t(s[0] == 1 ? 0 : i, s[1] == 1 ? 0 : j, s[2] == 1 ? 0 : k);
+        };
+        unsigned seed = 50;
+        for (const auto& sa : shapes)
+            for (const auto& sb : shapes) {
+                utec::algebra::Tensor<double,3> a(sa), b(sb);
+                fill_random(a, seed++);
+                fill_random(b, seed++);
+                const utec::algebra::Tensor<double,3> sum = a + b, prod = a * b;
+                const auto mx = a.elementwise_op(b, [](double x, double y) { return x > y ? x : y; });
+                Shape3 rs;
+                for (std::size_t d = 0; d < 3; ++d) rs[d] = std::max(sa[d], sb[d]);
+                CHECK(sum.shape() == rs && mx.shape() == rs);
+                for (std::size_t i = 0; i < rs[0]; ++i)
+                    for (std::size_t j = 0; j < rs[1]; ++j)
+                        for (std::size_t k = 0; k < rs[2]; ++k) {
+                            const double x = at(a, i, j, k), y = at(b, i, j, k);
+                            CHECK(sum(i, j, k) == x + y && prod(i, j, k) == x * y);
+                            CHECK(mx(i, j, k) == (x > y ? x : y));
+                        }
+            }
+
+        // Bias de una fila sobre una transpuesta (strides no unitarios)
+        utec::algebra::Tensor<float,2> m(9, 6), bias(1, 9);
+        fill_random(m, 70);
+        fill_random(bias, 71);
+        const auto r = utec::algebra::elementwise_op(m.view().transpose_2d(), bias.view(), std::plus<>());
+        for (std::size_t i = 0; i < 6; ++i)
+            for (std::size_t j = 0; j < 9; ++j) CHECK(r(i, j) == m(j, i) + bias(0, j));
+
+        utec::algebra::Tensor<float,2> x(3, 4), y(2, 4);
+        bool threw = false;
+        try {
+            x + y;
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Cadenas de expresiones contra el cálculo elemento a elemento, con
+    // broadcasting, escalares, temporales y asignación sobre un operando
+    void expression_templates() {
+        using Tensor2 = utec::algebra::Tensor<float,2>;
+        Tensor2 a(13, 17), b(13, 17), row(1, 17);
+        fill_random(a, 80);
+        fill_random(b, 81);
+        fill_random(row, 82);
+        auto make = [&] { Tensor2 t(13, 17); fill_random(t, 83); return t; };
+        const Tensor2 m = make();
+
+        const Tensor2 r = a * 2.f + b - row / 4.f;
+        for (std::size_t i = 0; i < 13; ++i)
+            for (std::size_t j = 0; j < 17; ++j) CHECK(r(i, j) == a(i, j) * 2.f + b(i, j) - row(0, j) / 4.f);
+
+        // Un temporal queda dentro de la expresión: evaluarla más tarde es seguro
+        auto e = make() + b;
+        auto f = 2.f * make() - row * 0.5f;   // ningún operando es un Tensor con nombre
+        const Tensor2 er = e, fr = f;
+        for (std::size_t i = 0; i < 13; ++i)
+            for (std::size_t j = 0; j < 17; ++j) {
+                CHECK(er(i, j) == m(i, j) + b(i, j));
+                CHECK(fr(i, j) == 2.f * m(i, j) - row(0, j) * 0.5f);
+            }
+
+        // Asignación sobre un operando (in situ) y sobre un tensor movido
+        Tensor2 acc = a;
+        acc = acc + b * acc;
+        for (std::size_t i = 0; i < 13; ++i)
+            for (std::size_t j = 0; j < 17; ++j) CHECK(acc(i, j) == a(i, j) + b(i, j) * a(i, j));
+        Tensor2 moved = a;
+        moved = std::move(moved) + b;
+        for (std::size_t i = 0; i < 13; ++i)
+            for (std::size_t j = 0; j < 17; ++j) CHECK(moved(i, j) == a(i, j) + b(i, j));
+
+        // La asignación con otra forma redimensiona; formas incompatibles lanzan
+        Tensor2 small(2, 2);
+        small = row + a;
+        CHECK((small.shape() == std::array<std::size_t, 2>{13, 17}));
+        bool threw = false;
+        try {
+            Tensor2 bad = a + Tensor2(3, 17);
+            (void)bad;
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Tras el primer paso, train() no reserva tensores (también con el lote
+    // final más corto o con otro tamaño de lote), y las variantes *_into de
+    // las capas coinciden con forward/backward
+    void workspace_reuse() {
+        auto data = make_data(100, 8);
+        auto net = make_net(8, 16, 2);
+        net.train<MSELoss>(data.X, data.Y, 3, 16, 0.05f);
+        CHECK(net.last_step_allocations() == 0);
+        net.train<MSELoss>(data.X, data.Y, 2, 32, 0.05f);
+        CHECK(net.last_step_allocations() == 0);
+
+        const auto before = utec::algebra::allocation_stats();
+        { utec::algebra::Tensor<float,2> t(3, 5); }
+        const auto after = utec::algebra::allocation_stats();
+        CHECK(after.allocations == before.allocations + 1);
+        CHECK(after.deallocations == before.deallocations + 1);
+
+        auto init = [](utec::algebra::Tensor<float,2>& t) { fill_random(t, 90); };
+        std::vector<std::unique_ptr<ILayer<float>>> a, b;
+        for (auto* v : {&a, &b}) {
+            v->push_back(std::make_unique<Dense<float>>(8, 6, init, init));
+            v->push_back(std::make_unique<ReLU<float>>());
+            v->push_back(std::make_unique<Sigmoid<float>>());
+        }
+        utec::algebra::Tensor<float,2> x(5, 8), g(5, 6), y, dx;
+        fill_random(x, 91);
+        fill_random(g, 92);
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            const auto& in = i == 0 ? x : g;
+            const utec::algebra::Tensor<float,2> ref = a[i]->forward(in);
+            b[i]->forward_into(in, y);
+            CHECK(same_bits(ref, y));
+            const utec::algebra::Tensor<float,2> dref = a[i]->backward(g);
+            b[i]->backward_into(g, dx);
+            CHECK(same_bits(dref, dx));
+        }
+    }
+
+    // fuse_layers no cambia el resultado: entrenamiento y predicción bit a
+    // bit iguales; forward por valor y forward_into dan el mismo backward
+    void fused_dense_matches_unfused() {
+        auto data = make_data(200, 12);
+        auto ref = make_net(12, 24, 2);
+        auto net = make_net(12, 24, 2, true);
+        CHECK(same_bits(ref.predict(data.X), net.predict(data.X)));
+        ref.train<MSELoss>(data.X, data.Y, 3, 32, 0.05f);
+        net.train<MSELoss>(data.X, data.Y, 3, 32, 0.05f);
+        CHECK(same_bits(ref.predict(data.X), net.predict(data.X)));
+
+        auto init = [](utec::algebra::Tensor<float,2>& t) { fill_random(t, 95); };
+        DenseSigmoid<float> a(12, 7, init, init), b(12, 7, init, init);
+        Dense<float> d(12, 7, init, init);
+        Sigmoid<float> s;
+        utec::algebra::Tensor<float,2> g(9, 7), y, dx;
+        fill_random(g, 96);
+        const utec::algebra::Tensor<float,2> x(data.X.view().slice(0, 9));
+        const utec::algebra::Tensor<float,2> ya = a.forward(x);
+        b.forward_into(x, y);
+        CHECK(same_bits(ya, y));
+        CHECK(same_bits(ya, s.forward(d.forward(x))));
+        const utec::algebra::Tensor<float,2> dxa = a.backward(g);
+        b.backward_into(g, dx);
+        CHECK(same_bits(dxa, dx));
+        CHECK(same_bits(dxa, d.backward(s.backward(g))));
+    }
+
+    // infer() es const: varias hebras comparten la red y todas obtienen el
+    // resultado secuencial; inferir entre forward y backward no toca las cachés
+    void concurrent_inference() {
+        auto data = make_data(256, 64);
+        for (bool fuse : {false, true}) {
+            auto net = make_net(64, 96, 2, fuse);
+            net.train<MSELoss>(data.X, data.Y, 1, 64, 0.05f);
+            const auto& shared = net;
+            const auto ref = shared.infer(data.X);
+            CHECK(same_bits(ref, net.predict(data.X)));
+            std::vector<int> ok(6, 1);
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < ok.size(); ++t)
+                threads.emplace_back([&, t] {
+                    utec::algebra::Tensor<float,2> out, scratch;
+                    for (int k = 0; k < 20; ++k) {
+                        shared.infer_into(data.X, out, scratch);
+                        if (!same_bits(out, ref)) ok[t] = 0;
+                    }
+                });
+            for (auto& th : threads) th.join();
+            for (int v : ok) CHECK(v == 1);
+        }
+
+        auto init = [](utec::algebra::Tensor<float,2>& t) { fill_random(t, 97); };
+        Dense<float> a(8, 5, init, init), b(8, 5, init, init);
+        utec::algebra::Tensor<float,2> x(6, 8), other(3, 8), g(6, 5), y, dx;
+        fill_random(x, 98);
+        fill_random(other, 99);
+        fill_random(g, 100);
+        a.forward_into(x, y);
+        b.forward_into(x, y);
+        (void)b.infer(other);
+        const utec::algebra::Tensor<float,2> ref = a.backward(g);
+        b.backward_into(g, dx);
+        CHECK(same_bits(ref, dx));
+    }
+
+    // Las filas agrupadas por el motor dan lo mismo que infer() sobre todo
+    // X; una petición que falla llega al cliente y a run_synthetic_load
+    void batching_engine() {
+        auto data = make_data(96, 8);
+        auto net = make_net(8, 16, 1, true);
+        const auto ref = net.infer(data.X);
+        {
+            BatchingEngine<float> engine(net, 8, {16, std::chrono::microseconds(500)});
+            std::vector<std::future<std::vector<float>>> results(96);
+            std::vector<std::thread> clients;
+            for (std::size_t c = 0; c < 4; ++c)
+                clients.emplace_back([&, c] {
+                    for (std::size_t r = c; r < 96; r += 4)
+                        results[r] = engine.submit(std::vector<float>(data.X.data() + r * 8,
+                                                                      data.X.data() + (r + 1) * 8));
+                });
+            for (auto& t : clients) t.join();
+            for (std::size_t r = 0; r < 96; ++r) {
+                const auto y = results[r].get();
+                CHECK(y.size() == 1 && y[0] == ref(r, 0));
+            }
+            const auto st = engine.stats();
+            CHECK(st.requests == 96 && st.batches >= 6);
+            std::size_t batches = 0, rows = 0;
+            for (std::size_t k = 0; k < st.batch_size_histogram.size(); ++k) {
+                batches += st.batch_size_histogram[k];
+                rows += k * st.batch_size_histogram[k];
+            }
+            CHECK(batches == st.batches && rows == 96);
+
+            const auto rep = run_synthetic_load(engine, 8, 3, 10);
+            CHECK(rep.failed == 0 && rep.stats.requests == 30);
+        }
+
+        // Motor declarado con 5 columnas para una red de 8: infer_into lanza
+        BatchingEngine<float> wrong(net, 5);
+        bool threw = false;
+        try {
+            wrong.submit(std::vector<float>(5, 0.f)).get();
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+        const auto rep = run_synthetic_load(wrong, 5, 2, 3, std::chrono::microseconds(0), 42, false);
+        CHECK(rep.failed == 6 && rep.first_error);
+        threw = false;
+        try {
+            run_synthetic_load(wrong, 5, 2, 3);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Capa sin parámetros que cuenta sus update_params
+    struct CountingIdentity final : ILayer<float> {
+        int updates = 0;
+        utec::algebra::Tensor<float,2> forward(const utec::algebra::Tensor<float,2>& x) override { return x; }
+        utec::algebra::Tensor<float,2> backward(const utec::algebra::Tensor<float,2>& g) override { return g; }
+        void infer_into(const utec::algebra::Tensor<float,2>& x, utec::algebra::Tensor<float,2>& y) const override {
+            y = x;
+        }
+        void update_params(IOptimizer<float>&) override { ++updates; }
+    };
+
+    // step() sobre un buffer plano equivale a update() tensor a tensor (con
+    // estado de Adam propio por tensor y formas distintas), con y sin pool;
+    // la red coloca sus parámetros en una arena alineada y sigue llamando a
+    // update_params de las capas sin parámetros
+    void flat_optimizer_step() {
+        const std::size_t sizes[3][2] = {{37, 5}, {1, 5}, {300, 200}};
+        std::vector<utec::algebra::Tensor<float,2>> values, grads;
+        std::size_t total = 0;
+        for (auto& sz : sizes) {
+            values.emplace_back(sz[0], sz[1]);
+            grads.emplace_back(sz[0], sz[1]);
+            fill_random(values.back(), unsigned(110 + total));
+            fill_random(grads.back(), unsigned(111 + total));
+            total += sz[0] * sz[1];
+        }
+        for (int kind = 0; kind < 2; ++kind) {
+            std::vector<float> flat, flat_grads;
+            for (std::size_t k = 0; k < 3; ++k) {
+                flat.insert(flat.end(), values[k].begin(), values[k].end());
+                flat_grads.insert(flat_grads.end(), grads[k].begin(), grads[k].end());
+            }
+            auto per_tensor = values;
+            std::vector<float> serial = flat;
+            SGD<float> sgd_a(0.1f), sgd_b(0.1f), sgd_c(0.1f);
+            Adam<float> adam_a(0.01f), adam_b(0.01f), adam_c(0.01f);
+            IOptimizer<float>& a = kind ? static_cast<IOptimizer<float>&>(adam_a) : sgd_a;
+            IOptimizer<float>& b = kind ? static_cast<IOptimizer<float>&>(adam_b) : sgd_b;
+            sgd_c.set_parallel(false);
+            adam_c.set_parallel(false);
+            IOptimizer<float>& c = kind ? static_cast<IOptimizer<float>&>(adam_c) : sgd_c;
+            for (int step = 0; step < 3; ++step) {
+                a.step(flat.data(), flat_grads.data(), total);
+                c.step(serial.data(), flat_grads.data(), total);
+                for (std::size_t k = 0; k < 3; ++k) b.update(per_tensor[k], grads[k]);
+            }
+            CHECK(flat == serial);
+            std::size_t off = 0;
+            for (std::size_t k = 0; k < 3; ++k) {
+                CHECK(std::memcmp(flat.data() + off, per_tensor[k].data(), per_tensor[k].size() * sizeof(float)) == 0);
+                off += per_tensor[k].size();
+            }
+        }
+
+        auto data = make_data(64, 8);
+        auto net = make_net(8, 16, 1, true);
+        net.train<MSELoss, Adam>(data.X, data.Y, 2, 16, 1e-3f);
+        CHECK(net.last_step_allocations() == 0);
+        const auto& params = net.parameters();
+        CHECK(params.size() == 6);
+        for (std::size_t i = 0; i + 1 < params.size(); ++i) {
+            const std::size_t padded = (params[i]->size() + 15) / 16 * 16;
+            CHECK(params[i + 1]->value().data() == params[i]->value().data() + padded);
+        }
+        for (auto* p : params) CHECK(reinterpret_cast<std::uintptr_t>(p->value().data()) % 64 == 0);
+
+        auto counter = std::make_unique<CountingIdentity>();
+        auto* count = counter.get();
+        net.add_layer(std::move(counter));
+        net.train<MSELoss, Adam>(data.X, data.Y, 2, 16, 1e-3f);
+        CHECK(count->updates == 8);
+    }
+
+    // Kernels vectorizados de activación frente a las fórmulas escalares de
+    // libm en longitudes impares (cola incluida); en modo accurate sigmoid y
+    // tanh coinciden bit a bit con apply
+    void activation_kernels() {
+        using utec::algebra::MathMode;
+        using utec::algebra::vmath_config;
+        const MathMode saved = vmath_config().mode;
+        for (std::size_t n : {1u, 7u, 33u, 1001u}) {
+            utec::algebra::Tensor<float,2> z(1, n), g(1, n), y, dx;
+            fill_random(z, unsigned(120 + n));
+            fill_random(g, unsigned(121 + n));
+            for (auto& v : z) v *= 8.f;
+            for (MathMode mode : {MathMode::fast, MathMode::accurate}) {
+                vmath_config().mode = mode;
+                auto check = [&](auto& layer, auto f, auto df) {
+                    layer.forward_into(z, y);
+                    layer.backward_into(g, dx);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        CHECK(std::abs(y(0, i) - f(z(0, i))) <= 1e-5f * (1 + std::abs(f(z(0, i)))));
+                        CHECK(std::abs(dx(0, i) - g(0, i) * df(z(0, i))) <= 1e-5f);
+                    }
+                };
+                ReLU<float> relu;
+                check(relu, [](float v) { return v > 0 ? v : 0.f; },
+                      [](float v) { return v > 0 ? 1.f : 0.f; });
+                Sigmoid<float> sigmoid;
+                auto sig = [](float v) { return 1.f / (1.f + std::exp(-v)); };
+                check(sigmoid, sig, [&](float v) { return sig(v) * (1.f - sig(v)); });
+                Tanh<float> tanh_layer;
+                check(tanh_layer, [](float v) { return std::tanh(v); },
+                      [](float v) { return 1.f - std::tanh(v) * std::tanh(v); });
+                LeakyReLU<float> leaky(0.1f);
+                check(leaky, [](float v) { return v > 0 ? v : 0.1f * v; },
+                      [](float v) { return v > 0 ? 1.f : 0.1f; });
+                if (mode == MathMode::accurate) {
+                    sigmoid.forward_into(z, y);
+                    for (std::size_t i = 0; i < n; ++i) CHECK(y(0, i) == SigmoidOp<float>::apply(z(0, i)));
+                    tanh_layer.forward_into(z, y);
+                    for (std::size_t i = 0; i < n; ++i) CHECK(y(0, i) == std::tanh(z(0, i)));
+                }
+                GELU<float> gelu;
+                auto gelu_f = [](double v) {
+                    return 0.5 * v * (1 + std::tanh(0.7978845608028654 * (v + 0.044715 * v * v * v)));
+                };
+                check(gelu, [&](float v) { return float(gelu_f(v)); },
+                      [&](float v) { return float((gelu_f(v + 1e-3) - gelu_f(v - 1e-3)) / 2e-3); });
+            }
+        }
+        vmath_config().mode = saved;
+
+        // Dense + Tanh fusionada da lo mismo que las capas sueltas
+        auto init = [](utec::algebra::Tensor<float,2>& w) { fill_random(w, 122); };
+        DenseTanh<float> fused(12, 7, init, init);
+        Dense<float> d(12, 7, init, init);
+        Tanh<float> th;
+        utec::algebra::Tensor<float,2> x(9, 12), gy(9, 7);
+        fill_random(x, 123);
+        fill_random(gy, 124);
+        CHECK(same_bits(fused.forward(x), th.forward(d.forward(x))));
+        CHECK(same_bits(fused.backward(gy), d.backward(th.backward(gy))));
+    }
+
+    // BCEWithLogits equivale a Sigmoid + BCE (valor y gradiente encadenado)
+    // sin recorte en logits grandes; las pérdidas aceptan vistas de filas,
+    // rechazan formas distintas y loss_and_gradient_into coincide con
+    // loss() + loss_gradient()
+    void fused_losses() {
+        using utec::algebra::MathMode;
+        using utec::algebra::vmath_config;
+        const MathMode saved = vmath_config().mode;
+        utec::algebra::Tensor<double,2> z(13, 7), y(13, 7);
+        fill_random(z, 130);
+        fill_random(y, 131);
+        for (auto& v : z) v *= 6;
+        for (auto& v : y) v = v > 0 ? 1 : 0;
+        utec::algebra::Tensor<double,2> p(z.shape());
+        for (std::size_t i = 0; i < z.size(); ++i) p.data()[i] = SigmoidOp<double>::apply(z.data()[i]);
+        for (MathMode mode : {MathMode::fast, MathMode::accurate}) {
+            vmath_config().mode = mode;
+            BCEWithLogitsLoss<double> logits(z, y);
+            BCELoss<double> bce(p, y);
+            utec::algebra::Tensor<double,2> gz, gp;
+            const double l = logits.loss_and_gradient_into(gz);
+            CHECK(l == logits.loss());
+            CHECK(same_bits(gz, logits.loss_gradient()));
+            CHECK(std::abs(l - bce.loss()) < 1e-9);
+            bce.loss_gradient_into(gp);
+            for (std::size_t i = 0; i < z.size(); ++i) {
+                const double s = p.data()[i];
+                CHECK(std::abs(gz.data()[i] - gp.data()[i] * s * (1 - s)) < 1e-9);
+            }
+
+            // Logit extremo: BCE sobre la sigmoide satura, la forma estable no
+            utec::algebra::Tensor<float,2> big(1, 1), one(1, 1);
+            big(0, 0) = -100.f;
+            one(0, 0) = 1.f;
+            CHECK(std::abs(BCEWithLogitsLoss<float>(big, one).loss() - 100.f) < 1e-4f);
+
+            MSELoss<double> mse(p, y);
+            double ref = 0;
+            for (std::size_t i = 0; i < p.size(); ++i)
+                ref += (p.data()[i] - y.data()[i]) * (p.data()[i] - y.data()[i]);
+            CHECK(std::abs(mse.loss() - ref / double(p.size())) < 1e-12);
+        }
+        vmath_config().mode = saved;
+
+        const utec::algebra::Tensor<double,2> p_rows(p.view().slice(3, 9)), y_rows(y.view().slice(3, 9));
+        CHECK(MSELoss<double>(p.view().slice(3, 9), y.view().slice(3, 9)).loss() ==
+              MSELoss<double>(p_rows, y_rows).loss());
+        bool threw = false;
+        try {
+            MSELoss<double>(p.view().slice(0, 4), y.view().slice(0, 5));
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+
+        auto data = make_data(50, 8);
+        auto net = make_net(8, 16, 1);
+        const auto pred = net.predict(data.X);
+        CHECK(net.evaluate<MSELoss>(data.X, data.Y) == MSELoss<float>(pred, data.Y).loss());
+    }
+
+    // qgemm coincide exactamente con el producto entero en formas impares;
+    // quantize() reduce ~4x los parámetros y queda cerca de la red flotante
+    void quantized_inference() {
+        for (const auto& s : odd_shapes) {
+            const std::size_t M = s[0], K = s[1], N = s[2];
+            std::mt19937 rng(unsigned(140 + M * K));
+            std::uniform_int_distribution<int> dist(-127, 127);
+            std::vector<float> a(M * K);
+            std::vector<std::int8_t> b(K * N);
+            for (auto& v : a) v = float(dist(rng));
+            for (auto& v : b) v = std::int8_t(dist(rng));
+            // Con inv_scale 1 y enteros en [-127, 127] la cuantización de A es exacta
+            std::vector<std::int16_t> ap(utec::algebra::detail::qgemm_packed_a_size(M, K));
+            utec::algebra::quantize_pack_a(M, K, a.data(), K, 1.f, ap.data());
+            const auto bp = utec::algebra::qgemm_pack_b(K, N, b.data(), N);
+            std::vector<float> c(M * N, -1.f);
+            utec::algebra::qgemm(M, N, K, ap.data(), bp.data(), c.data(), N,
+                                 [](std::size_t, std::size_t, const std::int32_t* acc, float* out, std::size_t n) {
+                                     for (std::size_t j = 0; j < n; ++j) out[j] = float(acc[j]);
+                                 });
+            for (std::size_t i = 0; i < M; ++i)
+                for (std::size_t j = 0; j < N; ++j) {
+                    std::int32_t ref = 0;
+                    for (std::size_t k = 0; k < K; ++k) ref += std::int32_t(a[i * K + k]) * b[k * N + j];
+                    CHECK(c[i * N + j] == float(ref));
+                }
+        }
+
+        auto data = make_data(300, 64);
+        auto net = make_net(64, 128, 2, true);
+        net.train<MSELoss>(data.X, data.Y, 2, 32, 0.05f);
+        const auto q = quantize(net, data.X);
+        const auto report = compare_quantized(net, q, data.X);
+        CHECK(report.relative_rmse < 0.05);
+        CHECK(report.quantized_bytes * 3 < report.reference_bytes);
+        CHECK(report.argmax_agreement == 1);   // una sola salida
+    }
+
+    // save_model / load_model en los dos modos reproducen la red bit a bit;
+    // un archivo corrupto se rechaza
+    void save_load_round_trip() {
+        auto data = make_data(64, 16);
+        auto net = make_net(16, 32, 2, true);
+        net.train<MSELoss>(data.X, data.Y, 1, 16, 0.01f);
+        const auto path = (std::filesystem::temp_directory_path() / "utec_neural_net_test.bin").string();
+        save_model(net, path);
+        const auto ref = net.infer(data.X);
+        {
+            auto mapped = load_model<float>(path);
+            auto copied = load_model<float>(path, LoadMode::copy);
+            CHECK(same_bits(ref, mapped.infer(data.X)));
+            CHECK(same_bits(ref, copied.infer(data.X)));
+            // Entrenar el modelo mapeado no modifica el archivo
+            mapped.train<MSELoss>(data.X, data.Y, 1, 16, 0.01f);
+        }
+        CHECK(same_bits(ref, load_model<float>(path).infer(data.X)));
+
+        bool threw = false;
+        try {
+            load_model<double>(path);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        CHECK(threw);
+        {
+            std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(80);
+            const char junk = 7;
+            f.write(&junk, 1);
+        }
+        threw = false;
+        try {
+            load_model<float>(path);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        std::filesystem::remove(path);
+        CHECK(threw);
+    }
+
+    // StreamingDataset entrega cada fila una vez por época, con lotes que no
+    // dependen del número de hebras; import_csv conserva los valores y el
+    // entrenamiento desde la fuente no reserva en régimen estable
+    void streaming_dataset() {
+        const auto dir = std::filesystem::temp_directory_path();
+        const auto path = (dir / "utec_stream_test.bin").string();
+        auto data = make_data(203, 5);
+        for (std::size_t i = 0; i < 203; ++i) data.X(i, 0) = float(i);   // identificador de fila
+        write_dataset(path, data.X, data.Y);
+
+        std::vector<std::vector<float>> first_run;
+        for (std::size_t workers : {1u, 3u}) {
+            StreamOptions opt;
+            opt.batch_size = 16;
+            opt.block_rows = 7;
+            opt.window_blocks = 3;
+            opt.prefetch = 2;
+            opt.workers = workers;
+            StreamingDataset<float> ds(path, opt);
+            CHECK(ds.rows() == 203 && ds.features() == 5 && ds.targets() == 1);
+            for (int epoch = 0; epoch < 2; ++epoch) {
+                ds.begin_epoch();
+                std::vector<int> seen(203, 0);
+                std::vector<float> ids;
+                while (const auto* b = ds.next()) {
+                    for (std::size_t r = 0; r < b->X.shape()[0]; ++r) {
+                        const auto id = std::size_t(b->X(r, 0));
+                        ++seen[id];
+                        ids.push_back(b->X(r, 0));
+                        CHECK(b->Y(r, 0) == data.Y(id, 0) && b->X(r, 4) == data.X(id, 4));
+                    }
+                }
+                CHECK(std::all_of(seen.begin(), seen.end(), [](int c) { return c == 1; }));
+                if (workers == 1) first_run.push_back(ids);
+                else CHECK(ids == first_run[epoch]);
+            }
+            CHECK(ds.stats().batches == 2 * ds.batches_per_epoch());
+        }
+
+        // Entrenar desde la fuente baja la pérdida sin reservar por lote
+        auto train_data = make_data(256, 5);
+        write_dataset(path, train_data.X, train_data.Y);
+        StreamOptions opt;
+        opt.batch_size = 32;
+        opt.workers = 2;
+        StreamingDataset<float> source(path, opt);
+        auto net = make_net(5, 16, 1);
+        const float before = net.evaluate<MSELoss>(train_data.X, train_data.Y);
+        net.train<MSELoss, Adam>(source, 5, 1e-2f);
+        CHECK(net.evaluate<MSELoss>(train_data.X, train_data.Y) < before);
+        CHECK(net.last_step_allocations() == 0);
+
+        const auto csv = (dir / "utec_stream_test.csv").string();
+        {
+            std::ofstream f(csv, std::ios::binary);
+            f << "a,b,c\r\n";
+            for (std::size_t i = 0; i < 203; ++i)
+                f << data.X(i, 1) << ", " << data.X(i, 2) << ',' << data.Y(i, 0) << "\r\n";
+        }
+        const auto imported_path = (dir / "utec_stream_csv.bin").string();
+        CsvOptions csv_opt;
+        CHECK(import_csv<float>(csv, imported_path, csv_opt) == 203);
+        StreamOptions in_order;
+        in_order.shuffle = false;
+        in_order.batch_size = 64;
+        StreamingDataset<float> imported(imported_path, in_order);
+        CHECK(imported.features() == 2 && imported.targets() == 1);
+        imported.begin_epoch();
+        std::size_t row = 0;
+        while (const auto* b = imported.next())
+            for (std::size_t r = 0; r < b->X.shape()[0]; ++r, ++row)
+                CHECK(std::abs(b->X(r, 1) - data.X(row, 2)) <= 1e-5f * (1 + std::abs(data.X(row, 2))));
+        CHECK(row == 203);
+        {
+            std::ofstream f(csv, std::ios::binary | std::ios::app);
+            f << "1,2\n";
+        }
+        bool threw = false;
+        try {
+            import_csv<float>(csv, (dir / "utec_stream_bad.bin").string(), csv_opt);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        std::filesystem::remove(csv);
+        std::filesystem::remove(imported_path);
+        std::filesystem::remove(path);
+    }
+
+    // Pérdida que siempre falla: prueba el relanzamiento desde las réplicas
+    template<typename T>
+    struct FailingLoss final : ILoss<T,2> {
+        FailingLoss(utec::algebra::TensorView<const T,2>, utec::algebra::TensorView<const T,2>) {
+            throw std::runtime_error("loss failed");
+        }
+        T loss() const override { return T(0); }
+        utec::algebra::Tensor<T,2> loss_gradient() const override { return {}; }
+    };
+
+    // Una réplica reproduce train() bit a bit; con cuatro el resultado no
+    // depende de las hebras del pool. Los errores de forma y los de una
+    // réplica llegan al llamador y el entrenador sigue usable
+    void data_parallel_matches_serial() {
+        auto data = make_data(1024, 16);
+        auto ref = make_net(16, 32, 2, true);
+        ref.train<MSELoss>(data.X, data.Y, 2, 128, 0.01f);
+        auto net = make_net(16, 32, 2, true);
+        DataParallelTrainer<float> single(net, 1);
+        single.train<MSELoss>(data.X, data.Y, 2, 128, 0.01f);
+        CHECK(ref.last_loss() == single.last_loss());
+        CHECK(same_bits(ref.infer(data.X), net.infer(data.X)));
+
+        const std::size_t threads = utec::algebra::num_threads();
+        utec::algebra::Tensor<float,2> out[2];
+        for (std::size_t k = 0; k < 2; ++k) {
+            utec::algebra::set_num_threads(k == 0 ? 1 : 3);
+            auto n4 = make_net(16, 32, 2, true);
+            DataParallelTrainer<float> tr(n4, 4);
+            tr.train<MSELoss, Adam>(data.X, data.Y, 2, 100, 1e-3f);
+            out[k] = n4.infer(data.X);
+        }
+        utec::algebra::set_num_threads(threads);
+        CHECK(same_bits(out[0], out[1]));
+
+        auto expect_throw = [](auto&& fn) {
+            try {
+                fn();
+            } catch (const std::invalid_argument&) {
+                return true;
+            }
+            return false;
+        };
+        const utec::algebra::Tensor<float,2> wrong_y(1024, 3), wrong_x(1024, 5);
+        CHECK(expect_throw([&] { single.train<MSELoss>(data.X, wrong_y, 1, 128, 0.01f); }));
+        CHECK(expect_throw([&] { single.train<MSELoss>(wrong_x, data.Y, 1, 128, 0.01f); }));
+
+        auto n4 = make_net(16, 32, 2, true);
+        DataParallelTrainer<float> tr(n4, 4);
+        bool threw = false;
+        try {
+            tr.train<FailingLoss>(data.X, data.Y, 1, 128, 0.01f);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        tr.train<MSELoss>(data.X, data.Y, 1, 128, 0.01f);
+        CHECK(std::isfinite(tr.last_loss()));
+    }
+
+    // El perfilador no cambia el entrenamiento; con UTEC_PROFILE (opción
+    // UTEC_PROFILING) registra cada capa y fase por época con los FLOPs que
+    // declara la capa, y sin él queda vacío
+    void layer_profiler() {
+        auto data = make_data(96, 8);
+        auto net = make_net(8, 16, 1, true);
+        auto plain = make_net(8, 16, 1, true);
+        plain.train<MSELoss>(data.X, data.Y, 2, 32, 0.05f);
+        net.train<MSELoss>(data.X, data.Y, 2, 32, 0.05f);
+        CHECK(same_bits(plain.predict(data.X), net.predict(data.X)));
+
+        const auto& prof = net.profiler();
+        std::ostringstream trace;
+        prof.write_chrome_trace(trace);
+        CHECK(trace.str().find("\"traceEvents\":[") != std::string::npos);
+        if constexpr (Profiler::enabled) {
+            CHECK(prof.epochs().size() == 2);
+            // DenseReLU, DenseSigmoid, Dense: forward y backward por capa
+            for (const auto& ep : prof.epochs()) {
+                std::size_t forward = 0, backward = 0;
+                for (const auto& e : ep.entries) {
+                    if (e.phase == Phase::forward) ++forward;
+                    if (e.phase == Phase::backward) ++backward;
+                    if (e.layer == 2 && e.phase == Phase::forward) {
+                        CHECK(e.name == "Dense" && e.calls == 3);
+                        CHECK(e.flops == 3 * (2.0 * 32 * 16 * 1 + 32));   // GEMM + bias
+                    }
+                }
+                CHECK(forward == 3 && backward == 3);
+            }
+            CHECK(!prof.inference().empty());
+            CHECK(trace.str().find("DenseSigmoid") != std::string::npos);
+        } else {
+            CHECK(prof.epochs().empty() && prof.inference().empty() && prof.totals().empty());
+        }
+    }
+
+    // StaticNetwork con la misma arquitectura, pesos y barajado que
+    // NeuralNetwork da las mismas predicciones y pérdidas salvo redondeo
+    void static_matches_dynamic() {
+        using Net = StaticNetwork<float, StaticDense<float, 8, 16, ReLUOp<float>>,
+                                  StaticDense<float, 16, 16, SigmoidOp<float>>, StaticDense<float, 16, 1>>;
+        std::mt19937 init_rng(7);
+        auto init_w = [&](utec::algebra::Tensor<float,2>& w) {
+            std::normal_distribution<float> dist(0.f, 0.1f);
+            for (auto& v : w) v = dist(init_rng);
+        };
+        auto init_b = [](utec::algebra::Tensor<float,2>& b) { b.fill(0.01f); };
+        auto data = make_data(100, 8);
+        for (int kind = 0; kind < 2; ++kind) {
+            init_rng.seed(7);
+            Net sn(init_w, init_b);
+            auto net = make_net(8, 16, 1);
+            CHECK(close_to(sn.predict(data.X), net.predict(data.X)));
+            net.set_seed(11);
+            std::mt19937 rng(11);
+            float loss = 0;
+            if (kind == 0) {
+                loss = sn.train<MSELoss>(data.X, data.Y, 3, 16, 0.05f, rng);
+                net.train<MSELoss>(data.X, data.Y, 3, 16, 0.05f);
+            } else {
+                loss = sn.train<MSELoss, Adam>(data.X, data.Y, 3, 16, 1e-2f, rng);
+                net.train<MSELoss, Adam>(data.X, data.Y, 3, 16, 1e-2f);
+            }
+            CHECK(std::abs(loss - net.last_loss()) <= 1e-4f * (1 + net.last_loss()));
+            CHECK(close_to(sn.predict(data.X), net.predict(data.X), 1e-4f));
+            CHECK(sn.evaluate<MSELoss>(data.X, data.Y) > 0);
+        }
+
+        const Net::input_type x{0.5f, -1.f, 0.f, 2.f, 1.f, -0.25f, 0.f, 3.f};
+        Net sn(init_w, init_b);
+        utec::algebra::Tensor<float,2> row(1, 8);
+        std::copy(x.begin(), x.end(), row.data());
+        CHECK(std::abs(sn.predict(x)[0] - sn.predict(row)(0, 0)) <= 1e-6f);
+        bool threw = false;
+        try {
+            sn.predict(utec::algebra::Tensor<float,2>(3, 5));
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Entrada CSR muy dispersa: predicción y entrenamiento (con y sin capas
+    // fusionadas, SGD y Adam) coinciden con la ruta densa salvo redondeo;
+    // spmm_into coincide con matrix_product en formas impares
+    void sparse_matches_dense() {
+        for (const auto& s : odd_shapes) {
+            utec::algebra::Tensor<float,2> a(s[0], s[1]), b(s[1], s[2]);
+            fill_random(a, unsigned(150 + s[1]));
+            fill_random(b, unsigned(151 + s[1]));
+            for (auto& v : a) if (std::abs(v) < 0.8f) v = 0.f;
+            const auto csr = utec::algebra::CsrMatrix<float>::from_dense(a);
+            utec::algebra::Tensor<float,2> c;
+            utec::algebra::spmm_into(csr, b.view(), c);
+            CHECK(matches_naive(a.data(), b.data(), c.data(), s[0], s[1], s[2]));
+            // aᵀ·g acumulado sobre ceros
+            utec::algebra::Tensor<float,2> g(s[0], s[2]), acc(s[1], s[2]);
+            fill_random(g, unsigned(152 + s[1]));
+            acc.fill(0.f);
+            utec::algebra::spmm_tn_accumulate(csr, g.view(), acc.data());
+            const utec::algebra::Tensor<float,2> at = a.transpose_2d();
+            CHECK(matches_naive(at.data(), g.data(), acc.data(), s[1], s[0], s[2]));
+        }
+
+        utec::algebra::Tensor<float,2> X(200, 300), Y(200, 1);
+        std::mt19937 rng(4);
+        std::uniform_int_distribution<std::size_t> col(0, 299);
+        X.fill(0.f);
+        for (std::size_t i = 0; i < 200; ++i) {
+            float s = 0;
+            for (int k = 0; k < 5; ++k) {
+                const std::size_t j = col(rng);
+                X(i, j) = 1.f;
+                s += j % 2 ? 0.3f : -0.2f;
+            }
+            Y(i, 0) = std::tanh(s);
+        }
+        const auto sparse = utec::algebra::CsrMatrix<float>::from_dense(X);
+        for (bool fuse : {false, true}) {
+            auto dense_net = make_net(300, 16, 1, fuse);
+            auto sparse_net = make_net(300, 16, 1, fuse);
+            CHECK(close_to(dense_net.predict(X), sparse_net.predict(sparse)));
+            dense_net.train<MSELoss>(X, Y, 2, 32, 0.05f);
+            sparse_net.train<MSELoss>(sparse, Y, 2, 32, 0.05f);
+            dense_net.train<MSELoss, Adam>(X, Y, 2, 32, 1e-3f);
+            sparse_net.train<MSELoss, Adam>(sparse, Y, 2, 32, 1e-3f);
+            CHECK(std::abs(dense_net.last_loss() - sparse_net.last_loss()) <= 1e-5f);
+            CHECK(close_to(dense_net.infer(X), sparse_net.infer(sparse), 1e-4f));
+            CHECK(std::abs(sparse_net.evaluate<MSELoss>(sparse, Y) - sparse_net.evaluate<MSELoss>(X, Y)) <= 1e-6f);
+        }
+    }
+
+    // El checkpointing (por número de capas o por presupuesto de bytes)
+    // recalcula activaciones sin cambiar los resultados y baja el pico de
+    // bytes de activación; las capas fusionadas leen su salida recalculada
+    void checkpointing_matches_normal() {
+        auto data = make_data(512, 16);
+        for (bool fuse : {false, true}) {
+            auto ref = make_net(16, 32, 6, fuse);
+            ref.train<MSELoss, Adam>(data.X, data.Y, 2, 64, 1e-3f);
+            for (std::size_t every : {1u, 3u, 0u}) {
+                auto net = make_net(16, 32, 6, fuse);
+                if (every) net.set_checkpointing(every);
+                else net.set_checkpoint_budget(ref.peak_activation_bytes() / 2);
+                net.train<MSELoss, Adam>(data.X, data.Y, 2, 64, 1e-3f);
+                CHECK(ref.last_loss() == net.last_loss());
+                CHECK(same_bits(ref.infer(data.X), net.infer(data.X)));
+                if (every != 1) CHECK(net.peak_activation_bytes() < ref.peak_activation_bytes());
+            }
+        }
+    }
+
+    // compile() ejecuta el plan estático: pérdidas y pesos coinciden bit a
+    // bit con la ruta normal, con y sin fuse_layers, y el primer paso ya no
+    // reserva. Un lote mayor que el del plan se rechaza en lugar de hacer
+    // crecer sus buffers; predict lo recorre en bloques
+    void compiled_matches_uncompiled() {
+        auto data = make_data(512, 16);
+        for (bool fuse : {false, true}) {
+            auto ref = make_net(16, 32, 3, fuse);
+            auto net = make_net(16, 32, 3, fuse);
+            net.compile(16, 64);
+            CHECK(net.compiled());
+            ref.train<MSELoss, Adam>(data.X, data.Y, 2, 64, 1e-3f);
+            net.train<MSELoss, Adam>(data.X, data.Y, 2, 64, 1e-3f);
+            CHECK(ref.last_loss() == net.last_loss());
+            CHECK(same_bits(ref.infer(data.X), net.infer(data.X)));
+            CHECK(same_bits(net.infer(data.X), net.predict(data.X)));
+            CHECK(net.last_step_allocations() == 0);
+
+            auto fresh = make_net(16, 32, 3, fuse);
+            fresh.compile(16, 64);
+            fresh.train<MSELoss>(data.X, data.Y, 1, 64, 0.01f);
+            CHECK(fresh.last_step_allocations() == 0);
+            const auto before = fresh.infer(data.X);
+            bool threw = false;
+            try {
+                fresh.train<MSELoss>(data.X, data.Y, 1, 128, 0.01f);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            CHECK(threw);
+            CHECK(same_bits(before, fresh.infer(data.X)));
+            const auto planned_bytes = fresh.plan().elements() * sizeof(float);
+            fresh.train<MSELoss>(data.X, data.Y, 1, 32, 0.01f);
+            CHECK(fresh.peak_activation_bytes() <= planned_bytes);
+        }
+    }
+
+    // Una etapa y un micro-batch equivalen al entrenamiento secuencial; con
+    // varias etapas el resultado es el mismo salvo redondeo, también con
+    // capas fusionadas (que releen su salida en backward)
+    void pipeline_matches_serial() {
+        auto data = make_data(256, 16);
+        for (bool fuse : {false, true}) {
+            auto ref = make_net(16, 32, 3, fuse);
+            ref.train<MSELoss, Adam>(data.X, data.Y, 3, 64, 1e-3f);
+            auto net = make_net(16, 32, 3, fuse);
+            PipelineParallelTrainer<float> single(net, 1, 1);
+            single.train<MSELoss, Adam>(data.X, data.Y, 3, 64, 1e-3f);
+            CHECK(ref.last_loss() == single.last_loss());
+            CHECK(same_bits(ref.infer(data.X), net.infer(data.X)));
+
+            auto staged = make_net(16, 32, 3, fuse);
+            PipelineParallelTrainer<float> tr(staged, 3, 4);
+            tr.train<MSELoss, Adam>(data.X, data.Y, 3, 64, 1e-3f);
+            CHECK(std::abs(tr.last_loss() - ref.last_loss()) <= 1e-4f * (1 + std::abs(ref.last_loss())));
+            CHECK(tr.stage_stats().size() == 3);
+        }
+    }
+
+    // Reducciones por eje contra bucles simples, también sobre transpuestas
+    void axis_reductions() {
+        utec::algebra::Tensor<float,2> x(37, 53);
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> dist(-8, 8);
+        for (auto& v : x) v = static_cast<float>(dist(rng));   // con empates
+        for (bool transposed : {false, true}) {
+            utec::algebra::TensorView<const float,2> v = x.view();
+            if (transposed) v = v.transpose_2d();
+            for (std::size_t axis : {0u, 1u}) {
+                auto sum = utec::algebra::sum_axis<float>(v, axis);
+                auto arg = utec::algebra::argmax_axis<float>(v, axis);
+                const std::size_t kept = v.shape()[1 - axis], n = v.shape()[axis];
+                CHECK(sum.size() == kept && arg.size() == kept);
+                for (std::size_t k = 0; k < kept; ++k) {
+                    float s = 0, best = 0;
+                    std::size_t best_i = 0;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        const float e = axis == 0 ? v(i, k) : v(k, i);
+                        s += e;
+                        if (i == 0 || e > best) { best = e; best_i = i; }
+                    }
+                    CHECK(sum.data()[k] == s);   // enteros pequeños: suma exacta
+                    CHECK(arg[k] == best_i);
+                }
+            }
+        }
+    }
+
+    // Gradientes de parámetros y de la entrada contra diferencias centrales,
+    // en double, con Dense, activación suelta, FusedDense y softmax + CE
+    void gradient_check() {
+        std::mt19937 rng(3);
+        std::normal_distribution<double> dist(0.0, 0.5);
+        auto init = [&](utec::algebra::Tensor<double,2>& t) { for (auto& v : t) v = dist(rng); };
+        std::vector<std::unique_ptr<ILayer<double>>> layers;
+        layers.push_back(std::make_unique<Dense<double>>(4, 6, init, init));
+        layers.push_back(std::make_unique<Tanh<double>>());
+        layers.push_back(std::make_unique<DenseSigmoid<double>>(6, 5, init, init));
+        layers.push_back(std::make_unique<Dense<double>>(5, 3, init, init));
+
+        utec::algebra::Tensor<double,2> X(8, 4), Y(8, 3);
+        for (auto& v : X) v = dist(rng);
+        Y.fill(0.0);
+        for (std::size_t i = 0; i < 8; ++i) Y(i, i % 3) = 1.0;
+
+        std::vector<utec::algebra::Tensor<double,2>> acts(layers.size() + 1);
+        auto forward = [&] {
+            acts[0] = X;
+            for (std::size_t i = 0; i < layers.size(); ++i) layers[i]->forward_into(acts[i], acts[i + 1]);
+            return SoftmaxCrossEntropyLoss<double>(acts.back(), Y).loss();
+        };
+
+        forward();
+        utec::algebra::Tensor<double,2> g[2];
+        SoftmaxCrossEntropyLoss<double>(acts.back(), Y).loss_gradient_into(g[0]);
+        std::size_t cur = 0;
+        for (std::size_t i = layers.size(); i-- > 0; cur ^= 1) layers[i]->backward_into(g[cur], g[cur ^ 1]);
+        const utec::algebra::Tensor<double,2> dX = g[cur];
+
+        const double h = 1e-6;
+        auto numeric = [&](double& x) {
+            const double old = x;
+            x = old + h;
+            const double lp = forward();
+            x = old - h;
+            const double lm = forward();
+            x = old;
+            return (lp - lm) / (2 * h);
+        };
+        auto close = [](double a, double b) { return std::abs(a - b) <= 1e-6 + 1e-5 * std::abs(b); };
+
+        std::vector<Parameter<double>*> params;
+        for (auto& layer : layers) layer->parameters(params);
+        CHECK(params.size() == 6);
+        for (auto* p : params) {
+            auto v = p->value();
+            auto gr = static_cast<const Parameter<double>*>(p)->grad();
+            for (std::size_t r = 0; r < v.shape()[0]; ++r)
+                for (std::size_t c = 0; c < v.shape()[1]; ++c)
+                    CHECK(close(gr(r, c), numeric(v(r, c))));
+        }
+        for (std::size_t i = 0; i < X.size(); ++i) CHECK(close(dX.data()[i], numeric(X.data()[i])));
+    }
+
+    struct Case {
+        const char*           name;
+        std::function<void()> run;
+    };
+
+    const std::vector<Case>& cases() {
+        static const std::vector<Case> all = {
+            {"gemm_matches_reference",           gemm_matches_reference},
+            {"parallel_matrix_product",          parallel_matrix_product},
+            {"thread_pool_exceptions",           thread_pool_exceptions},
+            {"minibatch_training",               minibatch_training},
+            {"tensor_views",                     tensor_views},
+            {"elementwise_broadcast",            elementwise_broadcast},
+            {"expression_templates",             expression_templates},
+            {"workspace_reuse",                  workspace_reuse},
+            {"fused_dense_matches_unfused",      fused_dense_matches_unfused},
+            {"concurrent_inference",             concurrent_inference},
+            {"batching_engine",                  batching_engine},
+            {"flat_optimizer_step",              flat_optimizer_step},
+            {"activation_kernels",               activation_kernels},
+            {"fused_losses",                     fused_losses},
+            {"quantized_inference",              quantized_inference},
+            {"save_load_round_trip",             save_load_round_trip},
+            {"streaming_dataset",                streaming_dataset},
+            {"data_parallel_matches_serial",     data_parallel_matches_serial},
+            {"layer_profiler",                   layer_profiler},
+            {"static_matches_dynamic",           static_matches_dynamic},
+            {"sparse_matches_dense",             sparse_matches_dense},
+            {"checkpointing_matches_normal",     checkpointing_matches_normal},
+            {"compiled_matches_uncompiled",      compiled_matches_uncompiled},
+            {"pipeline_matches_serial",          pipeline_matches_serial},
+            {"axis_reductions",                  axis_reductions},
+            {"gradient_check",                   gradient_check},
+        };
+        return all;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::string only = argc > 1 ? argv[1] : "";
+    int failed = 0, ran = 0;
+    for (const auto& c : cases()) {
+        if (!only.empty() && only != c.name) continue;
+        ++ran;
+        try {
+            c.run();
+            std::printf("[ OK   ] %s\n", c.name);
+        } catch (const std::exception& e) {
+            ++failed;
+            std::printf("[ FAIL ] %s: %s\n", c.name, e.what());
+        }
+    }
+    if (ran == 0) {
+        std::fprintf(stderr, "Unknown test case: %s\n", only.c_str());
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
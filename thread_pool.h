@@ -0,0 +1,231 @@
+//
+// Created by Usuario on 17/10/2026.
+//
+
+#ifndef EPIC1_OFICIAL_THREAD_POOL_H
+#define EPIC1_OFICIAL_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utec::algebra {
+
+    // Pool de hilos persistente para los kernels paralelos (GEMM, etc.).
+    // parallel_for reparte n tareas entre los workers y el hilo llamador;
+    // las llamadas anidadas o concurrentes se ejecutan en el hilo que llama.
+    // Si una tarea lanza, las pendientes se descartan, se espera a las que
+    // están en curso y la primera excepción se relanza en el llamador.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t num_threads = default_threads()) {
+            start(num_threads);
+        }
+        ~ThreadPool() { stop(); }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Mientras vive, los parallel_for de la hebra actual corren en ella
+        // misma: para hebras dedicadas (etapas de un pipeline) que ya ocupan
+        // un núcleo cada una y no deben competir por los workers. Restaura el
+        // estado anterior aunque una tarea lance
+        class SerialScope {
+        public:
+            SerialScope() : prev_(in_worker()) { in_worker() = true; }
+            ~SerialScope() { in_worker() = prev_; }
+            SerialScope(const SerialScope&) = delete;
+            SerialScope& operator=(const SerialScope&) = delete;
+        private:
+            bool prev_;
+        };
+
+        // Hilos totales que participan (workers + llamador)
+        std::size_t size() const noexcept { return workers_.size() + 1; }
+
+        void resize(std::size_t num_threads) {
+            std::lock_guard<std::mutex> busy(run_mutex_);
+            stop();
+            start(num_threads);
+        }
+
+        template <typename F>
+        void parallel_for(std::size_t n_tasks, F&& fn) {
+            if (n_tasks == 0) return;
+            if (n_tasks == 1 || workers_.empty() || in_worker()) {
+                for (std::size_t i = 0; i < n_tasks; ++i) fn(i);
+                return;
+            }
+            std::unique_lock<std::mutex> busy(run_mutex_, std::try_to_lock);
+            if (!busy.owns_lock()) {
+                for (std::size_t i = 0; i < n_tasks; ++i) fn(i);
+                return;
+            }
+            std::function<void(std::size_t)> task(std::ref(fn));
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                task_      = &task;
+                n_tasks_   = n_tasks;
+                next_.store(0, std::memory_order_relaxed);
+                pending_   = workers_.size();
+                ++generation_;
+            }
+            cv_work_.notify_all();
+            {
+                SerialScope serial;
+                run_tasks();
+            }
+            std::unique_lock<std::mutex> lk(mutex_);
+            cv_done_.wait(lk, [this] { return pending_ == 0; });
+            task_ = nullptr;
+            if (std::exception_ptr error = std::exchange(error_, nullptr)) {
+                lk.unlock();
+                std::rethrow_exception(error);
+            }
+        }
+
+        static std::size_t default_threads() {
+            if (const char* env = std::getenv("UTEC_NUM_THREADS")) {
+                long n = std::strtol(env, nullptr, 10);
+                if (n > 0) return static_cast<std::size_t>(n);
+            }
+            std::size_t hw = std::thread::hardware_concurrency();
+            return hw ? hw : 1;
+        }
+
+    private:
+        std::vector<std::thread>          workers_;
+        std::mutex                        mutex_, run_mutex_;
+        std::condition_variable           cv_work_, cv_done_;
+        std::function<void(std::size_t)>* task_ = nullptr;
+        std::exception_ptr                error_;     // primera excepción de la ronda
+        std::size_t                       n_tasks_ = 0, pending_ = 0, generation_ = 0;
+        std::atomic<std::size_t>          next_{0};
+        bool                              stopping_ = false;
+
+        static bool& in_worker() {
+            thread_local bool flag = false;
+            return flag;
+        }
+
+        // No lanza: guarda la primera excepción y agota el contador para
+        // que nadie tome más tareas
+        void run_tasks() noexcept {
+            try {
+                for (std::size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < n_tasks_;)
+                    (*task_)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(mutex_);
+                if (!error_) error_ = std::current_exception();
+                next_.store(n_tasks_, std::memory_order_relaxed);
+            }
+        }
+
+        void worker_loop(std::size_t seen) {
+            in_worker() = true;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lk(mutex_);
+                    cv_work_.wait(lk, [&] { return stopping_ || generation_ != seen; });
+                    if (stopping_) return;
+                    seen = generation_;
+                }
+                run_tasks();
+                {
+                    std::lock_guard<std::mutex> lk(mutex_);
+                    if (--pending_ == 0) cv_done_.notify_one();
+                }
+            }
+        }
+
+        void start(std::size_t num_threads) {
+            stopping_ = false;
+            for (std::size_t i = 1; i < num_threads; ++i)
+                workers_.emplace_back([this, gen = generation_] { worker_loop(gen); });
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lk(mutex_);
+                stopping_ = true;
+            }
+            cv_work_.notify_all();
+            for (auto& w : workers_) w.join();
+            workers_.clear();
+        }
+    };
+
+    // Cola acotada sin bloqueos para exactamente un productor y un
+    // consumidor. try_push / try_pop no esperan: devuelven false si la cola
+    // está llena / vacía. La capacidad se redondea a potencia de dos.
+    template<typename V>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(std::size_t capacity = 64) {
+            std::size_t n = 1;
+            while (n < capacity) n *= 2;
+            buf_.resize(n);
+            mask_ = n - 1;
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        bool try_push(const V& v) noexcept {
+            const std::size_t t = tail_.load(std::memory_order_relaxed);
+            if (t - head_.load(std::memory_order_acquire) == buf_.size()) return false;
+            buf_[t & mask_] = v;
+            tail_.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(V& v) noexcept {
+            const std::size_t h = head_.load(std::memory_order_relaxed);
+            if (h == tail_.load(std::memory_order_acquire)) return false;
+            v = buf_[h & mask_];
+            head_.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t capacity() const noexcept { return buf_.size(); }
+
+    private:
+        std::vector<V>                       buf_;
+        std::size_t                          mask_ = 0;
+        alignas(64) std::atomic<std::size_t> head_{0};   // lo avanza el consumidor
+        alignas(64) std::atomic<std::size_t> tail_{0};   // lo avanza el productor
+    };
+
+    // Pool compartido por todos los kernels
+    inline ThreadPool& default_thread_pool() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Reparte [0, n) en bloques de `grain` elementos: fn(begin, end)
+    template <typename F>
+    void parallel_for_blocks(std::size_t n, std::size_t grain, F&& fn) {
+        const std::size_t blocks = grain ? (n + grain - 1) / grain : 1;
+        if (blocks <= 1) {
+            fn(std::size_t(0), n);
+            return;
+        }
+        default_thread_pool().parallel_for(blocks, [&](std::size_t b) {
+            const std::size_t begin = b * grain;
+            fn(begin, begin + grain < n ? begin + grain : n);
+        });
+    }
+
+    inline void set_num_threads(std::size_t n) { default_thread_pool().resize(n ? n : 1); }
+    inline std::size_t num_threads() { return default_thread_pool().size(); }
+
+}
+
+#endif //EPIC1_OFICIAL_THREAD_POOL_H